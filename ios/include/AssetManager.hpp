@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <mutex>
 
 #include <filament/Scene.h>
@@ -9,7 +10,10 @@
 #include <gltfio/ResourceLoader.h>
 
 #include "SceneAsset.hpp"
+#include "SlotMap.hpp"
 #include "ResourceBuffer.hpp"
+#include "ThreadPool.hpp"
+#include "RenderReason.hpp"
 
 typedef int32_t EntityId;
 
@@ -27,7 +31,27 @@ namespace polyvox {
             ~AssetManager();
             EntityId loadGltf(const char* uri, const char* relativeResourcePath);
             EntityId loadGlb(const char* uri, bool unlit);
+            int loadGlbInstanced(const char* uri, int numInstances, EntityId* out);
+            EntityId createInstance(EntityId entityId);
+            void setAssetCacheBudget(size_t budgetInBytes);
+            void getAssetCacheStats(AssetCacheStats* out);
+
+            ///
+            /// Asynchronous variants of loadGlb/loadGltf.
+            /// These return immediately with the EntityId the asset will be assigned once it is ready
+            /// (pass [entityId] to use an ID previously obtained from reserveEntityId).
+            /// If the load fails or is cancelled, the entity behind the ID is destroyed before the callback is invoked.
+            /// File I/O happens on a worker thread and resources are uploaded incrementally by updateAsyncLoads;
+            /// the asset is only added to the scene once fully loaded.
+            ///
+            EntityId loadGlbAsync(const char* uri, AssetLoadCallback callback, EntityId entityId = 0);
+            EntityId loadGltfAsync(const char* uri, const char* relativeResourcePath, AssetLoadCallback callback, EntityId entityId = 0);
+            bool getLoadProgress(EntityId entityId, AssetLoadProgress* out);
+            bool cancelLoad(EntityId entityId);
+            void updateAsyncLoads();
+            static EntityId reserveEntityId();
             FilamentAsset* getAssetByEntityId(EntityId entityId);
+            FilamentInstance* getInstanceByEntityId(EntityId entityId);
             void remove(EntityId entity);
             void destroyAll();
             unique_ptr<vector<string>> getAnimationNames(EntityId entity);
@@ -38,12 +62,26 @@ namespace polyvox {
             void setScale(EntityId e, float scale);
             void setPosition(EntityId e, float x, float y, float z);
             void setRotation(EntityId e, float rads, float x, float y, float z);
+            void setTransform(EntityId e, const math::mat4f& transform);
+            int setTransforms(const EntityId* entities, const float* positions, const float* rotations, const float* scales, int count);
+            int setTransforms(const EntityId* entities, const float* matrices, int count);
             const utils::Entity *getCameraEntities(EntityId e);
             size_t getCameraEntityCount(EntityId e);
             const utils::Entity* getLightEntities(EntityId e) const noexcept;
             size_t getLightEntityCount(EntityId e) const noexcept;
-            void updateAnimations();
+            bool updateAnimations();
+            void setAnimationThreadCount(int count);
+            void setAnimationBakeRate(float samplesPerSecond);
+            void getAnimationStats(AnimationStats* out);
+            void markDirty(uint32_t reasons) {
+                _dirtyReasons |= reasons;
+                _raycastDirtyReasons |= reasons;
+            }
+            uint32_t consumeDirtyReasons() {
+                return _dirtyReasons.exchange(RENDER_REASON_NONE);
+            }
             bool setMaterialColor(EntityId e, const char* meshName, int materialInstance, const float r, const float g, const float b, const float a);
+            bool setMaterialColor(EntityId e, uint32_t meshNameId, int materialInstance, const float r, const float g, const float b, const float a);
 
             bool setMorphAnimationBuffer(
                 EntityId entityId,
@@ -55,6 +93,7 @@ namespace polyvox {
                 float frameLengthInMs);
                 
             void setMorphTargetWeights(EntityId entityId, const char* const entityName, const float* const weights, int count);
+            void setMorphTargetWeights(EntityId entityId, uint32_t entityNameId, const float* const weights, int count);
 
             bool setBoneAnimationBuffer(
                 EntityId entity,
@@ -65,14 +104,53 @@ namespace polyvox {
                 const char** const meshName,
                 int numMeshTargets,
                 float frameLengthInMs);
+            bool setBoneAnimationBuffer(
+                EntityId entity,
+                CompressedBoneClip&& frames,
+                const char** const boneNames,
+                const char** const meshName,
+                int numMeshTargets,
+                float frameLengthInMs);
+
+            ///
+            /// Bone mixer (see BoneMixer). Clips are added once and then played as layers; returns the new clip/layer index, or -1.
+            ///
+            int addBoneAnimationClip(EntityId entity, const float* const frameData, int numFrames, int numBones, const char** const boneNames, float frameLengthInMs);
+            int addBoneAnimationClip(EntityId entity, CompressedBoneClip&& frames, const char** const boneNames, float frameLengthInMs);
+            CompressedBoneClip compressBoneAnimation(const float* const frameData, int numFrames, int numBones, bool withTranslations);
+            int addBoneAnimationLayer(EntityId entity, int clipIndex, float weight, bool additive, bool loop);
+            bool setBoneAnimationLayerWeight(EntityId entity, int layerIndex, float weight);
+            bool setBoneAnimationLayerMask(EntityId entity, int layerIndex, const char** const boneNames, const float* const weights, int count);
+            bool removeBoneAnimationLayer(EntityId entity, int layerIndex);
+            void clearBoneAnimationLayers(EntityId entity);
+            void setBoneAnimationTolerance(float rotationTolerance, float translationTolerance);
+            bool getBoneAnimationStats(EntityId entity, BoneAnimationStats* out);
+
             void playAnimation(EntityId e, int index, bool loop, bool reverse, bool replaceActive, float crossfade = 0.3f);
             void stopAnimation(EntityId e, int index);
             void setMorphTargetWeights(const char* const entityName, float *weights, int count);
             void loadTexture(EntityId entity, const char* resourcePath, int renderableIndex);
             void setAnimationFrame(EntityId entity, int animationIndex, int animationFrame);
             bool hide(EntityId entity, const char* meshName);
+            bool hide(EntityId entity, uint32_t meshNameId);
             bool reveal(EntityId entity, const char* meshName);
+            bool reveal(EntityId entity, uint32_t meshNameId);
+
+            ///
+            /// Entity, joint and morph target names are interned when an asset is loaded, so clients can look up a name's ID once
+            /// and use the ID-based overloads thereafter to avoid hashing (and marshalling) strings on every call.
+            ///
+            uint32_t getNameId(const char* name) const;
+            const char* getNameForId(uint32_t nameId) const;
+            int getMorphTargetIndex(EntityId entity, uint32_t entityNameId, uint32_t morphTargetNameId);
             const char* getNameForEntity(EntityId entityId);
+            bool describe(EntityId entityId, vector<uint8_t>& out);
+
+            ///
+            /// Finds the closest triangle hit by a world-space ray, without waiting on the GPU.
+            /// Must be called on the render thread.
+            ///
+            bool raycast(const math::float3& origin, const math::float3& direction, RaycastHit* out);
             
         private:
             AssetLoader* _assetLoader = nullptr;
@@ -85,18 +163,90 @@ namespace polyvox {
             gltfio::TextureProvider* _stbDecoder = nullptr;
             gltfio::TextureProvider* _ktxDecoder = nullptr;
             std::mutex _animationMutex;
+            std::atomic<uint32_t> _dirtyReasons { RENDER_REASON_NONE };
         
-            vector<SceneAsset> _assets;
-            tsl::robin_map<EntityId, int> _entityIdLookup;
+            SlotMap<SceneAsset> _assets;
+            tsl::robin_map<EntityId, SlotHandle> _entityIdLookup;
+            SceneAsset* getSceneAsset(EntityId entityId);
+            const SceneAsset* getSceneAsset(EntityId entityId) const;
+
+            // assets loaded with loadGlbInstanced (or via the asset cache), which are shared between several SceneAssets
+            struct InstancedAsset {
+                int liveInstances = 0;
+                // instances that have been removed from the scene, since gltfio can't destroy individual instances
+                vector<FilamentInstance*> recycled;
+                // set if this asset is a template in the asset cache
+                bool cached = false;
+                uint64_t contentHash = 0;
+                size_t sizeInBytes = 0;
+                uint64_t lastUsed = 0;
+            };
+            tsl::robin_map<const FilamentAsset*, InstancedAsset> _instancedAssets;
+            EntityId addInstance(FilamentAsset* asset, FilamentInstance* instance);
+            EntityId instantiate(FilamentAsset* asset, InstancedAsset& state);
+
+            // asset template cache (see loadGlb)
+            tsl::robin_map<string, FilamentAsset*> _assetCacheByUri;
+            tsl::robin_map<uint64_t, FilamentAsset*> _assetCacheByHash;
+            size_t _assetCacheBudget = 0;
+            size_t _assetCacheSize = 0;
+            uint64_t _assetCacheClock = 0;
+            AssetCacheStats _assetCacheStats = {};
+            EntityId loadCachedGlb(const char* uri);
+            void evictAssetCache();
+
+            // bumped whenever an asset (and so its renderables) is destroyed, invalidating cached RenderableManager instances
+            uint32_t _renderableGeneration = 0;
+            void destroyAsset(const FilamentAsset* asset);
+
+            struct AsyncLoad;
+            vector<unique_ptr<AsyncLoad>> _asyncLoads;
+            flutter_filament::ThreadPool* _loaderPool = nullptr;
+            vector<std::future<ResourceBuffer>> fetchResources(const vector<string>& paths);
+            EntityId beginAsyncLoad(unique_ptr<AsyncLoad> load);
+            bool updateAsyncLoad(AsyncLoad& load);
+            bool finishAsyncLoad(AsyncLoad& load, AssetLoadState state);
  
             utils::Entity findEntityByName(
-                SceneAsset asset, 
+                const SceneAsset& asset, 
                 const char* entityName
             );
+            utils::Entity findEntityByName(const SceneAsset& asset, uint32_t entityNameId);
+
+            NameTable _nameTable;
+            uint32_t internName(const char* name);
+            shared_ptr<const NameIndex> buildNameIndex(const SceneAsset& asset);
+            void addSceneAsset(EntityId entityId, SceneAsset& sceneAsset);
             
+            // ray casting (see raycast)
+            SceneBvh _sceneBvh;
+            // reasons the BVH is out of date: the scene changing triggers a rebuild, anything moving a refit
+            std::atomic<uint32_t> _raycastDirtyReasons { RENDER_REASON_SCENE };
+            tsl::robin_map<const FilamentAsset*, weak_ptr<const AssetGeometry>> _geometryCache;
+            shared_ptr<const AssetGeometry> buildGeometry(const SceneAsset& asset);
+            void updateSceneBvh();
+
             inline void updateTransform(SceneAsset& asset);
+            math::mat4f composeTransform(const SceneAsset& asset);
 
-            inline void setBoneTransform(SceneAsset& asset, int frameNumber);
+            // animation (see updateAnimations)
+            flutter_filament::ThreadPool* _animationPool = nullptr;
+            // -1 until the pool is first needed (see setAnimationThreadCount)
+            int _animationThreadCount = -1;
+            vector<SceneAsset*> _animatingAssets;
+            float _animationBakeRate = 0;
+            // per template asset (and so shared by its instances); entries may be null if nothing could be baked
+            tsl::robin_map<const FilamentAsset*, shared_ptr<const BakedAnimations>> _bakedAnimationCache;
+            shared_ptr<const BakedAnimations> bakeAnimations(const SceneAsset& asset);
+            void sampleAnimations(SceneAsset& asset, time_point_t now);
+            bool commitAnimations(SceneAsset& asset, time_point_t now);
+            bool commitBoneTransforms(SceneAsset& asset, const math::mat4f* transforms);
+            bool commitBoneMixer(SceneAsset& asset, bool underlyingAnimated);
+            // the error allowed when compressing dynamic bone animations (see CompressedBoneClip); radians, and scene units
+            float _boneRotationTolerance = 0;
+            float _boneTranslationTolerance = 0;
+            void resetBoneMixer(SceneAsset& asset);
+            AnimationStats _animationStats = {};
 
 
 
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <math/mat4.h>
+#include <math/quat.h>
+#include <math/vec3.h>
+#include <utils/Entity.h>
+
+#include "CompressedBoneClip.hpp"
+
+namespace polyvox {
+    using namespace filament;
+    using namespace std;
+
+    typedef std::chrono::time_point<std::chrono::high_resolution_clock> time_point_t;
+
+    //
+    // A dynamic bone animation clip for the bone mixer (see AssetManager::addBoneAnimationClip).
+    // Frames are uploaded as 7 floats per bone (locX, locY, locZ, rotW, rotX, rotY, rotZ), relative to the bone's rest transform,
+    // and stored compressed.
+    //
+    struct BoneClip {
+        // the index of each bone in BoneMixer::mJoints
+        vector<uint32_t> mJoints;
+        float mFrameLengthInMs = 0;
+        float mDuration = 0;
+        CompressedBoneClip mFrames;
+    };
+
+    //
+    // A bone mixer layer, playing one clip.
+    // Layers are applied in index order on top of the underlying pose (the rest pose, plus whatever glTF animations set this frame).
+    // Normal layers blend from the pose so far towards the clip's pose by their weight; additive layers apply the clip's pose,
+    // scaled by their weight, on top of the pose so far.
+    //
+    struct BoneLayer {
+        // -1 if this layer has been removed (its index is reused by the next layer added)
+        int mClip = -1;
+        float mWeight = 1.0f;
+        bool mAdditive = false;
+        bool mLoop = true;
+        // set once a non-looping layer has played through; it keeps contributing its last frame, but no longer needs sampling
+        // every frame
+        bool mFinished = false;
+        time_point_t mStart;
+        // scales mWeight per joint in BoneMixer::mJoints; empty if every joint is fully affected
+        vector<float> mMask;
+    };
+
+    //
+    // Plays any number of BoneClips concurrently as weighted layers, committing the blended pose once per frame.
+    // Unlike BoneAnimationBuffer, clips can drive any named node (not just joints of the first skin) and include translations.
+    //
+    struct BoneMixer {
+        // every node driven by any clip, with its local transform when first added to the mixer
+        vector<utils::Entity> mJoints;
+        vector<math::mat4f> mRestTransforms;
+        vector<math::mat4f> mInverseRestTransforms;
+        vector<BoneClip> mClips;
+        vector<BoneLayer> mLayers;
+        // the blended pose, relative to the rest transforms (kept between frames to avoid reallocating)
+        vector<math::float3> mTranslations;
+        vector<math::quatf> mRotations;
+        // set while the joints are posed by the mixer, so they can be returned to rest once every layer has been removed
+        bool mPosed = false;
+        // set when layers are added, changed or removed, so the pose is recommitted even if none are playing
+        bool mDirty = false;
+
+        bool hasLayers() const {
+            for(const auto& layer : mLayers) {
+                if(layer.mClip >= 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // true if any layer's pose changes over time
+        bool isPlaying() const {
+            for(const auto& layer : mLayers) {
+                if(layer.mClip >= 0 && !layer.mFinished) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // applies every layer in index order on top of the pose in mTranslations/mRotations (which the caller sets to the
+        // underlying pose, relative to the rest transforms); layerOffsets[i] is where layer i's sampled clip pose starts in
+        // layerTranslations/layerRotations, or UINT32_MAX (or missing) if the layer wasn't sampled
+        void blendLayers(const vector<uint32_t>& layerOffsets, const vector<math::float3>& layerTranslations,
+                         const vector<math::quatf>& layerRotations) {
+            for(size_t index = 0; index < mLayers.size(); index++) {
+                const auto& layer = mLayers[index];
+                uint32_t offset = index < layerOffsets.size() ? layerOffsets[index] : UINT32_MAX;
+                if(offset == UINT32_MAX) {
+                    continue;
+                }
+                const auto& clip = mClips[layer.mClip];
+                for(size_t i = 0; i < clip.mJoints.size(); i++) {
+                    uint32_t joint = clip.mJoints[i];
+                    float weight = layer.mMask.empty() ? layer.mWeight : layer.mWeight * layer.mMask[joint];
+                    if(weight <= 0.0f) {
+                        continue;
+                    }
+                    const auto& translation = layerTranslations[offset + i];
+                    const auto& rotation = layerRotations[offset + i];
+                    if(layer.mAdditive) {
+                        mTranslations[joint] += translation * weight;
+                        mRotations[joint] = normalize(mRotations[joint] * shortestNlerp(math::quatf(1.0f), rotation, weight));
+                    } else {
+                        weight = std::min(weight, 1.0f);
+                        mTranslations[joint] += (translation - mTranslations[joint]) * weight;
+                        mRotations[joint] = shortestNlerp(mRotations[joint], rotation, weight);
+                    }
+                }
+            }
+        }
+    };
+}
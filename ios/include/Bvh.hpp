@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <math/mat4.h>
+#include <math/vec3.h>
+
+#include <utils/Entity.h>
+
+namespace polyvox {
+    using namespace filament;
+
+    //
+    // A ray with a precomputed reciprocal direction (for the slab test).
+    // The direction doesn't need to be normalized; hit distances are always expressed in multiples of it.
+    //
+    struct Ray {
+        math::float3 origin;
+        math::float3 direction;
+        math::float3 inverseDirection;
+
+        Ray(math::float3 origin, math::float3 direction) : origin(origin), direction(direction), inverseDirection(1.0f / direction) {}
+    };
+
+    //
+    // A 32-byte BVH node. Leaves have count > 0 and reference [first, first + count) in the BVH's primitive order;
+    // interior nodes have count == 0 and children at [first] and [first + 1].
+    // Children are always stored after their parent, so iterating the nodes in reverse visits children before parents.
+    //
+    struct BvhNode {
+        math::float3 min;
+        uint32_t first;
+        math::float3 max;
+        uint32_t count;
+    };
+
+    //
+    // Builds a BVH over a set of primitive bounds using the binned surface area heuristic.
+    // [order] receives the permutation of primitive indices referenced by the leaves.
+    //
+    void buildBvh(const math::float3* mins, const math::float3* maxs, size_t count, uint32_t maxLeafSize,
+                  std::vector<BvhNode>& nodes, std::vector<uint32_t>& order);
+
+    //
+    // Triangle BVH over a single mesh (every triangle primitive of a glTF mesh), in the mesh's local space.
+    // Immutable once built, so it can be shared between every instance of an asset.
+    //
+    class MeshBvh {
+        public:
+            struct Hit {
+                float distance;
+                float u;
+                float v;
+                uint32_t primitive;
+                uint32_t triangle;
+            };
+
+            ///
+            /// Builds the BVH from [positions] (three vertices per triangle).
+            /// [primitives] and [triangles] give the glTF primitive index and the index of the triangle within that primitive
+            /// for each triangle, and are reported back in hits.
+            ///
+            void build(const std::vector<math::float3>& positions, const std::vector<uint32_t>& primitives, const std::vector<uint32_t>& triangles);
+
+            ///
+            /// Finds the closest triangle hit by [ray] nearer than [hit].distance, updating [hit] if found.
+            ///
+            bool intersect(const Ray& ray, Hit& hit) const;
+
+            math::float3 getMin() const { return _nodes.empty() ? math::float3(0) : _nodes[0].min; }
+            math::float3 getMax() const { return _nodes.empty() ? math::float3(0) : _nodes[0].max; }
+            size_t getTriangleCount() const { return _triangles.size(); }
+            bool empty() const { return _triangles.empty(); }
+
+        private:
+            // stored pre-permuted into leaf order, as a vertex and two edges (for Moller-Trumbore)
+            struct Triangle {
+                math::float3 v0;
+                math::float3 e1;
+                math::float3 e2;
+                uint32_t primitive;
+                uint32_t triangle;
+            };
+            std::vector<BvhNode> _nodes;
+            std::vector<Triangle> _triangles;
+    };
+
+    //
+    // Top-level BVH over the world-space bounds of every mesh instance in the scene.
+    // Rebuilt when instances are added or removed, and refit (bounds recomputed bottom-up without changing the topology)
+    // when they move. Each instance refers to a MeshBvh that must outlive it.
+    //
+    class SceneBvh {
+        public:
+            struct Instance {
+                int32_t asset;
+                utils::Entity entity;
+                const MeshBvh* mesh;
+                math::mat4f worldToLocal;
+                math::float3 min;
+                math::float3 max;
+            };
+
+            struct Hit {
+                const Instance* instance = nullptr;
+                MeshBvh::Hit mesh;
+            };
+
+            void build(std::vector<Instance> instances);
+
+            ///
+            /// Recomputes the bounds of every instance from [getWorldTransform] (a callable taking an entity and returning its
+            /// world transform) and refits the tree.
+            ///
+            template <typename F>
+            void refit(F&& getWorldTransform) {
+                for(auto& instance : _instances) {
+                    setWorldTransform(instance, getWorldTransform(instance.entity));
+                }
+                refitNodes();
+            }
+
+            static void setWorldTransform(Instance& instance, const math::mat4f& localToWorld);
+
+            ///
+            /// Finds the closest triangle hit by [ray] (in world space) within [maxDistance].
+            ///
+            bool intersect(const Ray& ray, float maxDistance, Hit& hit) const;
+
+            size_t size() const { return _instances.size(); }
+
+        private:
+            void refitNodes();
+            std::vector<BvhNode> _nodes;
+            // stored in leaf order
+            std::vector<Instance> _instances;
+    };
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace polyvox {
+
+  class FilamentViewer;
+
+  //
+  // Decodes a packed binary command stream (see the COMMAND_* opcodes in FlutterFilamentFFIApi.h) and applies each command to a viewer.
+  // This allows a client to batch an entire frame's worth of updates into a single FFI call/render thread handoff.
+  //
+  // All values are little-endian and unaligned. The stream is laid out as:
+  //
+  //   header  : uint32 magic (COMMAND_BUFFER_MAGIC), uint16 version (COMMAND_BUFFER_VERSION), uint16 reserved, uint32 commandCount
+  //   command : uint16 opcode, uint16 payloadLength (in bytes), uint8 payload[payloadLength]
+  //
+  // Because every command carries its own length, unknown opcodes (e.g. from a newer client) are skipped rather than aborting the stream.
+  //
+  class CommandBuffer {
+    public:
+      static constexpr size_t kHeaderSize = 12;
+
+      ///
+      /// Returns true if [data] starts with a valid header for a version this decoder understands.
+      ///
+      static bool validate(const uint8_t* const data, size_t length);
+
+      ///
+      /// Applies every command in the stream to [viewer] (must be called on the render thread).
+      /// Returns the number of commands that were successfully applied.
+      ///
+      static int apply(FilamentViewer* const viewer, const uint8_t* const data, size_t length);
+  };
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <math/quat.h>
+#include <math/vec3.h>
+
+namespace polyvox {
+    using namespace filament;
+
+    ///
+    /// Normalized linear interpolation between quaternions, taking the shorter path (negating b where the pair are in opposite
+    /// hemispheres). For keyframes this close together nlerp is indistinguishable from slerp, and avoids the trigonometry.
+    ///
+    inline math::quatf shortestNlerp(const math::quatf& a, const math::quatf& b, float t) {
+        math::quatf q = a * (1.0f - t) + b * (dot(a, b) < 0.0f ? -t : t);
+        float lengthSquared = dot(q, q);
+        return lengthSquared > 0.0f ? q * (1.0f / std::sqrt(lengthSquared)) : a;
+    }
+
+    //
+    // Bone animation frame data (7 floats per bone per frame: locX, locY, locZ, rotW, rotX, rotY, rotZ), stored as one
+    // translation track and one rotation track per bone:
+    // - tracks that never move by more than the tolerance are stored as a single key
+    // - otherwise, only the keyframes needed to reproduce every frame within the tolerance (by interpolating between the
+    //   neighbouring keys) are kept
+    // - rotations are quantized to 48 bits ("smallest three": the largest component is dropped and rebuilt from the others),
+    //   translations to 16 bits per component within the track's range
+    // Keyframe reduction accounts for the quantization error, but constant tracks are only checked against the tolerance, so
+    // the final error can exceed it by the quantization step (see getStats for the actual maximum).
+    //
+    class CompressedBoneClip {
+        public:
+            struct Stats {
+                size_t uncompressedBytes = 0;
+                size_t compressedBytes = 0;
+                // measured against the source data over every frame; radians, and the units of the translations
+                float maxRotationError = 0;
+                float maxTranslationError = 0;
+            };
+
+            ///
+            /// Compresses [numFrames] frames of [numBones] bones. A tolerance of 0 keeps every keyframe (so only quantizes).
+            ///
+            void compress(const float* frameData, int numFrames, int numBones, float rotationTolerance, float translationTolerance);
+
+            ///
+            /// As compress, but discards the translations (which sample then returns as zero), for callers that only use rotations.
+            ///
+            void compressRotations(const float* frameData, int numFrames, int numBones, float rotationTolerance);
+
+            ///
+            /// Evaluates every bone [t] of the way from frame [from] to frame [to].
+            /// [translations] may be null if only the rotations are needed.
+            ///
+            void sample(int from, int to, float t, math::float3* translations, math::quatf* rotations) const;
+
+            int getNumFrames() const { return _numFrames; }
+            int getNumBones() const { return _numBones; }
+            const Stats& getStats() const { return _stats; }
+
+        private:
+            void compressTracks(const float* frameData, int numFrames, int numBones, float rotationTolerance, float translationTolerance,
+                                bool withTranslations);
+
+            struct Track {
+                uint32_t firstKey = 0;
+                // 1 for a constant track
+                uint32_t keyCount = 0;
+                // translation tracks only: the range the keys are quantized to
+                math::float3 min;
+                math::float3 extent;
+            };
+
+            math::quatf rotationAt(const Track& track, int frame) const;
+            math::float3 translationAt(const Track& track, int frame) const;
+
+            int _numFrames = 0;
+            int _numBones = 0;
+            std::vector<Track> _rotationTracks;
+            std::vector<Track> _translationTracks;
+            // the frame of each key, ascending within each track
+            std::vector<uint32_t> _rotationKeyFrames;
+            std::vector<uint32_t> _translationKeyFrames;
+            // three quantized values per key
+            std::vector<uint16_t> _rotationKeys;
+            std::vector<uint16_t> _translationKeys;
+            Stats _stats;
+    };
+}
@@ -27,12 +27,15 @@
 #include <math/mat3.h>
 #include <math/norm.h>
 
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <string>
 #include <chrono>
 
 #include "AssetManager.hpp"
+#include "FrameTiming.hpp"
+#include "RenderReason.hpp"
 
 using namespace std;
 using namespace filament;
@@ -70,12 +73,33 @@ namespace polyvox
         void clearAssets();
 
         void updateViewportAndCameraProjection(int height, int width, float scaleFactor);
-        void render(
+        bool render(
             uint64_t frameTimeInNanos,
             void *pixelBuffer,
             void (*callback)(void *buf, size_t size, void *data),
             void *data);
         void setFrameInterval(float interval);
+        void setRefreshRate(float refreshRate);
+
+        void setOnDemandRendering(bool enabled, float idleFrameRate);
+        void markDirty(uint32_t reasons)
+        {
+            _dirtyReasons |= reasons;
+        }
+        uint32_t getLastRenderReasons()
+        {
+            return _lastRenderReasons;
+        }
+
+        // the time spent running queued tasks before the next frame, included in that frame's timing record
+        void setTaskDrainTime(float milliseconds)
+        {
+            _pendingTaskDrainInMilliseconds = milliseconds;
+        }
+        size_t getFrameTimings(FrameTimingRecord *out, size_t maxRecords) const
+        {
+            return _frameTimings.snapshot(out, maxRecords);
+        }
 
         bool setCamera(EntityId asset, const char *nodeName);
 
@@ -115,6 +139,23 @@ namespace polyvox
         void scrollUpdate(float x, float y, float delta);
         void scrollEnd();
         void pick(uint32_t x, uint32_t y, EntityId *entityId);
+        void pick(uint32_t x, uint32_t y, void (*callback)(EntityId entityId, int x, int y));
+        bool raycast(float x, float y, RaycastHit* out);
+
+        ///
+        /// Batched GPU picking. Requests are submitted with the next rendered frame and their results delivered together
+        /// to the callback set with setPickResultsCallback once resolved (usually a frame or two later).
+        /// Request IDs can be reserved from any thread, so callers can hand them out before the request reaches the render thread.
+        ///
+        void setPickResultsCallback(PickResultsCallback callback)
+        {
+            _pickResultsCallback = callback;
+        }
+        uint32_t reservePickRequestIds(int count)
+        {
+            return _nextPickRequestId.fetch_add(count);
+        }
+        void queuePicks(const int32_t *points, int count, uint32_t channel, uint32_t firstRequestId);
         
         EntityId addLight(LightManager::Type t, float colour, float intensity, float posX, float posY, float posZ, float dirX, float dirY, float dirZ, bool shadows);
         void removeLight(EntityId entityId);
@@ -155,11 +196,46 @@ namespace polyvox
 
         bool _recomputeAabb = false;
 
+        // on-demand rendering
+        std::atomic<uint32_t> _dirtyReasons { RENDER_REASON_SCENE };
+        std::atomic<uint32_t> _lastRenderReasons { RENDER_REASON_NONE };
+        bool _onDemandRendering = false;
+        float _idleFrameRate = 0.0f;
+        std::chrono::steady_clock::time_point _lastRenderTime;
+        math::double3 _lastEye;
+        math::double3 _lastTarget;
+        math::double3 _lastUpward;
+
+        // batched GPU picking (see queuePicks)
+        struct PickRequest
+        {
+            uint32_t requestId;
+            uint32_t channel;
+            int32_t x;
+            int32_t y;
+        };
+        vector<PickRequest> _pendingPicks;
+        vector<PickResult> _pickResults;
+        uint32_t _picksInFlight = 0;
+        // frames since picks were last submitted
+        uint32_t _pickFramesWaiting = 0;
+        // bumped whenever in-flight picks are abandoned (see abandonPicks)
+        uint32_t _pickGeneration = 0;
+        std::atomic<uint32_t> _nextPickRequestId { 1 };
+        PickResultsCallback _pickResultsCallback = nullptr;
+        void submitPicks();
+        void deliverPickResults();
+        void abandonPicks();
+
+        FrameTimingHistory<> _frameTimings;
+        float _pendingTaskDrainInMilliseconds = 0.0f;
+
         bool _actualSize = false;
 
         // Camera properties
         Camera *_mainCamera = nullptr; // the default camera added to every scene. If you want the *active* camera, access via View. 
         float _cameraFocalLength = 28.0f;
+        float _refreshRate = 60.0f;
         float _cameraFocusDistance = 0.0f;
         Manipulator<double> *_manipulator = nullptr;
         filament::camutils::Mode _manipulatorMode = filament::camutils::Mode::ORBIT;
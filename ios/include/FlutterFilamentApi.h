@@ -45,10 +45,128 @@
 #endif
 
 #include "ResourceBuffer.hpp"
+#include "RenderReason.hpp"
+#include "FrameTiming.hpp"
 
 typedef int32_t EntityId;
 typedef int32_t _ManipulatorMode;
 
+//
+// Asynchronous asset loading (see load_glb_async/load_gltf_async).
+//
+enum AssetLoadState {
+    ASSET_LOAD_FETCHING = 0,           // fetching the glTF/GLB file on a worker thread
+    ASSET_LOAD_PARSING = 1,            // parsing and creating entities on the render thread
+    ASSET_LOAD_FETCHING_RESOURCES = 2, // fetching external buffers/images on a worker thread (glTF only)
+    ASSET_LOAD_UPLOADING = 3,          // decoding textures and uploading buffers across frames
+    ASSET_LOAD_READY = 4,              // loaded and added to the scene
+    ASSET_LOAD_FAILED = 5,
+    ASSET_LOAD_CANCELLED = 6
+};
+
+struct AssetLoadProgress {
+    int32_t state;                     // see AssetLoadState
+    float progress;                    // upload progress in [0,1] (as reported by gltfio's ResourceLoader)
+    uint64_t bytesFetched;
+    int32_t resourceCount;             // number of external resources (glTF only)
+    int32_t texturesDecoded;
+    int32_t textureCount;
+};
+typedef struct AssetLoadProgress AssetLoadProgress;
+
+//
+// Counters for the asset template cache used by load_glb (disabled until set_asset_cache_budget is called with a non-zero budget).
+//
+struct AssetCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t bytesCached;              // source bytes of every cached template (including those with live instances)
+    uint64_t budgetInBytes;
+    int32_t templateCount;
+    int32_t idleTemplateCount;         // cached templates with no live instances (i.e. eligible for eviction)
+};
+typedef struct AssetCacheStats AssetCacheStats;
+
+//
+// Cumulative counters for the animation update (see get_animation_stats).
+//
+struct AnimationStats {
+    uint64_t boneMatrixUpdates;        // calls to Animator::updateBoneMatrices made by the animation update
+    uint64_t boneMatrixUpdatesSkipped; // calls avoided because no joint had moved, or because the asset had already been updated that frame
+};
+typedef struct AnimationStats AnimationStats;
+
+//
+// Memory used by an asset's dynamic bone animations, which are stored compressed (see set_bone_animation_tolerance).
+//
+struct BoneAnimationStats {
+    uint64_t uncompressedBytes;  // as uploaded (7 floats per bone per frame)
+    uint64_t compressedBytes;
+    float maxRotationError;      // radians
+    float maxTranslationError;
+    int32_t clipCount;
+};
+typedef struct BoneAnimationStats BoneAnimationStats;
+
+//
+// Layout of the buffer written by describe_asset. All values are little-endian and unaligned;
+// strings are a uint16 byte length followed by that many UTF-8 bytes (not NUL-terminated).
+//
+//   header    : uint32 magic (ASSET_DESCRIPTION_MAGIC), uint16 version (ASSET_DESCRIPTION_VERSION), uint16 reserved,
+//               uint32 nodeCount, uint32 animationCount, uint32 skinCount
+//   node      : string name, int32 parentIndex (-1 if the parent isn't a node of this asset), uint8 flags (ASSET_NODE_*),
+//               uint16 morphTargetCount, string morphTargetNames[morphTargetCount]
+//   animation : string name, float durationInSeconds
+//   skin      : string name, uint32 jointCount, int32 jointNodeIndices[jointCount]
+//
+// Nodes are listed in entity order, followed by every animation, then every skin.
+//
+#define ASSET_DESCRIPTION_MAGIC 0x44414646 // "FFAD"
+#define ASSET_DESCRIPTION_VERSION 1
+
+enum AssetNodeFlags {
+    ASSET_NODE_RENDERABLE = 1 << 0,
+    ASSET_NODE_LIGHT = 1 << 1,
+    ASSET_NODE_CAMERA = 1 << 2
+};
+
+//
+// Result of a CPU ray cast (see raycast/raycast_screen).
+// Rays are tested against each mesh's bind pose, so skinned and morphed meshes are hit where they are at rest.
+//
+struct RaycastHit {
+    EntityId asset;                    // the asset that was hit (0 if nothing was hit)
+    EntityId entity;                   // the renderable entity that was hit
+    int32_t primitive;                 // index of the glTF primitive within the entity's mesh
+    int32_t triangle;                  // index of the triangle within the primitive
+    float u;                           // barycentric coordinates of the hit, relative to the triangle's second and third vertices
+    float v;
+    float distance;                    // world-space distance from the ray origin
+    float position[3];                 // world-space hit point
+};
+typedef struct RaycastHit RaycastHit;
+
+//
+// Result of a GPU pick queued with queue_pick/queue_picks.
+//
+struct PickResult {
+    uint32_t requestId;                // as returned by queue_pick/queue_picks
+    uint32_t channel;
+    EntityId entity;                   // the renderable at the requested point (0 if there is none)
+    float depth;                       // depth buffer value at the requested point (1 at the near plane, 0 at infinity)
+    float fragCoords[3];               // the picked fragment in viewport coordinates (x, y) and depth (z), in GL convention
+    int32_t x;                         // the requested point
+    int32_t y;
+};
+typedef struct PickResult PickResult;
+
+// invoked on the render thread after each frame with every pick result that resolved during that frame
+typedef void (*PickResultsCallback)(const PickResult* results, int32_t count);
+
+// invoked on the render thread when an asynchronous load finishes (success is false if the load failed or was cancelled)
+typedef void (*AssetLoadCallback)(EntityId entityId, bool success);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -72,10 +190,18 @@ FLUTTER_PLUGIN_EXPORT EntityId add_light(const void* const viewer, uint8_t type,
 FLUTTER_PLUGIN_EXPORT void remove_light(const void* const viewer, EntityId entityId);
 FLUTTER_PLUGIN_EXPORT void clear_lights(const void* const viewer);
 FLUTTER_PLUGIN_EXPORT EntityId load_glb(void *assetManager, const char *assetPath, bool unlit);
+FLUTTER_PLUGIN_EXPORT int load_glb_instanced(void *assetManager, const char *assetPath, int numInstances, EntityId *out);
+FLUTTER_PLUGIN_EXPORT EntityId create_instance(void *assetManager, EntityId entityId);
+FLUTTER_PLUGIN_EXPORT void set_asset_cache_budget(void *assetManager, uint64_t budgetInBytes);
+FLUTTER_PLUGIN_EXPORT void get_asset_cache_stats(void *assetManager, AssetCacheStats *out);
 FLUTTER_PLUGIN_EXPORT EntityId load_gltf(void *assetManager, const char *assetPath, const char *relativePath);
+FLUTTER_PLUGIN_EXPORT EntityId load_glb_async(void *assetManager, const char *assetPath, AssetLoadCallback callback);
+FLUTTER_PLUGIN_EXPORT EntityId load_gltf_async(void *assetManager, const char *assetPath, const char *relativePath, AssetLoadCallback callback);
+FLUTTER_PLUGIN_EXPORT bool get_load_progress(void *assetManager, EntityId asset, AssetLoadProgress* out);
+FLUTTER_PLUGIN_EXPORT bool cancel_load(void *assetManager, EntityId asset);
 FLUTTER_PLUGIN_EXPORT bool set_camera(const void* const viewer, EntityId asset, const char *nodeName);
 FLUTTER_PLUGIN_EXPORT void set_view_frustum_culling(const void* const viewer, bool enabled);
-FLUTTER_PLUGIN_EXPORT void render(
+FLUTTER_PLUGIN_EXPORT bool render(
 					     const void* const viewer, 
 					     uint64_t frameTimeInNanos, 
 					     void* pixelBuffer, 
@@ -85,6 +211,13 @@ FLUTTER_PLUGIN_EXPORT void render(
 FLUTTER_PLUGIN_EXPORT void create_swap_chain(const void* const viewer, const void* const window, uint32_t width, uint32_t height);
 FLUTTER_PLUGIN_EXPORT void destroy_swap_chain(const void* const viewer);
 FLUTTER_PLUGIN_EXPORT void set_frame_interval(const void* const viewer, float interval);
+FLUTTER_PLUGIN_EXPORT void set_refresh_rate(const void* const viewer, float refreshRate);
+FLUTTER_PLUGIN_EXPORT void set_on_demand_rendering(const void* const viewer, bool enabled, float idleFrameRate);
+FLUTTER_PLUGIN_EXPORT void request_frame(const void* const viewer);
+FLUTTER_PLUGIN_EXPORT uint32_t get_last_render_reasons(const void* const viewer);
+FLUTTER_PLUGIN_EXPORT bool start_tracing(const char* outputPath, int maxEvents);
+FLUTTER_PLUGIN_EXPORT bool stop_tracing();
+FLUTTER_PLUGIN_EXPORT int get_frame_timings(const void* const viewer, FrameTimingRecord* out, int maxRecords);
 FLUTTER_PLUGIN_EXPORT void update_viewport_and_camera_projection(const void* const viewer, uint32_t width, uint32_t height, float scaleFactor);
 FLUTTER_PLUGIN_EXPORT void scroll_begin(const void* const viewer);
 FLUTTER_PLUGIN_EXPORT void scroll_update(const void* const viewer, float x, float y, float z);
@@ -106,6 +239,15 @@ FLUTTER_PLUGIN_EXPORT void set_morph_target_weights(
 					     const float *const morphData,
 					     int numWeights
 					 );
+FLUTTER_PLUGIN_EXPORT void set_morph_target_weights_by_id(
+					     void* assetManager,
+					     EntityId asset,
+					     uint32_t entityNameId,
+					     const float *const morphData,
+					     int numWeights
+					 );
+FLUTTER_PLUGIN_EXPORT uint32_t get_name_id(void* assetManager, const char* name);
+FLUTTER_PLUGIN_EXPORT int get_morph_target_index(void* assetManager, EntityId asset, uint32_t entityNameId, uint32_t morphTargetNameId);
 FLUTTER_PLUGIN_EXPORT bool set_morph_animation(
 					     void* assetManager,
 					     EntityId asset,
@@ -125,19 +267,50 @@ FLUTTER_PLUGIN_EXPORT void set_bone_animation(
                             const char** const meshName,
                             int numMeshTargets,
                             float frameLengthInMs);
+// bone mixer: clips/layers are identified by the index returned when they're added (-1 on error)
+FLUTTER_PLUGIN_EXPORT int add_bone_animation_clip(
+                            void* assetManager,
+                            EntityId asset,
+                            const float* const frameData,
+                            int numFrames,
+                            int numBones,
+                            const char** const boneNames,
+                            float frameLengthInMs);
+FLUTTER_PLUGIN_EXPORT int add_bone_animation_layer(void* assetManager, EntityId asset, int clipIndex, float weight, bool additive, bool loop);
+FLUTTER_PLUGIN_EXPORT bool set_bone_animation_layer_weight(void* assetManager, EntityId asset, int layerIndex, float weight);
+FLUTTER_PLUGIN_EXPORT bool set_bone_animation_layer_mask(void* assetManager, EntityId asset, int layerIndex, const char** const boneNames, const float* const weights, int count);
+FLUTTER_PLUGIN_EXPORT bool remove_bone_animation_layer(void* assetManager, EntityId asset, int layerIndex);
+FLUTTER_PLUGIN_EXPORT void clear_bone_animation_layers(void* assetManager, EntityId asset);
+// the error allowed when compressing bone animations uploaded after this call (radians/scene units). 0, the default, keeps every
+// keyframe so the only loss is quantization. The _ffi variants of set_bone_animation/add_bone_animation_clip compress on the
+// calling thread.
+FLUTTER_PLUGIN_EXPORT void set_bone_animation_tolerance(void* assetManager, float rotationTolerance, float translationTolerance);
+FLUTTER_PLUGIN_EXPORT bool get_bone_animation_stats(void* assetManager, EntityId asset, BoneAnimationStats* out);
 FLUTTER_PLUGIN_EXPORT void play_animation(void* assetManager, EntityId asset, int index, bool loop, bool reverse, bool replaceActive, float crossfade);
 FLUTTER_PLUGIN_EXPORT void set_animation_frame(void* assetManager, EntityId asset, int animationIndex, int animationFrame);
 FLUTTER_PLUGIN_EXPORT void stop_animation(void* assetManager, EntityId asset, int index);
+// worker threads for sampling animations (0 for none). By default (or with a negative count) they're only started once enough
+// assets are animating at the same time to be worth it.
+FLUTTER_PLUGIN_EXPORT void set_animation_thread_count(void* assetManager, int count);
+// pre-sample the glTF animations of assets loaded after this call at [samplesPerSecond] (0 to disable)
+FLUTTER_PLUGIN_EXPORT void set_animation_bake_rate(void* assetManager, float samplesPerSecond);
+FLUTTER_PLUGIN_EXPORT void get_animation_stats(void* assetManager, AnimationStats* out);
 FLUTTER_PLUGIN_EXPORT int get_animation_count(void* assetManager, EntityId asset);
 FLUTTER_PLUGIN_EXPORT void get_animation_name(void* assetManager, EntityId asset, char *const outPtr, int index);
 FLUTTER_PLUGIN_EXPORT float get_animation_duration(void* assetManager, EntityId asset, int index);
 FLUTTER_PLUGIN_EXPORT void get_morph_target_name(void* assetManager, EntityId asset, const char *meshName, char *const outPtr, int index);
 FLUTTER_PLUGIN_EXPORT int get_morph_target_name_count(void* assetManager, EntityId asset, const char *meshName);
+FLUTTER_PLUGIN_EXPORT int describe_asset(void* assetManager, EntityId asset, uint8_t* out, int capacity);
+FLUTTER_PLUGIN_EXPORT uint8_t* describe_asset_alloc(void* assetManager, EntityId asset, int* outLength);
+FLUTTER_PLUGIN_EXPORT void free_asset_description(uint8_t* description);
 FLUTTER_PLUGIN_EXPORT void remove_asset(const void* const viewer, EntityId asset);
 FLUTTER_PLUGIN_EXPORT void clear_assets(const void* const viewer);
 FLUTTER_PLUGIN_EXPORT bool set_material_color(void* assetManager, EntityId asset, const char* meshName, int materialIndex, const float r, const float g, const float b, const float a);
+FLUTTER_PLUGIN_EXPORT bool set_material_color_by_id(void* assetManager, EntityId asset, uint32_t meshNameId, int materialIndex, const float r, const float g, const float b, const float a);
 FLUTTER_PLUGIN_EXPORT void transform_to_unit_cube(void* assetManager, EntityId asset);
 FLUTTER_PLUGIN_EXPORT void set_position(void* assetManager, EntityId asset, float x, float y, float z);
+FLUTTER_PLUGIN_EXPORT int set_transforms(void* assetManager, const EntityId* assets, const float* positions, const float* rotations, const float* scales, int count);
+FLUTTER_PLUGIN_EXPORT int set_transform_matrices(void* assetManager, const EntityId* assets, const float* matrices, int count);
 FLUTTER_PLUGIN_EXPORT void set_rotation(void* assetManager, EntityId asset, float rads, float x, float y, float z);
 FLUTTER_PLUGIN_EXPORT void set_scale(void* assetManager, EntityId asset, float scale);
 
@@ -162,8 +335,17 @@ FLUTTER_PLUGIN_EXPORT void set_camera_manipulator_options(const void* const view
 
 FLUTTER_PLUGIN_EXPORT int hide_mesh(void* assetManager, EntityId asset, const char* meshName);
 FLUTTER_PLUGIN_EXPORT int reveal_mesh(void* assetManager, EntityId asset, const char* meshName);
+FLUTTER_PLUGIN_EXPORT int hide_mesh_by_id(void* assetManager, EntityId asset, uint32_t meshNameId);
+FLUTTER_PLUGIN_EXPORT int reveal_mesh_by_id(void* assetManager, EntityId asset, uint32_t meshNameId);
 FLUTTER_PLUGIN_EXPORT void set_post_processing(void* const viewer, bool enabled);
 FLUTTER_PLUGIN_EXPORT void pick(void* const viewer, int x, int y, EntityId* entityId);
+FLUTTER_PLUGIN_EXPORT void set_pick_results_callback(void* const viewer, PickResultsCallback callback);
+FLUTTER_PLUGIN_EXPORT uint32_t queue_pick(void* const viewer, int x, int y, uint32_t channel);
+FLUTTER_PLUGIN_EXPORT uint32_t queue_picks(void* const viewer, const int32_t* points, int count, uint32_t channel);
+FLUTTER_PLUGIN_EXPORT bool raycast(void* const viewer, float originX, float originY, float originZ, float directionX, float directionY, float directionZ, RaycastHit* out);
+FLUTTER_PLUGIN_EXPORT int raycast_batch(void* const viewer, const float* rays, int count, RaycastHit* out);
+FLUTTER_PLUGIN_EXPORT bool raycast_screen(void* const viewer, float x, float y, RaycastHit* out);
+FLUTTER_PLUGIN_EXPORT int raycast_screen_batch(void* const viewer, const float* points, int count, RaycastHit* out);
 FLUTTER_PLUGIN_EXPORT const char* get_name_for_entity(void* const assetManager, const EntityId entityId);
 FLUTTER_PLUGIN_EXPORT void ios_dummy();
 FLUTTER_PLUGIN_EXPORT void flutter_filament_free(void* ptr);
@@ -11,9 +11,51 @@ extern "C" {
 /// This header replicates most of the methods in FlutterFilamentApi.h, and is only intended to be used to generate client FFI bindings.
 /// The intention is that calling one of these methods will call its respective method in FlutterFilamentApi.h, but wrapped in some kind of thread runner to ensure thread safety. 
 /// 
+/// Methods that don't return a value (and don't read from caller-owned buffers) are non-blocking: the call is enqueued on the render thread and returns immediately.
+/// Calls are executed in the order they are made, so a subsequent blocking call will always observe the effects of any prior non-blocking call.
+/// Methods suffixed with _with_callback_ffi are non-blocking alternatives to methods that return a value; the result is passed to the callback on the render thread.
+/// Every callback passed to this header (the _with_callback_ffi variants, AssetLoadCallback and PickResultsCallback) is invoked on the render thread.
+/// A Dart function pointer created with Pointer.fromFunction can't be called from another thread, so Dart callers must pass
+/// NativeCallable.listener(...).nativeFunction (Dart 3.1+), closing it once the last result has arrived (see FilamentControllerFFI.loadGlb).
+///
 
 typedef int32_t EntityId;
 typedef void (*FilamentRenderCallback)(void* const owner);
+typedef void (*EntityIdCallback)(EntityId entityId);
+typedef void (*PickCallback)(EntityId entityId, int x, int y);
+
+///
+/// Counters from the render loop's frame pacer (see get_frame_pacing_stats_ffi).
+///
+struct FramePacingStats {
+    uint64_t frameCount;
+    uint64_t missedDeadlines;
+    uint64_t skippedVsyncs;
+    float lastFrameCostInMilliseconds;
+    float predictedFrameCostInMilliseconds;
+    float averageJitterInMilliseconds;
+    float maxJitterInMilliseconds;
+};
+typedef struct FramePacingStats FramePacingStats;
+
+///
+/// Opcodes for the packed command stream accepted by submit_commands_ffi (see CommandBuffer.hpp for the stream layout).
+/// Payload layouts are listed alongside each opcode; all values are little-endian and unaligned.
+///
+#define COMMAND_BUFFER_MAGIC 0x42434646 // "FFCB"
+#define COMMAND_BUFFER_VERSION 1
+
+enum CommandOpcode {
+    COMMAND_SET_POSITION = 1,            // int32 asset, float x, float y, float z
+    COMMAND_SET_ROTATION = 2,            // int32 asset, float rads, float x, float y, float z
+    COMMAND_SET_SCALE = 3,               // int32 asset, float scale
+    COMMAND_SET_TRANSFORM = 4,           // int32 asset, float[16] column-major
+    COMMAND_SET_MORPH_WEIGHTS = 5,       // int32 asset, uint16 nameLength, uint16 numWeights, char[nameLength] meshName, float[numWeights] weights
+    COMMAND_PLAY_ANIMATION = 6,          // int32 asset, int32 index, uint8 loop, uint8 reverse, uint8 replaceActive, uint8 reserved, float crossfade
+    COMMAND_STOP_ANIMATION = 7,          // int32 asset, int32 index
+    COMMAND_SET_ANIMATION_FRAME = 8,     // int32 asset, int32 index, int32 frame
+    COMMAND_SET_CAMERA_MODEL_MATRIX = 9  // float[16] column-major
+};
 
 FLUTTER_PLUGIN_EXPORT void* const create_filament_viewer_ffi(void* const context, void* const platform, const char* uberArchivePath, const ResourceLoaderWrapper* const loader, void (*renderCallback)(void* const renderCallbackOwner), void* const renderCallbackOwner);
 FLUTTER_PLUGIN_EXPORT void create_swap_chain_ffi(void* const viewer, void* const surface, uint32_t width, uint32_t height);
@@ -24,6 +66,12 @@ FLUTTER_PLUGIN_EXPORT void render_ffi(void* const viewer);
 FLUTTER_PLUGIN_EXPORT FilamentRenderCallback make_render_callback_fn_pointer(FilamentRenderCallback);
 FLUTTER_PLUGIN_EXPORT void set_rendering_ffi(void* const viewer, bool rendering);
 FLUTTER_PLUGIN_EXPORT void set_frame_interval_ffi(float frameInterval);
+FLUTTER_PLUGIN_EXPORT void set_task_budget_ffi(float taskBudgetInMilliseconds);
+FLUTTER_PLUGIN_EXPORT void set_refresh_rate_ffi(void* const viewer, float refreshRate);
+FLUTTER_PLUGIN_EXPORT void set_on_demand_rendering_ffi(void* const viewer, bool enabled, float idleFrameRate);
+FLUTTER_PLUGIN_EXPORT void request_frame_ffi(void* const viewer);
+FLUTTER_PLUGIN_EXPORT void get_frame_pacing_stats_ffi(FramePacingStats* out, bool reset);
+FLUTTER_PLUGIN_EXPORT int get_frame_timings_ffi(void* const viewer, FrameTimingRecord* out, int maxRecords);
 FLUTTER_PLUGIN_EXPORT void update_viewport_and_camera_projection_ffi(void* const viewer, const uint32_t width, const uint32_t height, const float scaleFactor);
 FLUTTER_PLUGIN_EXPORT void set_background_color_ffi(void* const viewer, const float r, const float g, const float b, const float a);
 FLUTTER_PLUGIN_EXPORT void clear_background_image_ffi(void* const viewer);
@@ -36,10 +84,21 @@ FLUTTER_PLUGIN_EXPORT void load_ibl_ffi(void* const viewer, const char *iblPath,
 FLUTTER_PLUGIN_EXPORT void remove_skybox_ffi(void* const viewer);
 FLUTTER_PLUGIN_EXPORT void remove_ibl_ffi(void* const viewer);
 FLUTTER_PLUGIN_EXPORT EntityId add_light_ffi(void* const viewer, uint8_t type, float colour, float intensity, float posX, float posY, float posZ, float dirX, float dirY, float dirZ, bool shadows);
+FLUTTER_PLUGIN_EXPORT void add_light_with_callback_ffi(void* const viewer, uint8_t type, float colour, float intensity, float posX, float posY, float posZ, float dirX, float dirY, float dirZ, bool shadows, EntityIdCallback callback);
 FLUTTER_PLUGIN_EXPORT void remove_light_ffi(void* const viewer, EntityId entityId);
 FLUTTER_PLUGIN_EXPORT void clear_lights_ffi(void* const viewer);
 FLUTTER_PLUGIN_EXPORT EntityId load_glb_ffi(void* const assetManager, const char *assetPath, bool unlit);
+FLUTTER_PLUGIN_EXPORT int load_glb_instanced_ffi(void* const assetManager, const char *assetPath, int numInstances, EntityId* out);
+FLUTTER_PLUGIN_EXPORT EntityId create_instance_ffi(void* const assetManager, EntityId entityId);
+FLUTTER_PLUGIN_EXPORT void set_asset_cache_budget_ffi(void* const assetManager, uint64_t budgetInBytes);
+FLUTTER_PLUGIN_EXPORT void get_asset_cache_stats_ffi(void* const assetManager, AssetCacheStats* out);
 FLUTTER_PLUGIN_EXPORT EntityId load_gltf_ffi(void* const assetManager, const char *assetPath, const char *relativePath);
+FLUTTER_PLUGIN_EXPORT void load_glb_with_callback_ffi(void* const assetManager, const char *assetPath, bool unlit, EntityIdCallback callback);
+FLUTTER_PLUGIN_EXPORT void load_gltf_with_callback_ffi(void* const assetManager, const char *assetPath, const char *relativePath, EntityIdCallback callback);
+FLUTTER_PLUGIN_EXPORT EntityId load_glb_async_ffi(void* const assetManager, const char *assetPath, AssetLoadCallback callback);
+FLUTTER_PLUGIN_EXPORT EntityId load_gltf_async_ffi(void* const assetManager, const char *assetPath, const char *relativePath, AssetLoadCallback callback);
+FLUTTER_PLUGIN_EXPORT bool get_load_progress_ffi(void* const assetManager, EntityId asset, AssetLoadProgress* out);
+FLUTTER_PLUGIN_EXPORT void cancel_load_ffi(void* const assetManager, EntityId asset);
 FLUTTER_PLUGIN_EXPORT void remove_asset_ffi(void* const viewer, EntityId asset);
 FLUTTER_PLUGIN_EXPORT void clear_assets_ffi(void* const viewer);
 FLUTTER_PLUGIN_EXPORT bool set_camera_ffi(void* const viewer, EntityId asset, const char *nodeName);
@@ -57,6 +116,12 @@ FLUTTER_PLUGIN_EXPORT void set_morph_target_weights_ffi(
                                                         const float *const morphData,
                                                         int numWeights
                                                         );
+FLUTTER_PLUGIN_EXPORT void set_morph_target_weights_by_id_ffi(void* const assetManager, EntityId asset, uint32_t entityNameId, const float *const morphData, int numWeights);
+FLUTTER_PLUGIN_EXPORT uint32_t get_name_id_ffi(void* const assetManager, const char* name);
+FLUTTER_PLUGIN_EXPORT int get_morph_target_index_ffi(void* const assetManager, EntityId asset, uint32_t entityNameId, uint32_t morphTargetNameId);
+FLUTTER_PLUGIN_EXPORT void hide_mesh_by_id_ffi(void* const assetManager, EntityId asset, uint32_t meshNameId);
+FLUTTER_PLUGIN_EXPORT void reveal_mesh_by_id_ffi(void* const assetManager, EntityId asset, uint32_t meshNameId);
+FLUTTER_PLUGIN_EXPORT void set_material_color_by_id_ffi(void* const assetManager, EntityId asset, uint32_t meshNameId, int materialIndex, float r, float g, float b, float a);
 FLUTTER_PLUGIN_EXPORT bool set_morph_animation_ffi(
                                                    void* const assetManager,
                                                    EntityId asset,
@@ -77,15 +142,62 @@ FLUTTER_PLUGIN_EXPORT void set_bone_animation_ffi(
                                                   const char** const meshName,
                                                   int numMeshTargets,
                                                   float frameLengthInMs);
+FLUTTER_PLUGIN_EXPORT int add_bone_animation_clip_ffi(
+                                                  void* const assetManager,
+                                                  EntityId asset,
+                                                  const float* const frameData,
+                                                  int numFrames,
+                                                  int numBones,
+                                                  const char** const boneNames,
+                                                  float frameLengthInMs);
+FLUTTER_PLUGIN_EXPORT int add_bone_animation_layer_ffi(void* const assetManager, EntityId asset, int clipIndex, float weight, bool additive, bool loop);
+FLUTTER_PLUGIN_EXPORT void set_bone_animation_layer_weight_ffi(void* const assetManager, EntityId asset, int layerIndex, float weight);
+FLUTTER_PLUGIN_EXPORT bool set_bone_animation_layer_mask_ffi(void* const assetManager, EntityId asset, int layerIndex, const char** const boneNames, const float* const weights, int count);
+FLUTTER_PLUGIN_EXPORT void remove_bone_animation_layer_ffi(void* const assetManager, EntityId asset, int layerIndex);
+FLUTTER_PLUGIN_EXPORT void clear_bone_animation_layers_ffi(void* const assetManager, EntityId asset);
+FLUTTER_PLUGIN_EXPORT void set_bone_animation_tolerance_ffi(void* const assetManager, float rotationTolerance, float translationTolerance);
+FLUTTER_PLUGIN_EXPORT bool get_bone_animation_stats_ffi(void* const assetManager, EntityId asset, BoneAnimationStats* out);
 FLUTTER_PLUGIN_EXPORT void play_animation_ffi(void* const assetManager, EntityId asset, int index, bool loop, bool reverse, bool replaceActive, float crossfade);
 FLUTTER_PLUGIN_EXPORT void set_animation_frame_ffi(void* const assetManager, EntityId asset, int animationIndex, int animationFrame);
 FLUTTER_PLUGIN_EXPORT void stop_animation_ffi(void* const assetManager, EntityId asset, int index);
+FLUTTER_PLUGIN_EXPORT void set_animation_thread_count_ffi(void* const assetManager, int count);
+FLUTTER_PLUGIN_EXPORT void set_animation_bake_rate_ffi(void* const assetManager, float samplesPerSecond);
+FLUTTER_PLUGIN_EXPORT void get_animation_stats_ffi(void* const assetManager, AnimationStats* out);
 FLUTTER_PLUGIN_EXPORT int get_animation_count_ffi(void* const assetManager, EntityId asset);
 FLUTTER_PLUGIN_EXPORT void get_animation_name_ffi(void* const assetManager, EntityId asset, char *const outPtr, int index);
 FLUTTER_PLUGIN_EXPORT void get_morph_target_name_ffi(void* const assetManager, EntityId asset, const char *meshName, char *const outPtr, int index);
+FLUTTER_PLUGIN_EXPORT int describe_asset_ffi(void* const assetManager, EntityId asset, uint8_t* out, int capacity);
+FLUTTER_PLUGIN_EXPORT uint8_t* describe_asset_alloc_ffi(void* const assetManager, EntityId asset, int* outLength);
 FLUTTER_PLUGIN_EXPORT int get_morph_target_name_count_ffi(void* const assetManager, EntityId asset, const char *meshName);
 FLUTTER_PLUGIN_EXPORT void set_post_processing_ffi(void* const viewer, bool enabled);
 FLUTTER_PLUGIN_EXPORT void pick_ffi(void* const viewer, int x, int y, EntityId* entityId);
+// unlike set_pick_results_callback, [callback] is passed a copy of the results, which it must release with flutter_filament_free
+FLUTTER_PLUGIN_EXPORT void set_pick_results_callback_ffi(void* const viewer, PickResultsCallback callback);
+FLUTTER_PLUGIN_EXPORT uint32_t queue_pick_ffi(void* const viewer, int x, int y, uint32_t channel);
+FLUTTER_PLUGIN_EXPORT uint32_t queue_picks_ffi(void* const viewer, const int32_t* points, int count, uint32_t channel);
+FLUTTER_PLUGIN_EXPORT bool raycast_ffi(void* const viewer, float originX, float originY, float originZ, float directionX, float directionY, float directionZ, RaycastHit* out);
+FLUTTER_PLUGIN_EXPORT int raycast_batch_ffi(void* const viewer, const float* rays, int count, RaycastHit* out);
+FLUTTER_PLUGIN_EXPORT bool raycast_screen_ffi(void* const viewer, float x, float y, RaycastHit* out);
+FLUTTER_PLUGIN_EXPORT int raycast_screen_batch_ffi(void* const viewer, const float* points, int count, RaycastHit* out);
+FLUTTER_PLUGIN_EXPORT void pick_with_callback_ffi(void* const viewer, int x, int y, PickCallback callback);
+FLUTTER_PLUGIN_EXPORT void set_camera_position_ffi(void* const viewer, float x, float y, float z);
+FLUTTER_PLUGIN_EXPORT void set_camera_rotation_ffi(void* const viewer, float rads, float x, float y, float z);
+FLUTTER_PLUGIN_EXPORT void set_camera_model_matrix_ffi(void* const viewer, const float *const matrix);
+FLUTTER_PLUGIN_EXPORT void set_camera_focal_length_ffi(void* const viewer, float focalLength);
+FLUTTER_PLUGIN_EXPORT void set_camera_focus_distance_ffi(void* const viewer, float focusDistance);
+FLUTTER_PLUGIN_EXPORT void set_camera_exposure_ffi(void* const viewer, float aperture, float shutterSpeed, float sensitivity);
+FLUTTER_PLUGIN_EXPORT void grab_begin_ffi(void* const viewer, float x, float y, bool pan);
+FLUTTER_PLUGIN_EXPORT void grab_update_ffi(void* const viewer, float x, float y);
+FLUTTER_PLUGIN_EXPORT void grab_end_ffi(void* const viewer);
+FLUTTER_PLUGIN_EXPORT void scroll_begin_ffi(void* const viewer);
+FLUTTER_PLUGIN_EXPORT void scroll_update_ffi(void* const viewer, float x, float y, float delta);
+FLUTTER_PLUGIN_EXPORT void scroll_end_ffi(void* const viewer);
+FLUTTER_PLUGIN_EXPORT void set_position_ffi(void* const assetManager, EntityId asset, float x, float y, float z);
+FLUTTER_PLUGIN_EXPORT void set_transforms_ffi(void* const assetManager, const EntityId* assets, const float* positions, const float* rotations, const float* scales, int count);
+FLUTTER_PLUGIN_EXPORT void set_transform_matrices_ffi(void* const assetManager, const EntityId* assets, const float* matrices, int count);
+FLUTTER_PLUGIN_EXPORT void set_rotation_ffi(void* const assetManager, EntityId asset, float rads, float x, float y, float z);
+FLUTTER_PLUGIN_EXPORT void set_scale_ffi(void* const assetManager, EntityId asset, float scale);
+FLUTTER_PLUGIN_EXPORT bool submit_commands_ffi(void* const viewer, const uint8_t* const data, int32_t length);
 FLUTTER_PLUGIN_EXPORT void ios_dummy_ffi();
 
 #ifdef __cplusplus
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace polyvox {
+
+    struct FramePacerStats {
+        uint64_t frameCount = 0;
+        // frames whose CPU work finished after the vsync they were targeting
+        uint64_t missedDeadlines = 0;
+        // vsyncs that were dropped from the timeline because the previous frame ran long
+        uint64_t skippedVsyncs = 0;
+        float lastFrameCostInMilliseconds = 0;
+        float predictedFrameCostInMilliseconds = 0;
+        // difference between the time the render thread was scheduled to wake and the time it actually woke
+        float averageJitterInMilliseconds = 0;
+        float maxJitterInMilliseconds = 0;
+    };
+
+    //
+    // Schedules the render thread against a vsync timeline (a multiple of the display refresh period).
+    //
+    // Rather than sleeping a fixed interval after each frame (which adds the frame's own cost to the interval and produces a bimodal frame time),
+    // each frame targets the next vsync on the timeline, and the render thread is woken early enough to finish its CPU work before that vsync.
+    // The CPU cost of a frame is predicted from a smoothed mean and deviation of recent frames (in the style of a TCP RTT estimator).
+    //
+    // beginFrame/endFrame must only be called from the render thread; everything else is thread-safe.
+    //
+    class FramePacer {
+        public:
+            typedef std::chrono::steady_clock clock;
+
+            void setRefreshRate(float refreshRate);
+            void setFrameInterval(float frameIntervalInMilliseconds);
+
+            ///
+            /// Marks the start of a frame's CPU work.
+            /// Returns the steady clock time (in nanoseconds) of the vsync this frame is targeting, suitable for passing to Renderer::beginFrame.
+            ///
+            uint64_t beginFrame();
+
+            ///
+            /// Marks the end of a frame's CPU work and schedules the next frame.
+            /// Returns the time at which the render thread should wake to begin the next frame.
+            ///
+            clock::time_point endFrame();
+
+            FramePacerStats getStats();
+            void resetStats();
+
+        private:
+            clock::duration framePeriod() const;
+            clock::duration predictedCost() const;
+
+            std::atomic<float> _refreshRate { 60.0f };
+            std::atomic<float> _frameIntervalInMilliseconds { 1000.0f / 60.0f };
+
+            bool _started = false;
+            clock::time_point _target;
+            clock::time_point _scheduledWake;
+            clock::time_point _frameStart;
+            double _averageCostInNanos = 0;
+            double _costDeviationInNanos = 0;
+
+            std::mutex _statsMutex;
+            FramePacerStats _stats;
+    };
+}
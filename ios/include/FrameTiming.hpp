@@ -0,0 +1,96 @@
+#ifndef _FRAME_TIMING_HPP
+#define _FRAME_TIMING_HPP
+
+#include <stdint.h>
+
+#define FRAME_TIMING_HISTORY_SIZE 256
+
+//
+// CPU timings for a single frame (see get_frame_timings).
+// All durations are measured on the render thread with the steady clock.
+//
+struct FrameTimingRecord {
+    uint64_t frameNumber;
+    uint64_t startTimeInNanos;          // steady clock time at which the frame's CPU work started
+    uint64_t vsyncTimeInNanos;          // the vsync timestamp passed to Renderer::beginFrame
+    float taskDrainInMilliseconds;      // time spent running queued tasks before the frame (FFI render loop only)
+    float updateAnimationsInMilliseconds;
+    float manipulatorInMilliseconds;
+    float beginFrameInMilliseconds;
+    float renderInMilliseconds;
+    float endFrameInMilliseconds;
+    float totalInMilliseconds;
+    uint32_t renderReasons;             // see RenderReason
+    uint32_t skipped;                   // 1 if Renderer::beginFrame asked us to skip the frame
+};
+typedef struct FrameTimingRecord FrameTimingRecord;
+
+#ifdef __cplusplus
+
+// this header may be included from inside an extern "C" block (e.g. via FlutterFilamentApi.h)
+extern "C++" {
+
+#include <algorithm>
+#include <atomic>
+
+namespace polyvox {
+
+    //
+    // Fixed-size history of the most recent frame timings.
+    // There is a single writer (the render thread); any number of threads can take a snapshot at any time without blocking the writer.
+    // Each slot is guarded by a sequence counter (odd while being written), so a reader simply discards any slot that was overwritten mid-copy.
+    //
+    template <size_t Size = FRAME_TIMING_HISTORY_SIZE>
+    class FrameTimingHistory {
+        public:
+            void push(FrameTimingRecord record) {
+                uint64_t frameNumber = _count.load(std::memory_order_relaxed);
+                auto& slot = _slots[frameNumber % Size];
+                uint32_t seq = slot.sequence.load(std::memory_order_relaxed);
+                slot.sequence.store(seq + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                record.frameNumber = frameNumber;
+                slot.record = record;
+                slot.sequence.store(seq + 2, std::memory_order_release);
+                _count.store(frameNumber + 1, std::memory_order_release);
+            }
+
+            ///
+            /// Copies up to [maxRecords] of the most recent records into [out] (oldest first).
+            /// Returns the number of records copied.
+            ///
+            size_t snapshot(FrameTimingRecord* out, size_t maxRecords) const {
+                uint64_t count = _count.load(std::memory_order_acquire);
+                uint64_t n = std::min<uint64_t>(count, std::min<uint64_t>(Size, maxRecords));
+                size_t copied = 0;
+                for(uint64_t frameNumber = count - n; frameNumber < count; frameNumber++) {
+                    const auto& slot = _slots[frameNumber % Size];
+                    uint32_t before = slot.sequence.load(std::memory_order_acquire);
+                    if(before & 1) {
+                        continue;
+                    }
+                    FrameTimingRecord record = slot.record;
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if(slot.sequence.load(std::memory_order_relaxed) != before || record.frameNumber != frameNumber) {
+                        continue;
+                    }
+                    out[copied++] = record;
+                }
+                return copied;
+            }
+
+        private:
+            struct Slot {
+                std::atomic<uint32_t> sequence { 0 };
+                FrameTimingRecord record {};
+            };
+            Slot _slots[Size];
+            std::atomic<uint64_t> _count { 0 };
+    };
+}
+
+}
+
+#endif
+
+#endif
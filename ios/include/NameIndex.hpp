@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <utils/Entity.h>
+
+#include <tsl/robin_map.h>
+
+namespace polyvox {
+
+    //
+    // Interns entity, joint and morph target names as integer IDs, so per-asset lookups hash an integer rather than a string.
+    // IDs start at 1 (0 is never a valid ID) and are never reused.
+    //
+    class NameTable {
+        public:
+            ///
+            /// Returns the ID for [name], interning it if this is the first time it has been seen.
+            ///
+            uint32_t intern(const char* name) {
+                auto it = _ids.find(name);
+                if(it != _ids.end()) {
+                    return it->second;
+                }
+                _names.push_back(name);
+                uint32_t id = (uint32_t)_names.size();
+                _ids.emplace(name, id);
+                return id;
+            }
+
+            ///
+            /// Returns the ID for [name], or 0 if it has never been interned.
+            ///
+            uint32_t find(const char* name) const {
+                if(!name) {
+                    return 0;
+                }
+                auto it = _ids.find(name);
+                return it == _ids.end() ? 0 : it->second;
+            }
+
+            ///
+            /// Returns the name interned as [nameId], or nullptr if there is no such ID.
+            ///
+            const char* getName(uint32_t nameId) const {
+                if(nameId == 0 || nameId > _names.size()) {
+                    return nullptr;
+                }
+                return _names[nameId - 1].c_str();
+            }
+
+        private:
+            tsl::robin_map<std::string, uint32_t> _ids;
+            std::vector<std::string> _names;
+    };
+
+    //
+    // Per-instance lookup tables, keyed by interned name ID (see NameTable).
+    // Built once when the asset is added so name lookups don't need to scan (and strcmp) every entity.
+    // Where names are duplicated, the first entity/joint/morph target added with that name wins.
+    //
+    class NameIndex {
+        public:
+            void addEntity(uint32_t nameId, utils::Entity entity) {
+                _entities.emplace(nameId, entity);
+            }
+            // [joint] is the index of the joint within the first skin
+            void addJoint(uint32_t nameId, uint32_t joint) {
+                _joints.emplace(nameId, joint);
+            }
+            void addMorphTarget(uint32_t entityNameId, uint32_t morphTargetNameId, int index) {
+                _morphTargets.emplace(morphTargetKey(entityNameId, morphTargetNameId), index);
+            }
+
+            // returns a null entity if there is none with this name
+            utils::Entity findEntity(uint32_t nameId) const {
+                auto it = _entities.find(nameId);
+                return it == _entities.end() ? utils::Entity() : it->second;
+            }
+            // returns -1 if there is no joint with this name
+            int findJoint(uint32_t nameId) const {
+                auto it = _joints.find(nameId);
+                return it == _joints.end() ? -1 : (int)it->second;
+            }
+            // returns -1 if the entity named [entityNameId] has no morph target named [morphTargetNameId]
+            int findMorphTarget(uint32_t entityNameId, uint32_t morphTargetNameId) const {
+                auto it = _morphTargets.find(morphTargetKey(entityNameId, morphTargetNameId));
+                return it == _morphTargets.end() ? -1 : it->second;
+            }
+
+        private:
+            static uint64_t morphTargetKey(uint32_t entityNameId, uint32_t morphTargetNameId) {
+                return ((uint64_t)entityNameId << 32) | morphTargetNameId;
+            }
+
+            tsl::robin_map<uint32_t, utils::Entity> _entities;
+            tsl::robin_map<uint32_t, uint32_t> _joints;
+            tsl::robin_map<uint64_t, int> _morphTargets;
+    };
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+namespace polyvox {
+
+    ///
+    /// Runs [fn](i) for every i in [0, count) on the calling thread and up to [workers] threads of [pool], returning once every index
+    /// has been processed. Indices are handed out in chunks of [grain] from a shared counter, so whichever threads are free take the work.
+    ///
+    template <typename F>
+    void parallelFor(flutter_filament::ThreadPool* pool, int workers, size_t count, size_t grain, F&& fn) {
+        std::atomic<size_t> next { 0 };
+        auto work = [&]() {
+            for(size_t begin = next.fetch_add(grain); begin < count; begin = next.fetch_add(grain)) {
+                size_t end = std::min(count, begin + grain);
+                for(size_t i = begin; i < end; i++) {
+                    fn(i);
+                }
+            }
+        };
+        size_t chunks = (count + grain - 1) / grain;
+        size_t helpers = std::min<size_t>(workers, chunks > 0 ? chunks - 1 : 0);
+        std::vector<std::future<void>> done;
+        for(size_t i = 0; i < helpers; i++) {
+            std::packaged_task<void()> task(work);
+            done.push_back(pool->add_task(task));
+        }
+        work();
+        for(auto& d : done) {
+            d.wait();
+        }
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef _RENDER_REASON_HPP
+#define _RENDER_REASON_HPP
+
+//
+// Bitmask describing why a frame was rendered (see get_last_render_reasons).
+// When on-demand rendering is enabled, a frame is only rendered if at least one of these is set.
+//
+enum RenderReason {
+    RENDER_REASON_NONE = 0,
+    RENDER_REASON_ANIMATION = 1 << 0,   // an animation is playing, or morph weights/animation frames were set
+    RENDER_REASON_MANIPULATOR = 1 << 1, // the camera manipulator moved
+    RENDER_REASON_TRANSFORM = 1 << 2,   // an asset was moved, rotated or scaled
+    RENDER_REASON_MATERIAL = 1 << 3,    // a material parameter or texture changed
+    RENDER_REASON_LIGHT = 1 << 4,       // a light was added or removed
+    RENDER_REASON_CAMERA = 1 << 5,      // a camera property changed
+    RENDER_REASON_SCENE = 1 << 6,       // assets, skybox, IBL or background changed
+    RENDER_REASON_VIEW = 1 << 7,        // viewport, swap chain, render target or post-processing changed
+    RENDER_REASON_IDLE = 1 << 8,        // nothing changed, but the idle frame rate is due
+    RENDER_REASON_CONTINUOUS = 1 << 9,  // on-demand rendering is disabled
+    RENDER_REASON_REQUESTED = 1 << 10   // a frame was explicitly requested
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include <stdint.h>
 
 #if defined(__cplusplus)
+#include <mutex>
 extern "C" {
 #endif
     // 
@@ -42,7 +43,16 @@ extern "C" {
             
         };
 
+        // None of the platform loaders is thread-safe (each hands out IDs and tracks buffers in an unsynchronized map), but
+        // resources are fetched on AssetManager's loader pool while the render thread (and texture release callbacks) free
+        // others, so every load and free is serialized here.
+        static std::mutex& loaderMutex() {
+          static std::mutex mutex;
+          return mutex;
+        }
+
         ResourceBuffer load(const char* uri) const {
+          std::lock_guard<std::mutex> lock(loaderMutex());
           if(mLoadFilamentResourceFromOwner) {
             auto rb = mLoadFilamentResourceFromOwner(uri, mOwner);
             return rb;
@@ -52,6 +62,7 @@ extern "C" {
         }
 
         void free(ResourceBuffer rb) const {
+          std::lock_guard<std::mutex> lock(loaderMutex());
           if(mFreeFilamentResourceFromOwner) {
             mFreeFilamentResourceFromOwner(rb, mOwner);
           } else {
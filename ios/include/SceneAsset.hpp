@@ -19,6 +19,13 @@
 #include <gltfio/ResourceLoader.h>
 #include <utils/NameComponentManager.h>
 
+#include <tsl/robin_map.h>
+
+#include "BoneMixer.hpp"
+#include "Bvh.hpp"
+#include "CompressedBoneClip.hpp"
+#include "NameIndex.hpp"
+
 extern "C" {
     #include "FlutterFilamentApi.h"
 }
@@ -29,8 +36,6 @@ namespace polyvox {
     using namespace utils;
     using namespace std;
 
-    typedef std::chrono::time_point<std::chrono::high_resolution_clock> time_point_t;   
-
     enum AnimationType {
         MORPH, BONE, GLTF
     };
@@ -53,6 +58,15 @@ namespace polyvox {
         float mFrameLengthInMs = 0;
         vector<float> mFrameData;
         vector<int> mMorphIndices;
+        // resolved from mMeshTarget in setMorphAnimationBuffer (and again whenever an asset is destroyed, since that can
+        // move other renderables' instances)
+        RenderableManager::Instance mRenderable;
+        uint32_t mRenderableGeneration = 0;
+        // the current weight of every morph target on mMeshTarget; each frame's weights are scattered into this so they can be
+        // uploaded with a single setMorphWeights call covering [mMinMorphIndex, mMaxMorphIndex]
+        vector<float> mWeights;
+        int mMinMorphIndex = 0;
+        int mMaxMorphIndex = -1;
     };
 
     // 
@@ -70,12 +84,70 @@ namespace polyvox {
         size_t skinIndex = 0;
         int mNumFrames = -1;
         float mFrameLengthInMs = 0;
+        CompressedBoneClip mFrames;
+    };
+
+    //
+    // A glTF animation pre-sampled at a fixed rate (see AssetManager::setAnimationBakeRate), so playback is a frame lookup and
+    // an interpolation rather than evaluating every channel. Immutable once built, so shared between every instance of an asset.
+    //
+    struct BakedAnimation {
+        float mSampleRate = 0;
+        int mNumFrames = 0;
+        // the index in FilamentInstance::getEntities() of each node the animation moves
+        vector<uint32_t> mNodes;
+        // the local transform of each node in each frame, as 10 floats (locX, locY, locZ, rotW, rotX, rotY, rotZ, scaleX, scaleY, scaleZ)
         vector<float> mFrameData;
     };
 
+    // indexed by glTF animation index; null for animations that weren't baked
+    typedef vector<shared_ptr<const BakedAnimation>> BakedAnimations;
+
+    //
+    // CPU-side triangles for ray casting (see AssetManager::raycast), in bind pose (skinning and morph targets are ignored).
+    // Each mesh is paired with the index of its node's entity in FilamentInstance::getEntities.
+    // Built from the glTF source data, so shared between every instance of an asset.
+    //
+    struct AssetGeometry {
+        vector<pair<uint32_t, MeshBvh>> meshes;
+    };
+
+    //
+    // Per-frame scratch space for AssetManager::updateAnimations, written when animations are sampled (possibly on a worker thread)
+    // and read back when they are committed on the render thread. Kept on the SceneAsset so the buffers are reused between frames.
+    //
+    struct AnimationSample {
+        struct Entry {
+            int animationIndex;       // index into SceneAsset::mAnimations
+            float elapsed;            // seconds since the animation (or current loop) started
+            uint32_t dataOffset;      // offset of this animation's weights/transforms in morphWeights/boneTransforms
+            bool completed;
+            bool restart;             // a looping animation that has wrapped around
+            bool baked;               // a glTF animation played from SceneAsset::mBakedAnimations (see bakedTransforms)
+        };
+        vector<Entry> entries;
+        // one weight per entry in MorphAnimationBuffer::mMorphIndices, for each MORPH animation
+        vector<float> morphWeights;
+        // one transform per entry in BoneAnimationBuffer::mBones, for each BONE animation
+        vector<math::mat4f> boneTransforms;
+        // scratch space for the interpolated bone rotations of the BONE animation being sampled
+        vector<math::quatf> boneRotations;
+        // one transform per entry in BakedAnimation::mNodes, for each baked GLTF animation
+        vector<math::mat4f> bakedTransforms;
+        // the clip pose of each bone mixer layer (one entry per clip bone, starting at layerOffsets[layer], or UINT32_MAX if the
+        // layer isn't playing)
+        vector<uint32_t> layerOffsets;
+        vector<math::float3> layerTranslations;
+        vector<math::quatf> layerRotations;
+    };
+
     struct SceneAsset {
         bool mAnimating = false;
         FilamentAsset* mAsset = nullptr;
+        // the instance this SceneAsset controls.
+        // for instanced assets (see AssetManager::loadGlbInstanced), mAsset is shared between several SceneAssets and
+        // every per-instance operation (entities, root transform, animator, materials) must go through this instead.
+        FilamentInstance* mInstance = nullptr;
         Animator* mAnimator = nullptr;
 
         // vector containing AnimationStatus structs for the morph, bone and/or glTF animations.
@@ -87,8 +159,19 @@ namespace polyvox {
         float fadeDuration = 0.0f;
         float fadeOutAnimationStart = 0.0f;
 
+        // shared between copies, since it never changes once built
+        shared_ptr<const NameIndex> mNames;
+
+        // null if the source data had already been released when the asset was added
+        shared_ptr<const AssetGeometry> mGeometry;
+
+        // null unless the asset was loaded while an animation bake rate was set
+        shared_ptr<const BakedAnimations> mBakedAnimations;
+
         MorphAnimationBuffer mMorphAnimationBuffer;
         BoneAnimationBuffer mBoneAnimationBuffer;
+        BoneMixer mBoneMixer;
+        AnimationSample mSample;
 
         // a slot to preload textures
         filament::Texture* mTexture = nullptr;
@@ -102,9 +185,10 @@ namespace polyvox {
         float mScale = 1;
 
       SceneAsset(
-            FilamentAsset* asset
-        ) : mAsset(asset) {
-            mAnimator = mAsset->getInstance()->getAnimator();
+            FilamentAsset* asset,
+            FilamentInstance* instance = nullptr
+        ) : mAsset(asset), mInstance(instance ? instance : asset->getInstance()) {
+            mAnimator = mInstance->getAnimator();
         }
     };
 }
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace polyvox {
+
+    //
+    // A handle into a SlotMap. The generation is bumped every time a slot is freed, so a handle to a removed
+    // element is detected as stale (rather than silently aliasing whatever was inserted into the slot afterwards).
+    //
+    struct SlotHandle {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+
+        bool operator==(const SlotHandle& other) const {
+            return index == other.index && generation == other.generation;
+        }
+        bool operator!=(const SlotHandle& other) const {
+            return !(*this == other);
+        }
+    };
+
+    //
+    // Generational slot map.
+    // Elements are stored contiguously (so iteration is a plain loop over a vector) and are addressed by stable handles.
+    // Insert, remove and lookup are all O(1); removal swaps the last element into the hole, so iteration order is not preserved
+    // and pointers/references to elements are invalidated by insert and remove (handles are not).
+    //
+    template <typename T>
+    class SlotMap {
+        public:
+            SlotHandle insert(T value) {
+                uint32_t slotIndex;
+                if(_freeHead != UINT32_MAX) {
+                    slotIndex = _freeHead;
+                    _freeHead = _slots[slotIndex].index;
+                } else {
+                    slotIndex = (uint32_t)_slots.size();
+                    _slots.push_back({ 0, 0 });
+                }
+                auto& slot = _slots[slotIndex];
+                slot.index = (uint32_t)_values.size();
+                _values.push_back(std::move(value));
+                _denseToSlot.push_back(slotIndex);
+                return { slotIndex, slot.generation };
+            }
+
+            ///
+            /// Removes the element referenced by [handle]. Returns false if the handle is stale.
+            ///
+            bool remove(SlotHandle handle) {
+                if(!contains(handle)) {
+                    return false;
+                }
+                auto& slot = _slots[handle.index];
+                uint32_t denseIndex = slot.index;
+                uint32_t last = (uint32_t)_values.size() - 1;
+                if(denseIndex != last) {
+                    _values[denseIndex] = std::move(_values[last]);
+                    _denseToSlot[denseIndex] = _denseToSlot[last];
+                    _slots[_denseToSlot[denseIndex]].index = denseIndex;
+                }
+                _values.pop_back();
+                _denseToSlot.pop_back();
+
+                slot.generation++;
+                slot.index = _freeHead;
+                _freeHead = handle.index;
+                return true;
+            }
+
+            bool contains(SlotHandle handle) const {
+                return handle.index < _slots.size() && _slots[handle.index].generation == handle.generation;
+            }
+
+            ///
+            /// Returns the element referenced by [handle], or nullptr if the handle is stale.
+            ///
+            T* get(SlotHandle handle) {
+                if(!contains(handle)) {
+                    return nullptr;
+                }
+                return &_values[_slots[handle.index].index];
+            }
+            const T* get(SlotHandle handle) const {
+                if(!contains(handle)) {
+                    return nullptr;
+                }
+                return &_values[_slots[handle.index].index];
+            }
+
+            // unchecked; only use with handles known to be live
+            T& operator[](SlotHandle handle) {
+                return _values[_slots[handle.index].index];
+            }
+            const T& operator[](SlotHandle handle) const {
+                return _values[_slots[handle.index].index];
+            }
+
+            void clear() {
+                // bump every live slot's generation so outstanding handles are detected as stale
+                for(auto slotIndex : _denseToSlot) {
+                    auto& slot = _slots[slotIndex];
+                    slot.generation++;
+                    slot.index = _freeHead;
+                    _freeHead = slotIndex;
+                }
+                _values.clear();
+                _denseToSlot.clear();
+            }
+
+            size_t size() const { return _values.size(); }
+            bool empty() const { return _values.empty(); }
+
+            typename std::vector<T>::iterator begin() { return _values.begin(); }
+            typename std::vector<T>::iterator end() { return _values.end(); }
+            typename std::vector<T>::const_iterator begin() const { return _values.begin(); }
+            typename std::vector<T>::const_iterator end() const { return _values.end(); }
+
+        private:
+            struct Slot {
+                // the element's index in _values while the slot is live, otherwise the next free slot
+                uint32_t index;
+                uint32_t generation;
+            };
+            std::vector<T> _values;
+            std::vector<uint32_t> _denseToSlot;
+            std::vector<Slot> _slots;
+            uint32_t _freeHead = UINT32_MAX;
+    };
+}
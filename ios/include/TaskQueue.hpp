@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace polyvox {
+
+    //
+    // A bounded, lock-free, multi-producer/single-consumer queue of void() callables.
+    //
+    // Each slot reserves kInlineSize bytes so that typical lambdas (a few pointers, a matrix, a std::string or std::vector)
+    // are constructed in place without any heap allocation. Larger (or over-aligned) callables fall back to a single heap allocation.
+    //
+    // Slots are claimed with a per-slot sequence number (Vyukov's bounded queue), so producers never block each other
+    // and the consumer never takes a lock. tryPush returns false when the queue is full; it is up to the caller to decide how to apply backpressure.
+    //
+    // tryRun/empty must only ever be called from the (single) consumer thread.
+    //
+    template <size_t Capacity = 1024>
+    class TaskQueue {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        static constexpr size_t kInlineSize = 96;
+
+        TaskQueue() {
+            for(size_t i = 0; i < Capacity; i++) {
+                _slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        ~TaskQueue() {
+            // destroy (without running) anything that was never consumed
+            while(tryPop(false)) {}
+        }
+
+        TaskQueue(const TaskQueue&) = delete;
+        TaskQueue& operator=(const TaskQueue&) = delete;
+
+        template <class F>
+        bool tryPush(F&& task) {
+            using Fn = typename std::decay<F>::type;
+            Slot* slot;
+            size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+            while(true) {
+                slot = &_slots[pos & kMask];
+                size_t seq = slot->sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+                if(diff == 0) {
+                    if(_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if(diff < 0) {
+                    return false;
+                } else {
+                    pos = _enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+            emplace<Fn>(*slot, std::forward<F>(task));
+            slot->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        ///
+        /// Pops and runs the oldest task (consumer thread only).
+        /// Returns false if the queue was empty.
+        ///
+        bool tryRun() {
+            return tryPop(true);
+        }
+
+        bool empty() const {
+            const Slot& slot = _slots[_dequeuePos & kMask];
+            return slot.sequence.load(std::memory_order_acquire) != _dequeuePos + 1;
+        }
+
+    private:
+        static constexpr size_t kMask = Capacity - 1;
+
+        struct alignas(64) Slot {
+            std::atomic<size_t> sequence;
+            void (*invoke)(void*);
+            void (*destroy)(void*);
+            alignas(std::max_align_t) unsigned char storage[kInlineSize];
+        };
+
+        template <class Fn, class F>
+        static void emplace(Slot& slot, F&& task) {
+            if constexpr(sizeof(Fn) <= kInlineSize && alignof(Fn) <= alignof(std::max_align_t)) {
+                new (slot.storage) Fn(std::forward<F>(task));
+                slot.invoke = [](void* storage) { (*static_cast<Fn*>(storage))(); };
+                slot.destroy = [](void* storage) { static_cast<Fn*>(storage)->~Fn(); };
+            } else {
+                *reinterpret_cast<Fn**>(slot.storage) = new Fn(std::forward<F>(task));
+                slot.invoke = [](void* storage) { (**static_cast<Fn**>(storage))(); };
+                slot.destroy = [](void* storage) { delete *static_cast<Fn**>(storage); };
+            }
+        }
+
+        bool tryPop(bool run) {
+            Slot& slot = _slots[_dequeuePos & kMask];
+            if(slot.sequence.load(std::memory_order_acquire) != _dequeuePos + 1) {
+                return false;
+            }
+            // the slot stays claimed until the task has finished, so the task itself is free to push more tasks
+            if(run) {
+                slot.invoke(slot.storage);
+            }
+            slot.destroy(slot.storage);
+            slot.sequence.store(_dequeuePos + Capacity, std::memory_order_release);
+            _dequeuePos++;
+            return true;
+        }
+
+        Slot _slots[Capacity];
+        alignas(64) std::atomic<size_t> _enqueuePos { 0 };
+        alignas(64) size_t _dequeuePos = 0;
+    };
+}
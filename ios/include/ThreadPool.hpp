@@ -4,6 +4,8 @@
  */
 
 #include <future>
+#include <mutex>
+#include <condition_variable>
 #include <thread>
 #include <deque>
 #include <vector>
@@ -32,7 +34,11 @@ public:
 		}
 	}
 	~ThreadPool() {
-		stop = true;
+		{
+			std::unique_lock<std::mutex> lock(access);
+			stop = true;
+		}
+		cond.notify_all();
 		for(std::thread &t : pool) {
 			t.join();
 		}
@@ -54,13 +60,14 @@ public:
 private:
 	void add_worker() {
 		std::thread t([this]() {
-			while(!stop) {
+			while(true) {
 				std::function<void()> task;
 				{
+					// sleep until there's work, rather than polling, so idle pools cost nothing
 					std::unique_lock<std::mutex> lock(access);
-					if(tasks.empty()) {
-						cond.wait_for(lock, std::chrono::duration<int, std::milli>(5));
-						continue;
+					cond.wait(lock, [this] { return stop || !tasks.empty(); });
+					if(stop) {
+						return;
 					}
 					task = std::move(tasks.front());
 					tasks.pop_front();
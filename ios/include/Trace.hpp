@@ -0,0 +1,91 @@
+#pragma once
+
+//
+// Lightweight scoped tracing, written out in the Chrome trace-event JSON format (viewable in chrome://tracing or ui.perfetto.dev).
+//
+// Tracing is compiled in only when FLUTTER_FILAMENT_TRACING is defined (see the FLUTTER_FILAMENT_TRACING flag in each platform's CMakeLists.txt).
+// Otherwise every TRACE_* macro expands to nothing.
+//
+// Even when compiled in, scopes cost a single relaxed atomic load until tracing is started with start_tracing.
+// Events are recorded into a fixed-size ring (the oldest events are overwritten once it is full) and are only serialized when tracing is stopped.
+//
+// Use TRACE_SCOPE/TRACE_FUNCTION for a whole C++ scope, or TRACE_BEGIN/TRACE_END for a phase within a function.
+//
+// Event names must be string literals (or otherwise outlive the trace), since only the pointer is recorded.
+//
+#ifdef FLUTTER_FILAMENT_TRACING
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace polyvox {
+
+    class Tracer {
+        public:
+            struct Event {
+                const char* name;
+                const char* category;
+                uint64_t startInMicroseconds;
+                uint64_t durationInMicroseconds;
+                uint32_t threadId;
+            };
+
+            static bool start(const char* outputPath, size_t maxEvents);
+            static bool stop();
+
+            static bool isEnabled() {
+                return _enabled.load(std::memory_order_relaxed);
+            }
+
+            static uint64_t now() {
+                return std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+            }
+
+            static void record(const char* name, const char* category, uint64_t start, uint64_t end);
+
+        private:
+            static std::atomic<bool> _enabled;
+    };
+
+    class TraceScope {
+        public:
+            TraceScope(const char* name, const char* category) : _name(name), _category(category) {
+                if(Tracer::isEnabled()) {
+                    _start = Tracer::now();
+                }
+            }
+            ~TraceScope() {
+                end();
+            }
+            void end() {
+                if(_start) {
+                    Tracer::record(_name, _category, _start, Tracer::now());
+                    _start = 0;
+                }
+            }
+        private:
+            const char* const _name;
+            const char* const _category;
+            uint64_t _start = 0;
+    };
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name, category) polyvox::TraceScope TRACE_CONCAT(__traceScope, __LINE__)(name, category)
+#define TRACE_FUNCTION(category) TRACE_SCOPE(__func__, category)
+// for phases that don't map onto a C++ scope
+#define TRACE_BEGIN(id, name, category) polyvox::TraceScope __trace_##id(name, category)
+#define TRACE_END(id) __trace_##id.end()
+
+#else
+
+#define TRACE_SCOPE(name, category)
+#define TRACE_FUNCTION(category)
+#define TRACE_BEGIN(id, name, category)
+#define TRACE_END(id)
+
+#endif
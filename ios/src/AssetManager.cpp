@@ -1,12 +1,14 @@
 #include <string>
 #include <sstream>
 #include <thread>
+#include <limits>
 #include <vector> 
 
 #include <filament/Engine.h>
 #include <filament/TransformManager.h>
 #include <filament/Texture.h>
 #include <filament/RenderableManager.h>
+#include <filament/LightManager.h>
 
 #include <gltfio/Animator.h>
 #include <gltfio/AssetLoader.h>
@@ -17,10 +19,14 @@
 
 #include <imageio/ImageDecoder.h>
 
+#include "cgltf.h"
+
 #include "StreamBufferAdapter.hpp"
 #include "SceneAsset.hpp"
 #include "Log.hpp"
 #include "AssetManager.hpp"
+#include "ParallelFor.hpp"
+#include "Trace.hpp"
 
 #include "material/FileMaterialProvider.hpp"
 #include "gltfio/materials/uberarchive.h"
@@ -38,6 +44,63 @@ using namespace utils;
 using namespace filament;
 using namespace filament::gltfio;
 
+//
+// State for a single asynchronous load (see loadGlbAsync/loadGltfAsync).
+// Only ever touched on the render thread; worker threads only ever see the ResourceLoaderWrapper and the URIs they were given,
+// and hand their results back via the futures.
+//
+struct AssetManager::AsyncLoad {
+    EntityId entityId = 0;
+    string uri;
+    string relativeResourcePath;
+    bool isGlb = true;
+    AssetLoadCallback callback = nullptr;
+    AssetLoadState state = ASSET_LOAD_FETCHING;
+    bool cancelled = false;
+
+    std::future<ResourceBuffer> mainBuffer;
+    // one future per external resource, in the same order as resourceUris
+    vector<std::future<ResourceBuffer>> resourceBuffers;
+
+    // every buffer fetched so far (the main file first, then external resources in the order of resourceUris).
+    // these must outlive the upload, since the ResourceLoader references (rather than copies) them.
+    vector<ResourceBuffer> buffers;
+    vector<string> resourceUris;
+    uint64_t bytesFetched = 0;
+
+    FilamentAsset* asset = nullptr;
+    // each load gets its own ResourceLoader/decoders, since a ResourceLoader only tracks a single asynchronous load at a time
+    gltfio::ResourceLoader* resourceLoader = nullptr;
+    gltfio::TextureProvider* stbDecoder = nullptr;
+    gltfio::TextureProvider* ktxDecoder = nullptr;
+};
+
+// ResourceLoaderWrapper serializes every load (none of the platform loaders is thread-safe), so more loader threads would only
+// queue on its lock; the pool exists to keep fetches off the render thread
+static constexpr int kLoaderThreads = 1;
+
+// animation sampling is only spread across the animation pool once this many assets are animating (below this, the hand-off costs more than it saves)
+static constexpr size_t kMinParallelAnimatedAssets = 8;
+// number of assets each animation worker takes at a time
+static constexpr size_t kAnimationGrain = 4;
+// upper bound for the default animation pool size
+static constexpr int kMaxAnimationThreads = 7;
+
+// 64-bit FNV-1a
+static uint64_t hashContents(const void* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    auto bytes = (const uint8_t*)data;
+    for(size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+template <class T>
+static bool isReady(const std::future<T>& future) {
+    return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
 AssetManager::AssetManager(const ResourceLoaderWrapper* const resourceLoaderWrapper,
                            NameComponentManager* ncm,
                            Engine* engine,
@@ -73,9 +136,26 @@ _scene(scene) {
     _gltfResourceLoader->addTextureProvider("image/ktx2", _ktxDecoder);
     _gltfResourceLoader->addTextureProvider("image/png", _stbDecoder);
     _gltfResourceLoader->addTextureProvider("image/jpeg", _stbDecoder);
+
+    _loaderPool = new flutter_filament::ThreadPool(kLoaderThreads);
 }
 
 AssetManager::~AssetManager() { 
+    for(auto& load : _asyncLoads) {
+        // wait for any in-flight fetch so its buffers can be freed
+        if(load->mainBuffer.valid()) {
+            load->buffers.push_back(load->mainBuffer.get());
+        }
+        for(auto& rb : load->resourceBuffers) {
+            load->buffers.push_back(rb.get());
+        }
+        // don't call back into the client while tearing down
+        load->callback = nullptr;
+        finishAsyncLoad(*load, ASSET_LOAD_CANCELLED);
+    }
+    _asyncLoads.clear();
+    delete _loaderPool;
+    delete _animationPool;
     _gltfResourceLoader->asyncCancelLoad();
     _ubershaderProvider->destroyMaterials();
     destroyAll();
@@ -85,10 +165,16 @@ AssetManager::~AssetManager() {
 
 EntityId AssetManager::loadGltf(const char *uri,
                                 const char *relativeResourcePath) {
+    TRACE_FUNCTION("loader");
+    markDirty(RENDER_REASON_SCENE);
+    TRACE_BEGIN(fetch, "loadGltf::fetch", "loader");
     ResourceBuffer rbuf = _resourceLoaderWrapper->load(uri);
+    TRACE_END(fetch);
     
     // Parse the glTF file and create Filament entities.
+    TRACE_BEGIN(parse, "loadGltf::parse", "loader");
     FilamentAsset *asset = _assetLoader->createAsset((uint8_t *)rbuf.data, rbuf.size);
+    TRACE_END(parse);
     
     if (!asset) {
         Log("Unable to parse asset");
@@ -98,21 +184,33 @@ EntityId AssetManager::loadGltf(const char *uri,
     const char *const *const resourceUris = asset->getResourceUris();
     const size_t resourceUriCount = asset->getResourceUriCount();
 
+    vector<string> paths;
+    for (size_t i = 0; i < resourceUriCount; i++) {
+        paths.push_back(string(relativeResourcePath) + string("/") + string(resourceUris[i]));
+    }
+
     std::vector<ResourceBuffer> resourceBuffers;
     
+    TRACE_BEGIN(fetchResources, "loadGltf::fetchResources", "loader");
+    auto fetches = fetchResources(paths);
+    // wait in order, so resources are added in the same order regardless of which fetch finishes first
     for (size_t i = 0; i < resourceUriCount; i++) {
-        string uri = string(relativeResourcePath) + string("/") + string(resourceUris[i]);
-        Log("Loading resource URI from relative path %s", resourceUris[i], uri.c_str());
-        ResourceBuffer buf = _resourceLoaderWrapper->load(uri.c_str());
-    
+        ResourceBuffer buf = fetches[i].get();
         resourceBuffers.push_back(buf);
-        
+        if(!buf.data) {
+            Log("Failed to load resource %s", paths[i].c_str());
+            continue;
+        }
         ResourceLoader::BufferDescriptor b(buf.data, buf.size);
         _gltfResourceLoader->addResourceData(resourceUris[i], std::move(b));
     }
+    TRACE_END(fetchResources);
     
     // load resources synchronously
-    if (!_gltfResourceLoader->loadResources(asset)) {
+    TRACE_BEGIN(loadResources, "loadGltf::loadResources", "loader");
+    bool loaded = _gltfResourceLoader->loadResources(asset);
+    TRACE_END(loadResources);
+    if (!loaded) {
         Log("Unknown error loading glTF asset");
         _resourceLoaderWrapper->free(rbuf);
         for(auto& rb : resourceBuffers) {
@@ -122,13 +220,13 @@ EntityId AssetManager::loadGltf(const char *uri,
     }
     const utils::Entity *entities = asset->getEntities();
         
+    TRACE_BEGIN(sceneInsert, "loadGltf::sceneInsert", "loader");
     _scene->addEntities(asset->getEntities(), asset->getEntityCount());
 
     FilamentInstance* inst = asset->getInstance();
     inst->getAnimator()->updateBoneMatrices();
     inst->recomputeBoundingBoxes();
-    
-    asset->releaseSourceData();
+    TRACE_END(sceneInsert);
     
     SceneAsset sceneAsset(asset);
     
@@ -136,8 +234,10 @@ EntityId AssetManager::loadGltf(const char *uri,
     
     EntityId eid = Entity::smuggle(e);
     
-    _entityIdLookup.emplace(eid, _assets.size());
-    _assets.push_back(sceneAsset);
+    addSceneAsset(eid, sceneAsset);
+
+    // only after addSceneAsset, which needs the source data to build the ray casting geometry
+    asset->releaseSourceData();
 
     for(auto& rb : resourceBuffers) {
         _resourceLoaderWrapper->free(rb);
@@ -150,13 +250,23 @@ EntityId AssetManager::loadGltf(const char *uri,
 }
 
 EntityId AssetManager::loadGlb(const char *uri, bool unlit) {
+    TRACE_FUNCTION("loader");
+    markDirty(RENDER_REASON_SCENE);
+
+    if(_assetCacheBudget > 0) {
+        return loadCachedGlb(uri);
+    }
         
+    TRACE_BEGIN(fetch, "loadGlb::fetch", "loader");
     ResourceBuffer rbuf = _resourceLoaderWrapper->load(uri);
+    TRACE_END(fetch);
 
     Log("Loaded GLB of size %d at URI %s", rbuf.size, uri);
 
+    TRACE_BEGIN(parse, "loadGlb::parse", "loader");
     FilamentAsset *asset = _assetLoader->createAsset(
                                                      (const uint8_t *)rbuf.data, rbuf.size);
+    TRACE_END(parse);
     
     if (!asset) {
         Log("Unknown error loading GLB asset.");
@@ -167,7 +277,10 @@ EntityId AssetManager::loadGlb(const char *uri, bool unlit) {
     
     _scene->addEntities(asset->getEntities(), entityCount);
     
-    if (!_gltfResourceLoader->loadResources(asset)) {
+    TRACE_BEGIN(loadResources, "loadGlb::loadResources", "loader");
+    bool loaded = _gltfResourceLoader->loadResources(asset);
+    TRACE_END(loadResources);
+    if (!loaded) {
         Log("Unknown error loading glb asset");
         _resourceLoaderWrapper->free(rbuf);
         return 0;
@@ -175,6 +288,7 @@ EntityId AssetManager::loadGlb(const char *uri, bool unlit) {
         
     const Entity *entities = asset->getEntities();
     
+    TRACE_BEGIN(sceneInsert, "loadGlb::sceneInsert", "loader");
     auto lights = asset->getLightEntities();
     _scene->addEntities(lights, asset->getLightEntityCount());
     
@@ -183,33 +297,795 @@ EntityId AssetManager::loadGlb(const char *uri, bool unlit) {
     inst->getAnimator()->updateBoneMatrices();
     
     inst->recomputeBoundingBoxes();
-    
-    asset->releaseSourceData();
-    
-    _resourceLoaderWrapper->free(rbuf);
+    TRACE_END(sceneInsert);
     
     SceneAsset sceneAsset(asset);
     
     utils::Entity e = EntityManager::get().create();
     EntityId eid = Entity::smuggle(e);
     
-    _entityIdLookup.emplace(eid, _assets.size());
-    _assets.push_back(sceneAsset);
+    addSceneAsset(eid, sceneAsset);
+
+    // only after addSceneAsset, which needs the source data to build the ray casting geometry
+    asset->releaseSourceData();
+    
+    _resourceLoaderWrapper->free(rbuf);
     
     return eid;
 }
 
-bool AssetManager::hide(EntityId entityId, const char* meshName) {
+///
+/// Loads the GLB at [uri] once and creates [numInstances] instances of it, writing the EntityId of each instance to [out].
+/// Instances share vertex/index buffers, textures and materials, but each has its own entities, transform, animator,
+/// material instances and visibility. Lights belong to the asset rather than any single instance.
+/// Further instances can be added later with createInstance (the source data is retained for this purpose).
+/// Returns the number of instances created (0 on failure).
+///
+int AssetManager::loadGlbInstanced(const char *uri, int numInstances, EntityId* out) {
+    TRACE_FUNCTION("loader");
+    if(numInstances < 1) {
+        Log("Instance count must be at least 1");
+        return 0;
+    }
+    markDirty(RENDER_REASON_SCENE);
+
+    ResourceBuffer rbuf = _resourceLoaderWrapper->load(uri);
+
+    vector<FilamentInstance*> instances(numInstances);
+    FilamentAsset *asset = _assetLoader->createInstancedAsset(
+                                                     (const uint8_t *)rbuf.data, rbuf.size, instances.data(), numInstances);
+    
+    if (!asset) {
+        Log("Unknown error loading GLB asset.");
+        _resourceLoaderWrapper->free(rbuf);
+        return 0;
+    }
     
+    bool loaded = _gltfResourceLoader->loadResources(asset);
+    _resourceLoaderWrapper->free(rbuf);
+    if (!loaded) {
+        Log("Unknown error loading glb asset");
+        destroyAsset(asset);
+        return 0;
+    }
+
+    _scene->addEntities(asset->getLightEntities(), asset->getLightEntityCount());
+
+    auto& state = _instancedAssets[asset];
+    for(int i = 0; i < numInstances; i++) {
+        out[i] = addInstance(asset, instances[i]);
+    }
+    state.liveInstances = numInstances;
+    state.lastUsed = ++_assetCacheClock;
+
+    Log("Loaded %d instances of GLB at URI %s", numInstances, uri);
+    return numInstances;
+}
+
+///
+/// Creates another instance of the asset that [entityId] is an instance of (which must have been loaded with loadGlbInstanced).
+/// Previously removed instances are re-used before any new instance is created.
+/// Returns the EntityId of the new instance (0 on failure).
+///
+EntityId AssetManager::createInstance(EntityId entityId) {
+    TRACE_FUNCTION("loader");
     auto asset = getAssetByEntityId(entityId);
     if(!asset) {
+        Log("ERROR: asset not found for entity.");
+        return 0;
+    }
+    auto instanced = _instancedAssets.find(asset);
+    if(instanced == _instancedAssets.end()) {
+        Log("ERROR: asset for entity %d was not loaded with loadGlbInstanced", entityId);
+        return 0;
+    }
+    return instantiate(asset, instanced.value());
+}
+
+EntityId AssetManager::instantiate(FilamentAsset* asset, InstancedAsset& state) {
+    FilamentInstance* instance = nullptr;
+    if(!state.recycled.empty()) {
+        instance = state.recycled.back();
+        state.recycled.pop_back();
+        auto& tm = _engine->getTransformManager();
+        tm.setTransform(tm.getInstance(instance->getRoot()), math::mat4f());
+    } else {
+        instance = _assetLoader->createInstance(asset);
+        if(!instance) {
+            Log("ERROR: failed to create instance");
+            return 0;
+        }
+    }
+    markDirty(RENDER_REASON_SCENE);
+    // lights belong to the asset, so are only in the scene while at least one instance is
+    if(state.liveInstances == 0) {
+        _scene->addEntities(asset->getLightEntities(), asset->getLightEntityCount());
+    }
+    state.liveInstances++;
+    state.lastUsed = ++_assetCacheClock;
+    return addInstance(asset, instance);
+}
+
+///
+/// loadGlb via the asset template cache.
+/// Each GLB is parsed (and its textures decoded) once, then kept alive as a template with its source data retained
+/// so further loads of the same URI (or of a different URI with identical contents) are just a createInstance.
+/// A template stays cached while any of its instances exist; once the last is removed it becomes eligible for LRU eviction
+/// under the cache budget (see setAssetCacheBudget).
+///
+/// N.B. a cache hit by URI doesn't re-read the file, so changes on disk aren't picked up until the template is evicted.
+///
+EntityId AssetManager::loadCachedGlb(const char* uri) {
+    auto byUri = _assetCacheByUri.find(uri);
+    if(byUri != _assetCacheByUri.end()) {
+        _assetCacheStats.hits++;
+        auto asset = byUri->second;
+        return instantiate(asset, _instancedAssets[asset]);
+    }
+
+    TRACE_BEGIN(fetch, "loadGlb::fetch", "loader");
+    ResourceBuffer rbuf = _resourceLoaderWrapper->load(uri);
+    TRACE_END(fetch);
+    if(!rbuf.data) {
+        Log("Failed to load GLB at URI %s", uri);
+        return 0;
+    }
+
+    auto contentHash = hashContents(rbuf.data, rbuf.size);
+    auto byHash = _assetCacheByHash.find(contentHash);
+    if(byHash != _assetCacheByHash.end()) {
+        _resourceLoaderWrapper->free(rbuf);
+        _assetCacheStats.hits++;
+        auto asset = byHash->second;
+        _assetCacheByUri.emplace(uri, asset);
+        return instantiate(asset, _instancedAssets[asset]);
+    }
+    _assetCacheStats.misses++;
+
+    TRACE_BEGIN(parse, "loadGlb::parse", "loader");
+    FilamentInstance* instance = nullptr;
+    FilamentAsset *asset = _assetLoader->createInstancedAsset((const uint8_t *)rbuf.data, rbuf.size, &instance, 1);
+    TRACE_END(parse);
+    if (!asset) {
+        Log("Unknown error loading GLB asset.");
+        _resourceLoaderWrapper->free(rbuf);
+        return 0;
+    }
+
+    TRACE_BEGIN(loadResources, "loadGlb::loadResources", "loader");
+    bool loaded = _gltfResourceLoader->loadResources(asset);
+    TRACE_END(loadResources);
+    size_t sizeInBytes = rbuf.size;
+    _resourceLoaderWrapper->free(rbuf);
+    if (!loaded) {
+        Log("Unknown error loading glb asset");
+        destroyAsset(asset);
+        return 0;
+    }
+
+    auto& state = _instancedAssets[asset];
+    state.cached = true;
+    state.contentHash = contentHash;
+    state.sizeInBytes = sizeInBytes;
+    _assetCacheByUri.emplace(uri, asset);
+    _assetCacheByHash.emplace(contentHash, asset);
+    _assetCacheSize += sizeInBytes;
+
+    _scene->addEntities(asset->getLightEntities(), asset->getLightEntityCount());
+    state.liveInstances = 1;
+    state.lastUsed = ++_assetCacheClock;
+    auto eid = addInstance(asset, instance);
+
+    evictAssetCache();
+    return eid;
+}
+
+///
+/// Destroys unused cached templates (least recently used first) until the cache is within budget.
+/// Templates with live instances are never evicted, so the cache may exceed its budget while they exist.
+///
+void AssetManager::evictAssetCache() {
+    while(_assetCacheSize > _assetCacheBudget) {
+        auto lru = _instancedAssets.end();
+        for(auto it = _instancedAssets.begin(); it != _instancedAssets.end(); it++) {
+            const auto& state = it->second;
+            if(state.cached && state.liveInstances == 0 && (lru == _instancedAssets.end() || state.lastUsed < lru->second.lastUsed)) {
+                lru = it;
+            }
+        }
+        if(lru == _instancedAssets.end()) {
+            return;
+        }
+        auto asset = lru->first;
+        for(auto it = _assetCacheByUri.begin(); it != _assetCacheByUri.end();) {
+            if(it->second == asset) {
+                it = _assetCacheByUri.erase(it);
+            } else {
+                it++;
+            }
+        }
+        _assetCacheByHash.erase(lru->second.contentHash);
+        _assetCacheSize -= lru->second.sizeInBytes;
+        _assetCacheStats.evictions++;
+        _instancedAssets.erase(lru);
+        destroyAsset(asset);
+    }
+}
+
+///
+/// Sets the budget (in source file bytes) for the template cache used by loadGlb. The cache is off (0) by default.
+/// Once enabled, every loadGlb is an instance of a cached template, so recycled instances carry over any material changes
+/// (and the pose of any animation that was playing) from the instance that was removed.
+///
+void AssetManager::setAssetCacheBudget(size_t budgetInBytes) {
+    _assetCacheBudget = budgetInBytes;
+    evictAssetCache();
+}
+
+void AssetManager::getAssetCacheStats(AssetCacheStats* out) {
+    *out = _assetCacheStats;
+    out->bytesCached = _assetCacheSize;
+    out->budgetInBytes = _assetCacheBudget;
+    out->templateCount = 0;
+    out->idleTemplateCount = 0;
+    for(const auto& it : _instancedAssets) {
+        if(it.second.cached) {
+            out->templateCount++;
+            if(it.second.liveInstances == 0) {
+                out->idleTemplateCount++;
+            }
+        }
+    }
+}
+
+EntityId AssetManager::addInstance(FilamentAsset* asset, FilamentInstance* instance) {
+    _scene->addEntities(instance->getEntities(), instance->getEntityCount());
+    instance->getAnimator()->updateBoneMatrices();
+    instance->recomputeBoundingBoxes();
+
+    SceneAsset sceneAsset(asset, instance);
+    EntityId eid = Entity::smuggle(EntityManager::get().create());
+    addSceneAsset(eid, sceneAsset);
+    return eid;
+}
+
+void AssetManager::addSceneAsset(EntityId entityId, SceneAsset& sceneAsset) {
+    sceneAsset.mNames = buildNameIndex(sceneAsset);
+    auto& cached = _geometryCache[sceneAsset.mAsset];
+    sceneAsset.mGeometry = cached.lock();
+    if(!sceneAsset.mGeometry) {
+        sceneAsset.mGeometry = buildGeometry(sceneAsset);
+        cached = sceneAsset.mGeometry;
+    }
+    if(_animationBakeRate > 0.0f) {
+        auto baked = _bakedAnimationCache.find(sceneAsset.mAsset);
+        if(baked == _bakedAnimationCache.end()) {
+            baked = _bakedAnimationCache.emplace(sceneAsset.mAsset, bakeAnimations(sceneAsset)).first;
+        }
+        sceneAsset.mBakedAnimations = baked->second;
+    }
+    _entityIdLookup.emplace(entityId, _assets.insert(sceneAsset));
+}
+
+///
+/// Returns the ID for [name], interning it if this is the first time it has been seen.
+/// IDs are never reused, so can be cached by clients for the lifetime of the AssetManager.
+///
+uint32_t AssetManager::internName(const char* name) {
+    return _nameTable.intern(name);
+}
+
+const char* AssetManager::getNameForId(uint32_t nameId) const {
+    auto name = _nameTable.getName(nameId);
+    return name ? name : "<unknown>";
+}
+
+///
+/// Returns the ID for [name], or 0 if no loaded asset has ever had an entity, joint or morph target with this name.
+///
+uint32_t AssetManager::getNameId(const char* name) const {
+    return _nameTable.find(name);
+}
+
+shared_ptr<const NameIndex> AssetManager::buildNameIndex(const SceneAsset& asset) {
+    TRACE_FUNCTION("loader");
+    auto index = make_shared<NameIndex>();
+    const utils::Entity* entities = asset.mInstance->getEntities();
+    for(size_t i = 0, c = asset.mInstance->getEntityCount(); i < c; i++) {
+        auto entity = entities[i];
+        auto name = _ncm->getName(_ncm->getInstance(entity));
+        if(!name) {
+            continue;
+        }
+        auto nameId = internName(name);
+        index->addEntity(nameId, entity);
+        size_t morphTargetCount = asset.mAsset->getMorphTargetCountAt(entity);
+        for(size_t j = 0; j < morphTargetCount; j++) {
+            auto morphName = asset.mAsset->getMorphTargetNameAt(entity, j);
+            if(morphName) {
+                index->addMorphTarget(nameId, internName(morphName), (int)j);
+            }
+        }
+    }
+    if(asset.mInstance->getSkinCount() > 0) {
+        const utils::Entity* joints = asset.mInstance->getJointsAt(0);
+        for(size_t i = 0, c = asset.mInstance->getJointCountAt(0); i < c; i++) {
+            auto name = _ncm->getName(_ncm->getInstance(joints[i]));
+            if(name) {
+                index->addJoint(internName(name), (uint32_t)i);
+            }
+        }
+    }
+    return index;
+}
+
+// appends [node] and its descendants in the same depth-first order gltfio creates an instance's entities in
+static void collectNodes(const cgltf_data* data, const cgltf_node* node, vector<bool>& visited, vector<const cgltf_node*>& out) {
+    size_t index = node - data->nodes;
+    if(visited[index]) {
+        return;
+    }
+    visited[index] = true;
+    out.push_back(node);
+    for(size_t i = 0; i < node->children_count; i++) {
+        collectNodes(data, node->children[i], visited, out);
+    }
+}
+
+///
+/// Copies the triangles of every mesh in [asset] out of the glTF source data and builds a BVH for each.
+/// Returns nullptr if the source data has been released, or if the nodes can't be matched up with the instance's entities.
+///
+shared_ptr<const AssetGeometry> AssetManager::buildGeometry(const SceneAsset& asset) {
+    TRACE_FUNCTION("loader");
+    auto data = (const cgltf_data*)asset.mAsset->getSourceAsset();
+    if(!data) {
+        return nullptr;
+    }
+
+    vector<const cgltf_node*> nodes;
+    vector<bool> visited(data->nodes_count, false);
+    if(data->scenes_count == 0) {
+        for(size_t i = 0; i < data->nodes_count; i++) {
+            if(!data->nodes[i].parent) {
+                collectNodes(data, &data->nodes[i], visited, nodes);
+            }
+        }
+    } else {
+        for(size_t i = 0; i < data->scenes_count; i++) {
+            for(size_t j = 0; j < data->scenes[i].nodes_count; j++) {
+                collectNodes(data, data->scenes[i].nodes[j], visited, nodes);
+            }
+        }
+    }
+
+    const utils::Entity* entities = asset.mInstance->getEntities();
+    size_t entityCount = asset.mInstance->getEntityCount();
+    // some versions of gltfio list the instance root first
+    size_t entityOffset = entityCount == nodes.size() + 1 && entities[0] == asset.mInstance->getRoot() ? 1 : 0;
+    if(entityCount != nodes.size() + entityOffset) {
+        Log("Node count (%zu) doesn't match entity count (%zu), ray casting will ignore this asset", nodes.size(), entityCount);
+        return nullptr;
+    }
+
+    auto& rm = _engine->getRenderableManager();
+    auto geometry = make_shared<AssetGeometry>();
+    vector<math::float3> positions;
+    vector<uint32_t> primitives;
+    vector<uint32_t> triangles;
+    vector<float> unpacked;
+    for(size_t n = 0; n < nodes.size(); n++) {
+        const cgltf_node* node = nodes[n];
+        if(!node->mesh) {
+            continue;
+        }
+        uint32_t entityIndex = (uint32_t)(n + entityOffset);
+        auto entity = entities[entityIndex];
+        auto name = _ncm->getName(_ncm->getInstance(entity));
+        if(!rm.hasComponent(entity) || (node->name && name && strcmp(node->name, name) != 0)) {
+            Log("Node %s doesn't match its entity, ray casting will ignore this asset", node->name ? node->name : "(unnamed)");
+            return nullptr;
+        }
+
+        positions.clear();
+        primitives.clear();
+        triangles.clear();
+        for(size_t p = 0; p < node->mesh->primitives_count; p++) {
+            const cgltf_primitive& primitive = node->mesh->primitives[p];
+            if(primitive.type != cgltf_primitive_type_triangles) {
+                continue;
+            }
+            const cgltf_accessor* position = nullptr;
+            for(size_t a = 0; a < primitive.attributes_count; a++) {
+                if(primitive.attributes[a].type == cgltf_attribute_type_position && primitive.attributes[a].index == 0) {
+                    position = primitive.attributes[a].data;
+                }
+            }
+            // Draco-compressed primitives have no buffer view (gltfio decodes them straight into its vertex buffers)
+            if(!position || !position->buffer_view || !position->buffer_view->buffer->data) {
+                continue;
+            }
+            const cgltf_accessor* indices = primitive.indices;
+            if(indices && (!indices->buffer_view || !indices->buffer_view->buffer->data)) {
+                continue;
+            }
+            unpacked.resize(position->count * 3);
+            cgltf_accessor_unpack_floats(position, unpacked.data(), unpacked.size());
+            size_t triangleCount = (indices ? indices->count : position->count) / 3;
+            for(size_t t = 0; t < triangleCount; t++) {
+                size_t v[3];
+                for(int k = 0; k < 3; k++) {
+                    v[k] = indices ? cgltf_accessor_read_index(indices, t * 3 + k) : t * 3 + k;
+                }
+                if(v[0] >= position->count || v[1] >= position->count || v[2] >= position->count) {
+                    continue;
+                }
+                for(int k = 0; k < 3; k++) {
+                    positions.push_back(math::float3(unpacked[v[k] * 3], unpacked[v[k] * 3 + 1], unpacked[v[k] * 3 + 2]));
+                }
+                primitives.push_back((uint32_t)p);
+                triangles.push_back((uint32_t)t);
+            }
+        }
+        if(triangles.empty()) {
+            continue;
+        }
+        geometry->meshes.emplace_back(entityIndex, MeshBvh());
+        geometry->meshes.back().second.build(positions, primitives, triangles);
+    }
+    return geometry;
+}
+
+///
+/// Brings the scene BVH up to date: rebuilt if assets were added, removed, hidden or revealed since the last ray cast,
+/// otherwise refit if anything was moved or animated.
+///
+void AssetManager::updateSceneBvh() {
+    uint32_t reasons = _raycastDirtyReasons.exchange(RENDER_REASON_NONE);
+    auto& tm = _engine->getTransformManager();
+    auto getWorldTransform = [&](utils::Entity entity) {
+        return tm.getWorldTransform(tm.getInstance(entity));
+    };
+    if(reasons & RENDER_REASON_SCENE) {
+        TRACE_SCOPE("AssetManager::rebuildSceneBvh", "raycast");
+        vector<SceneBvh::Instance> instances;
+        for(const auto& it : _entityIdLookup) {
+            const auto* sceneAsset = _assets.get(it.second);
+            if(!sceneAsset || !sceneAsset->mGeometry) {
+                continue;
+            }
+            const auto& asset = *sceneAsset;
+            const utils::Entity* entities = asset.mInstance->getEntities();
+            for(const auto& mesh : asset.mGeometry->meshes) {
+                auto entity = entities[mesh.first];
+                // hidden meshes are removed from the scene
+                if(!_scene->hasEntity(entity)) {
+                    continue;
+                }
+                SceneBvh::Instance instance;
+                instance.asset = it.first;
+                instance.entity = entity;
+                instance.mesh = &mesh.second;
+                SceneBvh::setWorldTransform(instance, getWorldTransform(entity));
+                instances.push_back(instance);
+            }
+        }
+        _sceneBvh.build(std::move(instances));
+    } else if(reasons & (RENDER_REASON_TRANSFORM | RENDER_REASON_ANIMATION)) {
+        TRACE_SCOPE("AssetManager::refitSceneBvh", "raycast");
+        _sceneBvh.refit(getWorldTransform);
+    }
+}
+
+bool AssetManager::raycast(const math::float3& origin, const math::float3& direction, RaycastHit* out) {
+    *out = {};
+    float length = norm(direction);
+    if(length <= 0.0f) {
+        Log("Ray direction must be non-zero");
+        return false;
+    }
+    updateSceneBvh();
+    Ray ray(origin, direction / length);
+    SceneBvh::Hit hit;
+    if(!_sceneBvh.intersect(ray, std::numeric_limits<float>::infinity(), hit)) {
         return false;
     }
+    out->asset = hit.instance->asset;
+    out->entity = Entity::smuggle(hit.instance->entity);
+    out->primitive = (int32_t)hit.mesh.primitive;
+    out->triangle = (int32_t)hit.mesh.triangle;
+    out->u = hit.mesh.u;
+    out->v = hit.mesh.v;
+    out->distance = hit.mesh.distance;
+    auto position = ray.origin + ray.direction * hit.mesh.distance;
+    out->position[0] = position.x;
+    out->position[1] = position.y;
+    out->position[2] = position.z;
+    return true;
+}
+
+EntityId AssetManager::reserveEntityId() {
+    // EntityManager is thread-safe, so this can be called from any thread
+    return Entity::smuggle(EntityManager::get().create());
+}
+
+EntityId AssetManager::loadGlbAsync(const char *uri, AssetLoadCallback callback, EntityId entityId) {
+    auto load = std::make_unique<AsyncLoad>();
+    load->uri = uri;
+    load->isGlb = true;
+    load->callback = callback;
+    load->entityId = entityId;
+    return beginAsyncLoad(std::move(load));
+}
+
+EntityId AssetManager::loadGltfAsync(const char *uri, const char *relativeResourcePath, AssetLoadCallback callback, EntityId entityId) {
+    auto load = std::make_unique<AsyncLoad>();
+    load->uri = uri;
+    load->relativeResourcePath = relativeResourcePath;
+    load->isGlb = false;
+    load->callback = callback;
+    load->entityId = entityId;
+    return beginAsyncLoad(std::move(load));
+}
+
+///
+/// Queues a fetch of each of [paths] on the loader pool, so the render thread can carry on while they're read.
+/// The returned futures are in the same order as [paths].
+///
+vector<std::future<ResourceBuffer>> AssetManager::fetchResources(const vector<string>& paths) {
+    vector<std::future<ResourceBuffer>> fetches;
+    fetches.reserve(paths.size());
+    auto wrapper = _resourceLoaderWrapper;
+    for(const auto& path : paths) {
+        std::packaged_task<ResourceBuffer()> fetch([wrapper, path] {
+            TRACE_SCOPE("AssetManager::fetchResource", "loader");
+            return wrapper->load(path.c_str());
+        });
+        fetches.push_back(_loaderPool->add_task(fetch));
+    }
+    return fetches;
+}
+
+EntityId AssetManager::beginAsyncLoad(unique_ptr<AsyncLoad> load) {
+    if(!load->entityId) {
+        load->entityId = reserveEntityId();
+    }
+    auto wrapper = _resourceLoaderWrapper;
+    std::packaged_task<ResourceBuffer()> fetch([wrapper, uri = load->uri] {
+        TRACE_SCOPE("AssetManager::fetch", "loader");
+        return wrapper->load(uri.c_str());
+    });
+    load->mainBuffer = _loaderPool->add_task(fetch);
+    auto entityId = load->entityId;
+    _asyncLoads.push_back(std::move(load));
+    return entityId;
+}
+
+///
+/// Advances every in-flight asynchronous load by (at most) one stage; must be called once per frame on the render thread.
+///
+void AssetManager::updateAsyncLoads() {
+    if(_asyncLoads.empty()) {
+        return;
+    }
+    TRACE_FUNCTION("loader");
+    for(auto it = _asyncLoads.begin(); it != _asyncLoads.end();) {
+        if(updateAsyncLoad(**it)) {
+            it = _asyncLoads.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+///
+/// Returns true once [load] has finished (successfully or otherwise).
+///
+bool AssetManager::updateAsyncLoad(AsyncLoad& load) {
+    switch(load.state) {
+        case ASSET_LOAD_FETCHING: {
+            if(!isReady(load.mainBuffer)) {
+                return false;
+            }
+            load.buffers.push_back(load.mainBuffer.get());
+            const auto& rbuf = load.buffers.front();
+            load.bytesFetched += rbuf.size;
+            if(load.cancelled) {
+                return finishAsyncLoad(load, ASSET_LOAD_CANCELLED);
+            }
+            if(!rbuf.data) {
+                Log("Failed to fetch asset at URI %s", load.uri.c_str());
+                return finishAsyncLoad(load, ASSET_LOAD_FAILED);
+            }
+            load.state = ASSET_LOAD_PARSING;
+            return false;
+        }
+        case ASSET_LOAD_PARSING: {
+            TRACE_SCOPE("AssetManager::parse", "loader");
+            const auto& rbuf = load.buffers.front();
+            load.asset = _assetLoader->createAsset((const uint8_t *)rbuf.data, rbuf.size);
+            if(!load.asset) {
+                Log("Unable to parse asset at URI %s", load.uri.c_str());
+                return finishAsyncLoad(load, ASSET_LOAD_FAILED);
+            }
+            if(!load.isGlb) {
+                const char *const *const resourceUris = load.asset->getResourceUris();
+                const size_t resourceUriCount = load.asset->getResourceUriCount();
+                vector<string> paths;
+                for(size_t i = 0; i < resourceUriCount; i++) {
+                    load.resourceUris.push_back(resourceUris[i]);
+                    paths.push_back(load.relativeResourcePath + string("/") + string(resourceUris[i]));
+                }
+                load.resourceBuffers = fetchResources(paths);
+            }
+            load.state = ASSET_LOAD_FETCHING_RESOURCES;
+            return false;
+        }
+        case ASSET_LOAD_FETCHING_RESOURCES: {
+            for(const auto& fetch : load.resourceBuffers) {
+                if(!isReady(fetch)) {
+                    return false;
+                }
+            }
+            for(auto& fetch : load.resourceBuffers) {
+                auto rb = fetch.get();
+                load.bytesFetched += rb.size;
+                load.buffers.push_back(rb);
+            }
+            load.resourceBuffers.clear();
+            if(load.cancelled) {
+                return finishAsyncLoad(load, ASSET_LOAD_CANCELLED);
+            }
+
+            load.resourceLoader = new ResourceLoader({.engine = _engine, .normalizeSkinningWeights = true });
+            load.stbDecoder = createStbProvider(_engine);
+            load.ktxDecoder = createKtx2Provider(_engine);
+            load.resourceLoader->addTextureProvider("image/ktx2", load.ktxDecoder);
+            load.resourceLoader->addTextureProvider("image/png", load.stbDecoder);
+            load.resourceLoader->addTextureProvider("image/jpeg", load.stbDecoder);
+
+            for(size_t i = 0; i < load.resourceUris.size(); i++) {
+                const auto& rb = load.buffers[i + 1];
+                if(!rb.data) {
+                    Log("Failed to fetch resource %s for asset at URI %s", load.resourceUris[i].c_str(), load.uri.c_str());
+                    return finishAsyncLoad(load, ASSET_LOAD_FAILED);
+                }
+                load.resourceLoader->addResourceData(load.resourceUris[i].c_str(), ResourceLoader::BufferDescriptor(rb.data, rb.size));
+            }
+
+            if(!load.resourceLoader->asyncBeginLoad(load.asset)) {
+                Log("Failed to begin loading resources for asset at URI %s", load.uri.c_str());
+                return finishAsyncLoad(load, ASSET_LOAD_FAILED);
+            }
+            load.state = ASSET_LOAD_UPLOADING;
+            return false;
+        }
+        case ASSET_LOAD_UPLOADING: {
+            TRACE_SCOPE("AssetManager::asyncUpdateLoad", "loader");
+            load.resourceLoader->asyncUpdateLoad();
+            if(load.resourceLoader->asyncGetLoadProgress() < 1.0f) {
+                return false;
+            }
+
+            _scene->addEntities(load.asset->getEntities(), load.asset->getEntityCount());
+            _scene->addEntities(load.asset->getLightEntities(), load.asset->getLightEntityCount());
+
+            FilamentInstance* inst = load.asset->getInstance();
+            inst->getAnimator()->updateBoneMatrices();
+            inst->recomputeBoundingBoxes();
+
+            SceneAsset sceneAsset(load.asset);
+            addSceneAsset(load.entityId, sceneAsset);
+            load.asset->releaseSourceData();
+            markDirty(RENDER_REASON_SCENE);
+
+            Log("Finished loading asset from %s", load.uri.c_str());
+            return finishAsyncLoad(load, ASSET_LOAD_READY);
+        }
+        default:
+            return true;
+    }
+}
+
+///
+/// Releases everything owned by [load] (destroying the asset and the reserved entity unless it was successfully added to the scene)
+/// and invokes its callback.
+/// Always returns true.
+///
+bool AssetManager::finishAsyncLoad(AsyncLoad& load, AssetLoadState state) {
+    if(load.resourceLoader) {
+        if(state != ASSET_LOAD_READY) {
+            load.resourceLoader->asyncCancelLoad();
+        }
+        delete load.resourceLoader;
+        delete load.stbDecoder;
+        delete load.ktxDecoder;
+        load.resourceLoader = nullptr;
+    }
+    if(state != ASSET_LOAD_READY && load.asset) {
+        destroyAsset(load.asset);
+        load.asset = nullptr;
+    }
+    for(auto& rb : load.buffers) {
+        if(rb.data) {
+            _resourceLoaderWrapper->free(rb);
+        }
+    }
+    load.buffers.clear();
+    if(state != ASSET_LOAD_READY) {
+        // the ID was reserved (see reserveEntityId) for an asset that will never be added, so hand the entity back
+        EntityManager::get().destroy(Entity::import(load.entityId));
+    }
+    load.state = state;
+    if(load.callback) {
+        load.callback(load.entityId, state == ASSET_LOAD_READY);
+    }
+    return true;
+}
+
+bool AssetManager::getLoadProgress(EntityId entityId, AssetLoadProgress* out) {
+    *out = {};
+    for(auto& load : _asyncLoads) {
+        if(load->entityId != entityId) {
+            continue;
+        }
+        out->state = load->state;
+        out->bytesFetched = load->bytesFetched;
+        out->resourceCount = load->resourceUris.size();
+        if(load->resourceLoader) {
+            out->progress = load->resourceLoader->asyncGetLoadProgress();
+            out->textureCount = load->stbDecoder->getPushedCount() + load->ktxDecoder->getPushedCount();
+            out->texturesDecoded = load->stbDecoder->getDecodedCount() + load->ktxDecoder->getDecodedCount();
+        }
+        return true;
+    }
+    if(_entityIdLookup.find(entityId) != _entityIdLookup.end()) {
+        out->state = ASSET_LOAD_READY;
+        out->progress = 1.0f;
+        return true;
+    }
+    return false;
+}
+
+///
+/// Cancels an in-flight asynchronous load. If a worker is still fetching, the load is finished (and the callback invoked) once the fetch completes.
+/// Returns false if there is no in-flight load for [entityId].
+///
+bool AssetManager::cancelLoad(EntityId entityId) {
+    for(auto it = _asyncLoads.begin(); it != _asyncLoads.end(); it++) {
+        auto& load = **it;
+        if(load.entityId != entityId) {
+            continue;
+        }
+        bool fetching = (load.state == ASSET_LOAD_FETCHING) || 
+            (load.state == ASSET_LOAD_FETCHING_RESOURCES && !load.resourceBuffers.empty());
+        if(fetching) {
+            load.cancelled = true;
+        } else {
+            finishAsyncLoad(load, ASSET_LOAD_CANCELLED);
+            _asyncLoads.erase(it);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool AssetManager::hide(EntityId entityId, const char* meshName) {
+    return hide(entityId, getNameId(meshName));
+}
+
+bool AssetManager::hide(EntityId entityId, uint32_t meshNameId) {
+    markDirty(RENDER_REASON_SCENE);
     
-    auto entity = findEntityByName(asset, meshName);
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
+        return false;
+    }
+    
+    auto entity = findEntityByName(*sceneAsset, meshNameId);
     
     if(entity.isNull()) {
-        Log("Mesh %s could not be found", meshName);
+        Log("Mesh %s could not be found", getNameForId(meshNameId));
         return false;
     }
     _scene->remove(entity);
@@ -217,18 +1093,21 @@ bool AssetManager::hide(EntityId entityId, const char* meshName) {
 }
 
 bool AssetManager::reveal(EntityId entityId, const char* meshName) {
-    auto asset = getAssetByEntityId(entityId);
-    if(!asset) {
+    return reveal(entityId, getNameId(meshName));
+}
+
+bool AssetManager::reveal(EntityId entityId, uint32_t meshNameId) {
+    markDirty(RENDER_REASON_SCENE);
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
         Log("No asset found under entity ID");
         return false;
     }
     
-    auto entity = findEntityByName(asset, meshName);
-    
-    RenderableManager &rm = _engine->getRenderableManager();
+    auto entity = findEntityByName(*sceneAsset, meshNameId);
     
     if(entity.isNull()) {
-        Log("Mesh %s could not be found", meshName);
+        Log("Mesh %s could not be found", getNameForId(meshNameId));
         return false;
     }
     _scene->addEntity(entity);
@@ -236,126 +1115,526 @@ bool AssetManager::reveal(EntityId entityId, const char* meshName) {
 }
 
 void AssetManager::destroyAll() {
+    markDirty(RENDER_REASON_SCENE);
     for (auto& asset : _assets) {
-        _scene->removeEntities(asset.mAsset->getEntities(),
-                                asset.mAsset->getEntityCount());
+        _scene->removeEntities(asset.mInstance->getEntities(),
+                                asset.mInstance->getEntityCount());
+        if(asset.mTexture) {
+            _engine->destroy(asset.mTexture);
+        }
+        // instanced assets are shared, so are destroyed once below
+        if(_instancedAssets.find(asset.mAsset) != _instancedAssets.end()) {
+            continue;
+        }
         _scene->removeEntities(asset.mAsset->getLightEntities(),
                                 asset.mAsset->getLightEntityCount());
-        _assetLoader->destroyAsset(asset.mAsset);
+        destroyAsset(asset.mAsset);
+    }
+    for (auto& it : _instancedAssets) {
+        auto asset = it.first;
+        _scene->removeEntities(asset->getLightEntities(), asset->getLightEntityCount());
+        destroyAsset(asset);
     }
+    _instancedAssets.clear();
+    _assetCacheByUri.clear();
+    _assetCacheByHash.clear();
+    _assetCacheSize = 0;
     _assets.clear();
+    _entityIdLookup.clear();
 }
 
-FilamentAsset* AssetManager::getAssetByEntityId(EntityId entityId) {
+///
+/// Returns the asset registered under [entityId], or nullptr if there is none (or its handle has gone stale).
+///
+SceneAsset* AssetManager::getSceneAsset(EntityId entityId) {
     const auto& pos = _entityIdLookup.find(entityId);
     if(pos == _entityIdLookup.end()) {
         return nullptr;
     }
-    return _assets[pos->second].mAsset;
+    return _assets.get(pos->second);
 }
 
+const SceneAsset* AssetManager::getSceneAsset(EntityId entityId) const {
+    const auto& pos = _entityIdLookup.find(entityId);
+    if(pos == _entityIdLookup.end()) {
+        return nullptr;
+    }
+    return _assets.get(pos->second);
+}
+
+FilamentAsset* AssetManager::getAssetByEntityId(EntityId entityId) {
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
+        return nullptr;
+    }
+    return sceneAsset->mAsset;
+}
 
-void AssetManager::updateAnimations() { 
+FilamentInstance* AssetManager::getInstanceByEntityId(EntityId entityId) {
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
+        return nullptr;
+    }
+    return sceneAsset->mInstance;
+}
+
+
+///
+/// Applies every active animation for the current time.
+/// Animations are evaluated in two phases: sampling (working out the frame due for each animation and evaluating morph weights
+/// and bone transforms), which only touches the SceneAsset and so is spread across the animation pool when enough assets are animating,
+/// then committing the results to the engine, which must happen serially on the render thread.
+/// Returns true if anything actually moved (i.e. the scene needs to be re-rendered).
+///
+bool AssetManager::updateAnimations() { 
+    TRACE_FUNCTION("animation");
     
     std::lock_guard lock(_animationMutex);
-    RenderableManager &rm = _engine->getRenderableManager();
-    
+
+    _animatingAssets.clear();
     for (auto& asset : _assets) {
+        if(!asset.mAnimations.empty() || asset.mBoneMixer.mDirty || asset.mBoneMixer.isPlaying()) {
+            _animatingAssets.push_back(&asset);
+        }
+    }
+    if(_animatingAssets.empty()) {
+        return false;
+    }
 
-        
-        std::vector<int> completed;
-        int index = 0;
-        for(auto& anim : asset.mAnimations) {
+    auto now = high_resolution_clock::now();
 
-            auto now = high_resolution_clock::now();
-            
-            auto elapsed = float(std::chrono::duration_cast<std::chrono::milliseconds>(now - anim.mStart).count()) / 1000.0f;
-            
-            if(anim.mLoop || elapsed < anim.mDuration) {
-                
-                switch(anim.type) {
-                    case AnimationType::GLTF: {
-                        asset.mAnimator->applyAnimation(anim.gltfIndex, elapsed);
-                        if(asset.fadeGltfAnimationIndex != -1 && elapsed < asset.fadeDuration) {
-                            // cross-fade
-                            auto fadeFromTime = asset.fadeOutAnimationStart + elapsed;
-                            auto alpha = elapsed / asset.fadeDuration;
-                            asset.mAnimator->applyCrossFade(asset.fadeGltfAnimationIndex, fadeFromTime, alpha);
+    if(_animationThreadCount < 0 && _animatingAssets.size() >= kMinParallelAnimatedAssets) {
+        // first time there's enough work to share out; leave a core for the render thread itself, which also samples animations
+        _animationThreadCount = std::clamp<int>((int)std::thread::hardware_concurrency() - 1, 0, kMaxAnimationThreads);
+        if(_animationThreadCount > 0) {
+            _animationPool = new flutter_filament::ThreadPool(_animationThreadCount);
+        }
+        Log("Started %d animation worker thread(s)", _animationThreadCount);
+    }
+
+    TRACE_BEGIN(sample, "AssetManager::sampleAnimations", "animation");
+    if(_animationPool && _animatingAssets.size() >= kMinParallelAnimatedAssets) {
+        parallelFor(_animationPool, _animationThreadCount, _animatingAssets.size(), kAnimationGrain, [&](size_t i) {
+            sampleAnimations(*_animatingAssets[i], now);
+        });
+    } else {
+        for(auto asset : _animatingAssets) {
+            sampleAnimations(*asset, now);
+        }
+    }
+    TRACE_END(sample);
+
+    TRACE_BEGIN(commit, "AssetManager::commitAnimations", "animation");
+    bool changed = false;
+    for(auto asset : _animatingAssets) {
+        changed |= commitAnimations(*asset, now);
+    }
+    TRACE_END(commit);
+
+    if(changed) {
+        // glTF animations move nodes, so the ray casting BVH needs refitting
+        _raycastDirtyReasons |= RENDER_REASON_ANIMATION;
+    }
+    return changed;
+}
+
+void AssetManager::getAnimationStats(AnimationStats* out) {
+    std::lock_guard lock(_animationMutex);
+    *out = _animationStats;
+}
+
+///
+/// Sets the number of worker threads (in addition to the render thread) used to sample animations. 0 samples everything on the render thread.
+/// A negative count restores the default, where no threads are started until kMinParallelAnimatedAssets assets are animating at
+/// once, and then one fewer than the number of cores (up to kMaxAnimationThreads).
+///
+void AssetManager::setAnimationThreadCount(int count) {
+    std::lock_guard lock(_animationMutex);
+    delete _animationPool;
+    _animationPool = nullptr;
+    _animationThreadCount = std::max(count, -1);
+    if(_animationThreadCount > 0) {
+        _animationPool = new flutter_filament::ThreadPool(_animationThreadCount);
+    }
+    Log("Using %d animation worker thread(s)", _animationThreadCount);
+}
+
+///
+/// Sets the rate at which the glTF animations of assets loaded from now on are pre-sampled (see BakedAnimation).
+/// Trades memory for not having to evaluate every channel of every instance each frame, so is worth it for assets with many
+/// instances playing the same animations. 0 (the default) disables baking.
+///
+void AssetManager::setAnimationBakeRate(float samplesPerSecond) {
+    std::lock_guard lock(_animationMutex);
+    _animationBakeRate = std::max(samplesPerSecond, 0.0f);
+}
+
+///
+/// Samples each of [asset]'s glTF animations at _animationBakeRate by playing it through the Animator, recording the local
+/// transform of every node that moves. Animations of morph target weights are left to the Animator.
+/// Needs the asset's source data, so must be called before it's released.
+///
+shared_ptr<const BakedAnimations> AssetManager::bakeAnimations(const SceneAsset& asset) {
+    TRACE_FUNCTION("animation");
+    auto data = (const cgltf_data*)asset.mAsset->getSourceAsset();
+    size_t animationCount = asset.mAnimator->getAnimationCount();
+    if(animationCount == 0) {
+        return nullptr;
+    }
+    if(!data || data->animations_count != animationCount) {
+        Log("Warning: source data for asset has been released, not baking animations");
+        return nullptr;
+    }
+
+    TransformManager& transformManager = _engine->getTransformManager();
+    const utils::Entity* entities = asset.mInstance->getEntities();
+    size_t entityCount = asset.mInstance->getEntityCount();
+    vector<TransformManager::Instance> instances(entityCount);
+    vector<math::mat4f> restTransforms(entityCount);
+    for(size_t i = 0; i < entityCount; i++) {
+        instances[i] = transformManager.getInstance(entities[i]);
+        if(instances[i].isValid()) {
+            restTransforms[i] = transformManager.getTransform(instances[i]);
+        }
+    }
+
+    auto baked = make_shared<BakedAnimations>(animationCount);
+    vector<math::mat4f> frames;
+    for(size_t index = 0; index < animationCount; index++) {
+        const auto& animation = data->animations[index];
+        bool animatesWeights = false;
+        for(size_t i = 0; i < animation.channels_count; i++) {
+            animatesWeights |= animation.channels[i].target_path == cgltf_animation_path_type_weights;
+        }
+        if(animatesWeights) {
+            Log("Not baking animation %s, which animates morph target weights", animation.name ? animation.name : "<unnamed>");
+            continue;
+        }
+
+        float duration = asset.mAnimator->getAnimationDuration(index);
+        int numFrames = (int)std::ceil(duration * _animationBakeRate) + 1;
+        frames.resize(numFrames * entityCount);
+        for(int frame = 0; frame < numFrames; frame++) {
+            asset.mAnimator->applyAnimation(index, std::min(frame / _animationBakeRate, duration));
+            for(size_t i = 0; i < entityCount; i++) {
+                frames[frame * entityCount + i] = instances[i].isValid() ? transformManager.getTransform(instances[i]) : restTransforms[i];
+            }
+        }
+        for(size_t i = 0; i < entityCount; i++) {
+            if(instances[i].isValid()) {
+                transformManager.setTransform(instances[i], restTransforms[i]);
+            }
+        }
+
+        auto clip = make_shared<BakedAnimation>();
+        clip->mSampleRate = _animationBakeRate;
+        clip->mNumFrames = numFrames;
+        for(size_t i = 0; i < entityCount; i++) {
+            for(int frame = 0; frame < numFrames; frame++) {
+                if(frames[frame * entityCount + i] != restTransforms[i]) {
+                    clip->mNodes.push_back((uint32_t)i);
+                    break;
+                }
+            }
+        }
+        clip->mFrameData.reserve(numFrames * clip->mNodes.size() * 10);
+        for(int frame = 0; frame < numFrames; frame++) {
+            for(auto node : clip->mNodes) {
+                math::float3 translation, scale;
+                math::quatf rotation;
+                gltfio::decomposeMatrix(frames[frame * entityCount + node], &translation, &rotation, &scale);
+                clip->mFrameData.insert(clip->mFrameData.end(), {
+                    translation.x, translation.y, translation.z,
+                    rotation.w, rotation.x, rotation.y, rotation.z,
+                    scale.x, scale.y, scale.z
+                });
+            }
+        }
+        (*baked)[index] = clip;
+    }
+    return baked;
+}
+
+// the pair of keyframes of a morph/bone animation buffer either side of [elapsed] seconds in, and how far between them it is
+struct Keyframes {
+    int from = 0;
+    int to = 0;
+    float t = 0.0f;
+};
+
+static Keyframes keyframesAt(float elapsed, float duration, float frameLengthInMs, bool loop, bool reverse) {
+    Keyframes keyframes;
+    int lengthInFrames = static_cast<int>(duration * 1000.0f / frameLengthInMs + 0.5f);
+    if(lengthInFrames <= 0) {
+        return keyframes;
+    }
+    if(!loop && elapsed >= duration) {
+        // hold the last frame
+        keyframes.from = keyframes.to = reverse ? 0 : lengthInFrames - 1;
+        return keyframes;
+    }
+    float position = std::fmod(std::max(elapsed, 0.0f) * 1000.0f / frameLengthInMs, (float)lengthInFrames);
+    int frameNumber = std::min(static_cast<int>(position), lengthInFrames - 1);
+    keyframes.t = std::min(position - frameNumber, 1.0f);
+    keyframes.from = frameNumber;
+    // looping animations blend from the last frame back into the first, otherwise hold the last frame
+    keyframes.to = frameNumber + 1 < lengthInFrames ? frameNumber + 1 : (loop ? 0 : frameNumber);
+    // offset from the end if reverse
+    if(reverse) {
+        keyframes.from = lengthInFrames - 1 - keyframes.from;
+        keyframes.to = lengthInFrames - 1 - keyframes.to;
+    }
+    return keyframes;
+}
+
+// out[i] = a[i] + (b[i] - a[i]) * t; a plain loop over contiguous floats so the compiler can vectorize it
+static void lerp(const float* __restrict a, const float* __restrict b, float t, size_t count, float* __restrict out) {
+    for(size_t i = 0; i < count; i++) {
+        out[i] = a[i] + (b[i] - a[i]) * t;
+    }
+}
+
+///
+/// Works out what each of [asset]'s animations should do at [now] and evaluates the morph weights/bone transforms due,
+/// writing the results to asset.mSample. Doesn't touch the engine, so can run on any thread.
+///
+void AssetManager::sampleAnimations(SceneAsset& asset, time_point_t now) {
+    auto& sample = asset.mSample;
+    sample.entries.clear();
+    sample.morphWeights.clear();
+    sample.boneTransforms.clear();
+    sample.bakedTransforms.clear();
+
+    for(size_t index = 0; index < asset.mAnimations.size(); index++) {
+        const auto& anim = asset.mAnimations[index];
+        AnimationSample::Entry entry {};
+        entry.animationIndex = (int)index;
+        entry.elapsed = std::chrono::duration<float>(now - anim.mStart).count();
+
+        // animation has completed
+        if(!anim.mLoop && entry.elapsed >= anim.mDuration) {
+            entry.completed = true;
+            sample.entries.push_back(entry);
+            continue;
+        }
+        entry.restart = anim.mLoop && entry.elapsed >= anim.mDuration;
+
+        switch(anim.type) {
+            case AnimationType::GLTF: {
+                const BakedAnimation* baked = nullptr;
+                if(asset.mBakedAnimations && anim.gltfIndex < static_cast<int>(asset.mBakedAnimations->size())) {
+                    baked = (*asset.mBakedAnimations)[anim.gltfIndex].get();
+                }
+                if(!baked) {
+                    break;
+                }
+                size_t numNodes = baked->mNodes.size();
+                float position = std::clamp(entry.elapsed * baked->mSampleRate, 0.0f, (float)(baked->mNumFrames - 1));
+                int frame = (int)position;
+                float t = position - frame;
+                const float* from = baked->mFrameData.data() + frame * numNodes * 10;
+                const float* to = baked->mFrameData.data() + std::min(frame + 1, baked->mNumFrames - 1) * numNodes * 10;
+                entry.baked = true;
+                entry.dataOffset = (uint32_t)sample.bakedTransforms.size();
+                for(size_t i = 0; i < numNodes; i++, from += 10, to += 10) {
+                    float lerped[10];
+                    lerp(from, to, t, 10, lerped);
+                    auto rotation = shortestNlerp(math::quatf { from[3], from[4], from[5], from[6] }, math::quatf { to[3], to[4], to[5], to[6] }, t);
+                    sample.bakedTransforms.push_back(gltfio::composeMatrix(
+                        math::float3 { lerped[0], lerped[1], lerped[2] }, rotation, math::float3 { lerped[7], lerped[8], lerped[9] }));
+                }
+                break;
+            }
+            case AnimationType::MORPH: {
+                const auto& buffer = asset.mMorphAnimationBuffer;
+                size_t numMorphTargets = buffer.mMorphIndices.size();
+                auto keyframes = keyframesAt(entry.elapsed, anim.mDuration, buffer.mFrameLengthInMs, anim.mLoop, anim.mReverse);
+                size_t fromOffset = keyframes.from * numMorphTargets;
+                size_t toOffset = keyframes.to * numMorphTargets;
+                if(std::max(fromOffset, toOffset) + numMorphTargets > buffer.mFrameData.size()) {
+                    continue;
+                }
+                entry.dataOffset = (uint32_t)sample.morphWeights.size();
+                sample.morphWeights.resize(entry.dataOffset + numMorphTargets);
+                lerp(buffer.mFrameData.data() + fromOffset, buffer.mFrameData.data() + toOffset, keyframes.t, numMorphTargets,
+                     sample.morphWeights.data() + entry.dataOffset);
+                break;
+            }
+            case AnimationType::BONE: {
+                const auto& buffer = asset.mBoneAnimationBuffer;
+                size_t numBones = buffer.mBones.size();
+                auto keyframes = keyframesAt(entry.elapsed, anim.mDuration, buffer.mFrameLengthInMs, anim.mLoop, anim.mReverse);
+                if(std::max(keyframes.from, keyframes.to) >= buffer.mFrames.getNumFrames() || buffer.mFrames.getNumBones() != static_cast<int>(numBones)) {
+                    continue;
+                }
+                // translations are currently unused
+                sample.boneRotations.resize(numBones);
+                buffer.mFrames.sample(keyframes.from, keyframes.to, keyframes.t, nullptr, sample.boneRotations.data());
+                entry.dataOffset = (uint32_t)sample.boneTransforms.size();
+                for(size_t i = 0; i < numBones; i++) {
+                    sample.boneTransforms.push_back(buffer.mBaseTransforms[i] * math::mat4f(sample.boneRotations[i]));
+                }
+                break;
+            }
+        }
+        sample.entries.push_back(entry);
+    }
+
+    // bone mixer layers (blended in commitBoneMixer, since that may need the pose glTF animations leave behind)
+    const auto& mixer = asset.mBoneMixer;
+    sample.layerOffsets.assign(mixer.mLayers.size(), UINT32_MAX);
+    sample.layerTranslations.clear();
+    sample.layerRotations.clear();
+    for(size_t index = 0; index < mixer.mLayers.size(); index++) {
+        const auto& layer = mixer.mLayers[index];
+        if(layer.mClip < 0 || layer.mWeight <= 0.0f) {
+            continue;
+        }
+        const auto& clip = mixer.mClips[layer.mClip];
+        // finished layers hold their last frame
+        float elapsed = layer.mFinished ? clip.mDuration : std::chrono::duration<float>(now - layer.mStart).count();
+        size_t numBones = clip.mJoints.size();
+        auto keyframes = keyframesAt(elapsed, clip.mDuration, clip.mFrameLengthInMs, layer.mLoop, false);
+        if(std::max(keyframes.from, keyframes.to) >= clip.mFrames.getNumFrames()) {
+            continue;
+        }
+
+        uint32_t offset = (uint32_t)sample.layerRotations.size();
+        sample.layerOffsets[index] = offset;
+        sample.layerTranslations.resize(offset + numBones);
+        sample.layerRotations.resize(offset + numBones);
+        clip.mFrames.sample(keyframes.from, keyframes.to, keyframes.t, sample.layerTranslations.data() + offset, sample.layerRotations.data() + offset);
+    }
+}
+
+///
+/// Applies the results of sampleAnimations for [asset] to the engine and retires completed animations.
+/// Must be called on the render thread. Returns true if anything changed.
+///
+bool AssetManager::commitAnimations(SceneAsset& asset, time_point_t now) {
+    RenderableManager &rm = _engine->getRenderableManager();
+    const auto& sample = asset.mSample;
+    std::vector<int> completed;
+    // bone matrices only need recomputing (once, after every animation has been applied) if a joint has moved
+    bool jointsMoved = false;
+    bool changed = false;
+
+    bool gltfAnimating = false;
+    for(const auto& entry : sample.entries) {
+        gltfAnimating |= !entry.completed && asset.mAnimations[entry.animationIndex].type == AnimationType::GLTF;
+    }
+    auto& mixer = asset.mBoneMixer;
+    bool mixing = mixer.mPosed || mixer.mDirty || mixer.hasLayers();
+    if(mixing && gltfAnimating) {
+        // glTF clips leave the nodes they don't animate alone, so put the mixer's joints back to rest first rather than having
+        // the mixer blend on top of its own output from the last frame
+        resetBoneMixer(asset);
+    }
+
+    for(const auto& entry : sample.entries) {
+        auto& anim = asset.mAnimations[entry.animationIndex];
+        if(entry.completed) {
+            completed.push_back(entry.animationIndex);
+            asset.fadeGltfAnimationIndex = -1;
+        } else {
+            switch(anim.type) {
+                case AnimationType::GLTF: {
+                    if(entry.baked) {
+                        TransformManager& transformManager = _engine->getTransformManager();
+                        const utils::Entity* entities = asset.mInstance->getEntities();
+                        const auto& nodes = (*asset.mBakedAnimations)[anim.gltfIndex]->mNodes;
+                        const math::mat4f* transforms = sample.bakedTransforms.data() + entry.dataOffset;
+                        for(size_t i = 0; i < nodes.size(); i++) {
+                            transformManager.setTransform(transformManager.getInstance(entities[nodes[i]]), transforms[i]);
                         }
-                        break;
+                    } else {
+                        asset.mAnimator->applyAnimation(anim.gltfIndex, entry.elapsed);
                     }
-                    case AnimationType::MORPH: {
-                        int lengthInFrames = static_cast<int>(
-                                                              anim.mDuration * 1000.0f /
-                                                              asset.mMorphAnimationBuffer.mFrameLengthInMs
-                                                              );
-                        int frameNumber = static_cast<int>(elapsed * 1000.0f / asset.mMorphAnimationBuffer.mFrameLengthInMs) % lengthInFrames;
-                        // offset from the end if reverse
-                        if(anim.mReverse) {
-                            frameNumber = lengthInFrames - frameNumber;
-                        }
-                        auto baseOffset = frameNumber * asset.mMorphAnimationBuffer.mMorphIndices.size();
-                        for(int i = 0; i < asset.mMorphAnimationBuffer.mMorphIndices.size(); i++) {
-                            auto morphIndex = asset.mMorphAnimationBuffer.mMorphIndices[i];
-                            // set the weights appropriately
-                            rm.setMorphWeights(
-                                               rm.getInstance(asset.mMorphAnimationBuffer.mMeshTarget),
-                                               asset.mMorphAnimationBuffer.mFrameData.data() + baseOffset + i,
-                                               1,
-                                               morphIndex
-                                               );
-                        }
-                        break;
+                    if(asset.fadeGltfAnimationIndex != -1 && entry.elapsed < asset.fadeDuration) {
+                        // cross-fade
+                        auto fadeFromTime = asset.fadeOutAnimationStart + entry.elapsed;
+                        auto alpha = entry.elapsed / asset.fadeDuration;
+                        asset.mAnimator->applyCrossFade(asset.fadeGltfAnimationIndex, fadeFromTime, alpha);
                     }
-                    case AnimationType::BONE: {
-                        int lengthInFrames = static_cast<int>(
-                                                              anim.mDuration * 1000.0f /
-                                                              asset.mBoneAnimationBuffer.mFrameLengthInMs
-                                                              );
-                        int frameNumber = static_cast<int>(elapsed * 1000.0f / asset.mBoneAnimationBuffer.mFrameLengthInMs) % lengthInFrames;
-                        
-                        // offset from the end if reverse
-                        if(anim.mReverse) {
-                            frameNumber = lengthInFrames - frameNumber;
-                        }
-                        setBoneTransform(
-                                         asset,
-                                         frameNumber
-                                         );
+                    // gltfio doesn't report which nodes a clip touched, so assume any skinned asset's joints have moved
+                    jointsMoved |= asset.mInstance->getSkinCount() > 0;
+                    changed = true;
+                    break;
+                }
+                case AnimationType::MORPH: {
+                    auto& buffer = asset.mMorphAnimationBuffer;
+                    if(buffer.mRenderableGeneration != _renderableGeneration) {
+                        buffer.mRenderable = rm.getInstance(buffer.mMeshTarget);
+                        buffer.mRenderableGeneration = _renderableGeneration;
+                    }
+                    if(!buffer.mRenderable.isValid() || buffer.mMaxMorphIndex < buffer.mMinMorphIndex) {
                         break;
                     }
+                    const float* weights = sample.morphWeights.data() + entry.dataOffset;
+                    for(size_t i = 0; i < buffer.mMorphIndices.size(); i++) {
+                        buffer.mWeights[buffer.mMorphIndices[i]] = weights[i];
+                    }
+                    rm.setMorphWeights(buffer.mRenderable,
+                                       buffer.mWeights.data() + buffer.mMinMorphIndex,
+                                       buffer.mMaxMorphIndex - buffer.mMinMorphIndex + 1,
+                                       buffer.mMinMorphIndex);
+                    changed = true;
+                    break;
                 }
-                if(anim.mLoop && elapsed >= anim.mDuration) {
-                    anim.mStart = now;
+                case AnimationType::BONE: {
+                    jointsMoved |= commitBoneTransforms(asset, sample.boneTransforms.data() + entry.dataOffset);
+                    break;
                 }
-                // animation has completed
-            } else {
-                completed.push_back(index);
-                asset.fadeGltfAnimationIndex = -1;
             }
-            asset.mAnimator->updateBoneMatrices();
-            index++;
+            if(entry.restart) {
+                anim.mStart = now;
+            }
         }
+    }
 
-        for(int i = completed.size() - 1; i >= 0; i--) {
-            asset.mAnimations.erase(asset.mAnimations.begin() + i);
+    if(mixing) {
+        jointsMoved |= commitBoneMixer(asset, gltfAnimating);
+        mixer.mDirty = false;
+        // like glTF animations, non-looping layers stop once they've played through (their last frame has just been committed),
+        // but keep holding that pose until removed
+        for(auto& layer : mixer.mLayers) {
+            if(layer.mClip >= 0 && !layer.mLoop && !layer.mFinished
+               && std::chrono::duration<float>(now - layer.mStart).count() >= mixer.mClips[layer.mClip].mDuration) {
+                layer.mFinished = true;
+            }
         }
     }
+
+    // previously bone matrices were recomputed after every animation entry, so count the difference as skipped
+    uint64_t updates = jointsMoved ? 1 : 0;
+    _animationStats.boneMatrixUpdates += updates;
+    _animationStats.boneMatrixUpdatesSkipped += sample.entries.size() + (mixing ? 1 : 0) - updates;
+    if(jointsMoved) {
+        TRACE_SCOPE("Animator::updateBoneMatrices", "animation");
+        asset.mAnimator->updateBoneMatrices();
+    }
+
+    for(int i = completed.size() - 1; i >= 0; i--) {
+        asset.mAnimations.erase(asset.mAnimations.begin() + completed[i]);
+    }
+    return changed || jointsMoved;
 }
 
-void AssetManager::setBoneTransform(SceneAsset& asset, int frameNumber) {
-    
-    RenderableManager& rm = _engine->getRenderableManager();
+///
+/// Sets the local transform of each joint in [asset]'s bone animation buffer to the corresponding entry in [transforms].
+/// Returns true if any joint actually moved.
+///
+bool AssetManager::commitBoneTransforms(SceneAsset& asset, const math::mat4f* transforms) {
     
-    const auto& filamentInstance = asset.mAsset->getInstance();
+    const auto& filamentInstance = asset.mInstance;
     
     TransformManager &transformManager = _engine->getTransformManager();
     
     int skinIndex = 0;
+    bool moved = false;
     
     for(int i = 0; i < asset.mBoneAnimationBuffer.mBones.size(); i++) {
         auto mBoneIndex = asset.mBoneAnimationBuffer.mBones[i];
-        auto frameDataOffset = (frameNumber * asset.mBoneAnimationBuffer.mBones.size() * 7) + (i * 7);
         
         utils::Entity joint = filamentInstance->getJointsAt(skinIndex)[mBoneIndex];
         if(joint.isNull()) {
@@ -363,43 +1642,117 @@ void AssetManager::setBoneTransform(SceneAsset& asset, int frameNumber) {
             continue;
         }
         
-        vector<float>& fd = asset.mBoneAnimationBuffer.mFrameData;
-        
-        math::mat4f localTransform(math::quatf {
-            fd[frameDataOffset+3],
-            fd[frameDataOffset+4],
-            fd[frameDataOffset+5],
-            fd[frameDataOffset+6],
-        });
-        
-        auto jointInstance = transformManager.getInstance(joint);
-        
-        auto xform = asset.mBoneAnimationBuffer.mBaseTransforms[i];
-        
-        transformManager.setTransform(jointInstance, xform * localTransform);
+        auto jointInstance = transformManager.getInstance(joint);
         
+        if(transformManager.getTransform(jointInstance) == transforms[i]) {
+            continue;
+        }
+        transformManager.setTransform(jointInstance, transforms[i]);
+        moved = true;
+    }
+    return moved;
+}
+
+///
+/// Blends [asset]'s bone mixer layers (as sampled by sampleAnimations) and sets the local transform of each joint they drive.
+/// If [underlyingAnimated], the layers are applied on top of the joints' current transforms rather than their rest transforms.
+/// Once every layer has been removed, returns the joints to rest. Returns true if any joint actually moved.
+///
+bool AssetManager::commitBoneMixer(SceneAsset& asset, bool underlyingAnimated) {
+    auto& mixer = asset.mBoneMixer;
+    const auto& sample = asset.mSample;
+    TransformManager& transformManager = _engine->getTransformManager();
+
+    if(!mixer.hasLayers()) {
+        bool posed = mixer.mPosed;
+        if(posed) {
+            resetBoneMixer(asset);
+        }
+        return posed;
+    }
+
+    size_t numJoints = mixer.mJoints.size();
+    mixer.mTranslations.assign(numJoints, math::float3(0.0f));
+    mixer.mRotations.assign(numJoints, math::quatf(1.0f));
+    if(underlyingAnimated) {
+        for(size_t i = 0; i < numJoints; i++) {
+            auto current = transformManager.getTransform(transformManager.getInstance(mixer.mJoints[i]));
+            math::float3 scale;
+            gltfio::decomposeMatrix(mixer.mInverseRestTransforms[i] * current, &mixer.mTranslations[i], &mixer.mRotations[i], &scale);
+        }
+    }
+
+    mixer.blendLayers(sample.layerOffsets, sample.layerTranslations, sample.layerRotations);
+
+    bool moved = false;
+    for(size_t i = 0; i < numJoints; i++) {
+        auto jointInstance = transformManager.getInstance(mixer.mJoints[i]);
+        auto transform = mixer.mRestTransforms[i] * math::mat4f::translation(mixer.mTranslations[i]) * math::mat4f(mixer.mRotations[i]);
+        if(transformManager.getTransform(jointInstance) == transform) {
+            continue;
+        }
+        transformManager.setTransform(jointInstance, transform);
+        moved = true;
+    }
+    mixer.mPosed = true;
+    return moved;
+}
+
+///
+/// Returns every joint driven by [asset]'s bone mixer to its rest transform.
+///
+void AssetManager::resetBoneMixer(SceneAsset& asset) {
+    auto& mixer = asset.mBoneMixer;
+    TransformManager& transformManager = _engine->getTransformManager();
+    for(size_t i = 0; i < mixer.mJoints.size(); i++) {
+        transformManager.setTransform(transformManager.getInstance(mixer.mJoints[i]), mixer.mRestTransforms[i]);
     }
+    mixer.mPosed = false;
 }
 
 void AssetManager::remove(EntityId entityId) {
+    markDirty(RENDER_REASON_SCENE);
     const auto& pos = _entityIdLookup.find(entityId);
-    if(pos == _entityIdLookup.end()) {
+    if(pos == _entityIdLookup.end() || !_assets.contains(pos->second)) {
         Log("Couldn't find asset under specified entity id.");
         return;
     }
-    SceneAsset& sceneAsset = _assets[pos->second];
-
-    _assets.erase(std::remove_if(_assets.begin(), _assets.end(),
-                                           [=](SceneAsset& asset) { return asset.mAsset == sceneAsset.mAsset; }),
-                            _assets.end());
-    
-    _scene->removeEntities(sceneAsset.mAsset->getEntities(),
-                           sceneAsset.mAsset->getEntityCount());
-    
-    _scene->removeEntities(sceneAsset.mAsset->getLightEntities(),
-                           sceneAsset.mAsset->getLightEntityCount());
-    
-    _assetLoader->destroyAsset(sceneAsset.mAsset);
+    SceneAsset sceneAsset = _assets[pos->second];
+
+    // instanced assets share a FilamentAsset, so only remove this entry
+    _assets.remove(pos->second);
+    _entityIdLookup.erase(pos);
+    
+    _scene->removeEntities(sceneAsset.mInstance->getEntities(),
+                           sceneAsset.mInstance->getEntityCount());
+    
+    auto instanced = _instancedAssets.find(sceneAsset.mAsset);
+    if(instanced != _instancedAssets.end()) {
+        // gltfio can't destroy individual instances, so keep this one around to be handed out again by createInstance
+        // and only destroy the asset once every instance has been removed.
+        auto& state = instanced.value();
+        // an instance whose material was bound to its own texture (see loadTexture) would still point at that texture once
+        // it's destroyed below, so isn't handed out again
+        if(!sceneAsset.mTexture) {
+            state.recycled.push_back(sceneAsset.mInstance);
+        }
+        state.liveInstances--;
+        if(state.liveInstances == 0) {
+            _scene->removeEntities(sceneAsset.mAsset->getLightEntities(),
+                                   sceneAsset.mAsset->getLightEntityCount());
+            if(state.cached) {
+                // keep the template around for the next load of the same URI, unless we're over budget
+                evictAssetCache();
+            } else {
+                destroyAsset(sceneAsset.mAsset);
+                _instancedAssets.erase(instanced);
+            }
+        }
+    } else {
+        _scene->removeEntities(sceneAsset.mAsset->getLightEntities(),
+                               sceneAsset.mAsset->getLightEntityCount());
+        destroyAsset(sceneAsset.mAsset);
+    }
     
     if(sceneAsset.mTexture) {
         _engine->destroy(sceneAsset.mTexture);
@@ -410,17 +1763,34 @@ void AssetManager::remove(EntityId entityId) {
 
 }
 
+///
+/// Destroying an asset's renderables can move other entities' RenderableManager instances, so any instance cached across
+/// frames must be re-resolved once this has been called. Anything else cached against the asset pointer is dropped here too,
+/// since the allocator is free to hand the same address to the next asset.
+///
+void AssetManager::destroyAsset(const FilamentAsset* asset) {
+    _renderableGeneration++;
+    _geometryCache.erase(asset);
+    _bakedAnimationCache.erase(asset);
+    _assetLoader->destroyAsset(asset);
+}
+
 void AssetManager::setMorphTargetWeights(EntityId entityId, const char* const entityName, const float* const weights, const int count) {
-    const auto& pos = _entityIdLookup.find(entityId);
-    if(pos == _entityIdLookup.end()) {
+    setMorphTargetWeights(entityId, getNameId(entityName), weights, count);
+}
+
+void AssetManager::setMorphTargetWeights(EntityId entityId, uint32_t entityNameId, const float* const weights, const int count) {
+    markDirty(RENDER_REASON_ANIMATION);
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity.");
         return;
     }
-    auto& asset = _assets[pos->second];
+    auto& asset = *sceneAsset;
     
-    auto entity = findEntityByName(asset, entityName);
+    auto entity = findEntityByName(asset, entityNameId);
     if(!entity) {
-        Log("Warning: failed to find entity %s", entityName);
+        Log("Warning: failed to find entity %s", getNameForId(entityNameId));
         return;
     }
     
@@ -429,7 +1799,7 @@ void AssetManager::setMorphTargetWeights(EntityId entityId, const char* const en
     auto renderableInstance = rm.getInstance(entity);
 
     if(!renderableInstance.isValid()) {
-        Log("Warning: failed to find renderable instance for entity %s", entityName);
+        Log("Warning: failed to find renderable instance for entity %s", getNameForId(entityNameId));
         return;
     }
     
@@ -438,25 +1808,32 @@ void AssetManager::setMorphTargetWeights(EntityId entityId, const char* const en
                        weights,
                        count
                        );
+
+    // keep the morph animation's copy in sync, so these weights persist while it only updates its own targets
+    auto& buffer = asset.mMorphAnimationBuffer;
+    if(entity == buffer.mMeshTarget) {
+        std::copy_n(weights, std::min((size_t)count, buffer.mWeights.size()), buffer.mWeights.begin());
+    }
 }
 
-utils::Entity AssetManager::findEntityByName(SceneAsset asset, const char* entityName) {
-    utils::Entity entity;
-    for (size_t i = 0, c = asset.mAsset->getEntityCount(); i != c; ++i) {
-        auto entity = asset.mAsset->getEntities()[i];
-        auto nameInstance = _ncm->getInstance(entity);
-        if(!nameInstance.isValid()) {
-            continue;
-        }
-        auto name = _ncm->getName(nameInstance);
-        if(!name) {
-            continue;
-        }
-        if(strcmp(entityName,name)==0) {
-            return entity;
-        }
+utils::Entity AssetManager::findEntityByName(const SceneAsset& asset, const char* entityName) {
+    return findEntityByName(asset, getNameId(entityName));
+}
+
+utils::Entity AssetManager::findEntityByName(const SceneAsset& asset, uint32_t entityNameId) {
+    return asset.mNames->findEntity(entityNameId);
+}
+
+///
+/// Returns the index of the morph target named [morphTargetNameId] on the entity named [entityNameId], or -1 if there is no such morph target.
+///
+int AssetManager::getMorphTargetIndex(EntityId entityId, uint32_t entityNameId, uint32_t morphTargetNameId) {
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
+        Log("ERROR: asset not found for entity.");
+        return -1;
     }
-    return entity;
+    return sceneAsset->mNames->findMorphTarget(entityNameId, morphTargetNameId);
 }
 
 bool AssetManager::setMorphAnimationBuffer(
@@ -469,12 +1846,12 @@ bool AssetManager::setMorphAnimationBuffer(
                                            float frameLengthInMs) {
     std::lock_guard lock(_animationMutex);
 
-    const auto& pos = _entityIdLookup.find(entityId);
-    if(pos == _entityIdLookup.end()) {
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity.");
         return false;
     }
-    auto& asset = _assets[pos->second];
+    auto& asset = *sceneAsset;
     
     auto entity = findEntityByName(asset, entityName);
     if(!entity) {
@@ -482,6 +1859,33 @@ bool AssetManager::setMorphAnimationBuffer(
         return false;
     }
     
+    RenderableManager& rm = _engine->getRenderableManager();
+    auto renderable = rm.getInstance(entity);
+    if(!renderable.isValid()) {
+        Log("Warning: failed to find renderable instance for entity %s", entityName);
+        return false;
+    }
+    int morphTargetCount = (int)rm.getMorphTargetCount(renderable);
+    int minMorphIndex = morphTargetCount;
+    int maxMorphIndex = -1;
+    for(int i = 0; i < numMorphTargets; i++) {
+        if(morphIndices[i] < 0 || morphIndices[i] >= morphTargetCount) {
+            Log("ERROR: morph index %d out of range for entity %s (%d morph targets)", morphIndices[i], entityName, morphTargetCount);
+            return false;
+        }
+        minMorphIndex = std::min(minMorphIndex, morphIndices[i]);
+        maxMorphIndex = std::max(maxMorphIndex, morphIndices[i]);
+    }
+
+    auto& buffer = asset.mMorphAnimationBuffer;
+    if(buffer.mMeshTarget != entity || buffer.mWeights.size() != (size_t)morphTargetCount) {
+        buffer.mWeights.assign(morphTargetCount, 0.0f);
+    }
+    buffer.mRenderable = renderable;
+    buffer.mRenderableGeneration = _renderableGeneration;
+    buffer.mMinMorphIndex = minMorphIndex;
+    buffer.mMaxMorphIndex = maxMorphIndex;
+
     asset.mMorphAnimationBuffer.mMeshTarget = entity;
     asset.mMorphAnimationBuffer.mFrameData.clear();
     asset.mMorphAnimationBuffer.mFrameData.insert(
@@ -504,14 +1908,19 @@ bool AssetManager::setMorphAnimationBuffer(
 }
 
 bool AssetManager::setMaterialColor(EntityId entityId, const char* meshName, int materialIndex, const float r, const float g, const float b, const float a) {
+    return setMaterialColor(entityId, getNameId(meshName), materialIndex, r, g, b, a);
+}
+
+bool AssetManager::setMaterialColor(EntityId entityId, uint32_t meshNameId, int materialIndex, const float r, const float g, const float b, const float a) {
+    markDirty(RENDER_REASON_MATERIAL);
     
-    const auto& pos = _entityIdLookup.find(entityId);
-    if(pos == _entityIdLookup.end()) {
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity.");
         return false;
     }
-    auto& asset = _assets[pos->second];
-    auto entity = findEntityByName(asset, meshName);
+    auto& asset = *sceneAsset;
+    auto entity = findEntityByName(asset, meshNameId);
     
     RenderableManager& rm = _engine->getRenderableManager();
     
@@ -544,15 +1953,29 @@ bool AssetManager::setBoneAnimationBuffer(
                                           const char** const meshNames,
                                           int numMeshTargets,
                                           float frameLengthInMs) {
+    // only the rotations are played back (see sampleAnimations)
+    return setBoneAnimationBuffer(entityId, compressBoneAnimation(frameData, numFrames, numBones, false), boneNames, meshNames,
+                                  numMeshTargets, frameLengthInMs);
+}
+
+bool AssetManager::setBoneAnimationBuffer(
+                                          EntityId entityId,
+                                          CompressedBoneClip&& frames,
+                                          const char** const boneNames,
+                                          const char** const meshNames,
+                                          int numMeshTargets,
+                                          float frameLengthInMs) {
     std::lock_guard lock(_animationMutex);
+    int numFrames = frames.getNumFrames();
+    int numBones = frames.getNumBones();
 
-    const auto& pos = _entityIdLookup.find(entityId);
-    if(pos == _entityIdLookup.end()) {
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity.");
         return false;
     }
-    auto& asset = _assets[pos->second];
-    auto filamentInstance = asset.mAsset->getInstance();
+    auto& asset = *sceneAsset;
+    auto filamentInstance = asset.mInstance;
     
     size_t skinCount = filamentInstance->getSkinCount();
     
@@ -564,7 +1987,6 @@ bool AssetManager::setBoneAnimationBuffer(
     
     int skinIndex = 0;
     const utils::Entity* joints = filamentInstance->getJointsAt(skinIndex);
-    size_t numJoints = filamentInstance->getJointCountAt(skinIndex);
     
     BoneAnimationBuffer& animationBuffer = asset.mBoneAnimationBuffer;
     
@@ -581,32 +2003,20 @@ bool AssetManager::setBoneAnimationBuffer(
     animationBuffer.mBaseTransforms.resize(numBones);
     
     for(int i = 0; i < numBones; i++) {
-        for(int j = 0; j < numJoints; j++) {
-            const char* jointName = _ncm->getName(_ncm->getInstance(joints[j]));
-            if(strcmp(jointName, boneNames[i]) == 0) {
-                auto jointInstance = transformManager.getInstance(joints[j]);
-                // auto currentXform = ;
-                auto baseTransform = transformManager.getTransform(jointInstance); // inverse(filamentInstance->getInverseBindMatricesAt(skinIndex)[j]);
-                animationBuffer.mBaseTransforms[i] = baseTransform;
-                animationBuffer.mBones[i] = j;
-                break;
-            }
+        int j = asset.mNames->findJoint(getNameId(boneNames[i]));
+        if(j < 0) {
+            Log("Failed to find bone %s", boneNames[i]);
+            animationBuffer.mBones.clear();
+            animationBuffer.mBaseTransforms.clear();
+            return false;
         }
+        auto jointInstance = transformManager.getInstance(joints[j]);
+        auto baseTransform = transformManager.getTransform(jointInstance); // inverse(filamentInstance->getInverseBindMatricesAt(skinIndex)[j]);
+        animationBuffer.mBaseTransforms[i] = baseTransform;
+        animationBuffer.mBones[i] = j;
     }
     
-    if(animationBuffer.mBones.size() != numBones) {
-        Log("Failed to find one or more bone indices");
-        return false;
-    }
-    
-    animationBuffer.mFrameData.clear();
-    // 7 == locX, locY, locZ, rotW, rotX, rotY, rotZ
-    animationBuffer.mFrameData.resize(numFrames * numBones * 7);
-    animationBuffer.mFrameData.insert(
-                                      animationBuffer.mFrameData.begin(),
-                                      frameData,
-                                      frameData + numFrames * numBones * 7
-                                      );
+    animationBuffer.mFrames = std::move(frames);
     
     animationBuffer.mFrameLengthInMs = frameLengthInMs;
     animationBuffer.mNumFrames = numFrames;
@@ -632,20 +2042,298 @@ bool AssetManager::setBoneAnimationBuffer(
     return true;
 }
 
+///
+/// Adds a clip to [entityId]'s bone mixer, animating the nodes named [boneNames]; see BoneClip for the layout of [frameData].
+/// Nodes are put into the mixer (with their current local transform as their rest transform) the first time a clip uses them.
+/// Returns the clip index to pass to addBoneAnimationLayer, or -1 on error.
+///
+int AssetManager::addBoneAnimationClip(EntityId entityId, const float* const frameData, int numFrames, int numBones, const char** const boneNames, float frameLengthInMs) {
+    return addBoneAnimationClip(entityId, compressBoneAnimation(frameData, numFrames, numBones, true), boneNames, frameLengthInMs);
+}
+
+int AssetManager::addBoneAnimationClip(EntityId entityId, CompressedBoneClip&& frames, const char** const boneNames, float frameLengthInMs) {
+    std::lock_guard lock(_animationMutex);
+    int numFrames = frames.getNumFrames();
+    int numBones = frames.getNumBones();
+
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
+        Log("ERROR: asset not found for entity.");
+        return -1;
+    }
+    auto& asset = *sceneAsset;
+    auto& mixer = asset.mBoneMixer;
+
+    if(numFrames <= 0 || numBones <= 0 || frameLengthInMs <= 0) {
+        Log("ERROR: bone animation clip needs at least one frame and bone, and a positive frame length.");
+        return -1;
+    }
+
+    BoneClip clip;
+    clip.mJoints.resize(numBones);
+    for(int i = 0; i < numBones; i++) {
+        auto entity = findEntityByName(asset, boneNames[i]);
+        if(!entity) {
+            Log("Failed to find bone %s", boneNames[i]);
+            return -1;
+        }
+        auto it = std::find(mixer.mJoints.begin(), mixer.mJoints.end(), entity);
+        clip.mJoints[i] = (uint32_t)(it - mixer.mJoints.begin());
+    }
+
+    TransformManager& transformManager = _engine->getTransformManager();
+    for(int i = 0; i < numBones; i++) {
+        if(clip.mJoints[i] < mixer.mJoints.size()) {
+            continue;
+        }
+        auto entity = findEntityByName(asset, boneNames[i]);
+        auto restTransform = transformManager.getTransform(transformManager.getInstance(entity));
+        clip.mJoints[i] = (uint32_t)mixer.mJoints.size();
+        mixer.mJoints.push_back(entity);
+        mixer.mRestTransforms.push_back(restTransform);
+        mixer.mInverseRestTransforms.push_back(inverse(restTransform));
+        // masks only include the joints they were set with
+        for(auto& layer : mixer.mLayers) {
+            if(!layer.mMask.empty()) {
+                layer.mMask.push_back(0.0f);
+            }
+        }
+    }
+
+    clip.mFrameLengthInMs = frameLengthInMs;
+    clip.mDuration = (frameLengthInMs * numFrames) / 1000.0f;
+    clip.mFrames = std::move(frames);
+    mixer.mClips.push_back(std::move(clip));
+    return (int)mixer.mClips.size() - 1;
+}
+
+///
+/// Starts playing [clipIndex] as a new bone mixer layer on [entityId], applied after any existing layers.
+/// Returns the layer index, or -1 on error.
+///
+int AssetManager::addBoneAnimationLayer(EntityId entityId, int clipIndex, float weight, bool additive, bool loop) {
+    markDirty(RENDER_REASON_ANIMATION);
+    std::lock_guard lock(_animationMutex);
+
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
+        Log("ERROR: asset not found for entity.");
+        return -1;
+    }
+    auto& mixer = sceneAsset->mBoneMixer;
+    if(clipIndex < 0 || clipIndex >= static_cast<int>(mixer.mClips.size())) {
+        Log("ERROR: bone animation clip index %d out of range", clipIndex);
+        return -1;
+    }
+
+    BoneLayer layer;
+    layer.mClip = clipIndex;
+    layer.mWeight = weight;
+    layer.mAdditive = additive;
+    layer.mLoop = loop;
+    layer.mStart = high_resolution_clock::now();
+
+    for(size_t i = 0; i < mixer.mLayers.size(); i++) {
+        if(mixer.mLayers[i].mClip < 0) {
+            mixer.mDirty = true;
+            mixer.mLayers[i] = std::move(layer);
+            return (int)i;
+        }
+    }
+    mixer.mDirty = true;
+    mixer.mLayers.push_back(std::move(layer));
+    return (int)mixer.mLayers.size() - 1;
+}
+
+static BoneLayer* findBoneLayer(BoneMixer& mixer, int layerIndex) {
+    if(layerIndex < 0 || layerIndex >= static_cast<int>(mixer.mLayers.size()) || mixer.mLayers[layerIndex].mClip < 0) {
+        Log("ERROR: bone animation layer %d not found", layerIndex);
+        return nullptr;
+    }
+    return &mixer.mLayers[layerIndex];
+}
+
+bool AssetManager::setBoneAnimationLayerWeight(EntityId entityId, int layerIndex, float weight) {
+    markDirty(RENDER_REASON_ANIMATION);
+    std::lock_guard lock(_animationMutex);
+
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
+        Log("ERROR: asset not found for entity.");
+        return false;
+    }
+    auto& mixer = sceneAsset->mBoneMixer;
+    auto layer = findBoneLayer(mixer, layerIndex);
+    if(!layer) {
+        return false;
+    }
+    layer->mWeight = weight;
+    mixer.mDirty = true;
+    return true;
+}
+
+///
+/// Restricts a bone mixer layer to the nodes named [boneNames], scaling its weight for each by [weights] (or 1 if null).
+/// Nodes not listed (including those added to the mixer later) aren't affected by the layer. A [count] of 0 removes the mask.
+///
+bool AssetManager::setBoneAnimationLayerMask(EntityId entityId, int layerIndex, const char** const boneNames, const float* const weights, int count) {
+    markDirty(RENDER_REASON_ANIMATION);
+    std::lock_guard lock(_animationMutex);
+
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
+        Log("ERROR: asset not found for entity.");
+        return false;
+    }
+    auto& asset = *sceneAsset;
+    auto& mixer = asset.mBoneMixer;
+    auto layer = findBoneLayer(mixer, layerIndex);
+    if(!layer) {
+        return false;
+    }
+
+    vector<float> mask;
+    if(count > 0) {
+        mask.assign(mixer.mJoints.size(), 0.0f);
+    }
+    for(int i = 0; i < count; i++) {
+        auto entity = findEntityByName(asset, boneNames[i]);
+        auto it = std::find(mixer.mJoints.begin(), mixer.mJoints.end(), entity);
+        if(!entity || it == mixer.mJoints.end()) {
+            Log("Bone %s is not animated by any bone animation clip", boneNames[i]);
+            return false;
+        }
+        mask[it - mixer.mJoints.begin()] = weights ? weights[i] : 1.0f;
+    }
+    layer->mMask = std::move(mask);
+    mixer.mDirty = true;
+    return true;
+}
+
+///
+/// Stops a bone mixer layer. Its index may be reused by the next layer added.
+///
+bool AssetManager::removeBoneAnimationLayer(EntityId entityId, int layerIndex) {
+    markDirty(RENDER_REASON_ANIMATION);
+    std::lock_guard lock(_animationMutex);
+
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
+        Log("ERROR: asset not found for entity.");
+        return false;
+    }
+    auto& mixer = sceneAsset->mBoneMixer;
+    auto layer = findBoneLayer(mixer, layerIndex);
+    if(!layer) {
+        return false;
+    }
+    *layer = BoneLayer();
+    while(!mixer.mLayers.empty() && mixer.mLayers.back().mClip < 0) {
+        mixer.mLayers.pop_back();
+    }
+    mixer.mDirty = true;
+    return true;
+}
+
+///
+/// Compresses 7 floats per bone per frame (see BoneClip) with the current tolerances, ready to pass to setBoneAnimationBuffer or
+/// addBoneAnimationClip. Doesn't touch any asset, so can be called from any thread. This is the expensive part of uploading a
+/// bone animation (every frame of every bone is quantized, and with a non-zero tolerance each track is searched for the keyframes
+/// it can drop), so callers on the render thread should prefer to compress before handing over.
+///
+CompressedBoneClip AssetManager::compressBoneAnimation(const float* const frameData, int numFrames, int numBones, bool withTranslations) {
+    TRACE_FUNCTION("animation");
+    float rotationTolerance, translationTolerance;
+    {
+        std::lock_guard lock(_animationMutex);
+        rotationTolerance = _boneRotationTolerance;
+        translationTolerance = _boneTranslationTolerance;
+    }
+    CompressedBoneClip frames;
+    if(withTranslations) {
+        frames.compress(frameData, numFrames, numBones, rotationTolerance, translationTolerance);
+    } else {
+        frames.compressRotations(frameData, numFrames, numBones, rotationTolerance);
+    }
+    return frames;
+}
+
+///
+/// Sets the error allowed when compressing bone animations uploaded from now on. 0 (the default) keeps every keyframe, so the only
+/// loss is quantization (roughly 1e-4 radians, and 1/65535 of each translation track's range).
+///
+void AssetManager::setBoneAnimationTolerance(float rotationTolerance, float translationTolerance) {
+    std::lock_guard lock(_animationMutex);
+    _boneRotationTolerance = std::max(rotationTolerance, 0.0f);
+    _boneTranslationTolerance = std::max(translationTolerance, 0.0f);
+}
+
+///
+/// Reports the size and accuracy of [entityId]'s bone animation buffer and bone mixer clips.
+///
+bool AssetManager::getBoneAnimationStats(EntityId entityId, BoneAnimationStats* out) {
+    std::lock_guard lock(_animationMutex);
+    *out = {};
+
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
+        Log("ERROR: asset not found for entity.");
+        return false;
+    }
+    const auto& asset = *sceneAsset;
+
+    auto add = [&](const CompressedBoneClip& clip) {
+        if(clip.getNumFrames() == 0) {
+            return;
+        }
+        const auto& stats = clip.getStats();
+        out->clipCount++;
+        out->uncompressedBytes += stats.uncompressedBytes;
+        out->compressedBytes += stats.compressedBytes;
+        out->maxRotationError = std::max(out->maxRotationError, stats.maxRotationError);
+        out->maxTranslationError = std::max(out->maxTranslationError, stats.maxTranslationError);
+    };
+    add(asset.mBoneAnimationBuffer.mFrames);
+    for(const auto& clip : asset.mBoneMixer.mClips) {
+        add(clip.mFrames);
+    }
+    return true;
+}
+
+///
+/// Removes every bone mixer layer and clip from [entityId], returning the nodes they animated to rest.
+///
+void AssetManager::clearBoneAnimationLayers(EntityId entityId) {
+    markDirty(RENDER_REASON_ANIMATION);
+    std::lock_guard lock(_animationMutex);
+
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
+        Log("ERROR: asset not found for entity.");
+        return;
+    }
+    auto& asset = *sceneAsset;
+    if(asset.mBoneMixer.mPosed) {
+        resetBoneMixer(asset);
+        asset.mAnimator->updateBoneMatrices();
+    }
+    asset.mBoneMixer = BoneMixer();
+}
 
 void AssetManager::playAnimation(EntityId e, int index, bool loop, bool reverse, bool replaceActive, float crossfade) {
+    markDirty(RENDER_REASON_ANIMATION);
     std::lock_guard lock(_animationMutex);
 
     if(index < 0) {
         Log("ERROR: glTF animation index must be greater than zero.");
         return;
     }
-    const auto& pos = _entityIdLookup.find(e);
-    if(pos == _entityIdLookup.end()) {
+    auto* sceneAsset = getSceneAsset(e);
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity.");
         return;
     }
-    auto& asset = _assets[pos->second];
+    auto& asset = *sceneAsset;
     
     if(replaceActive) {
         vector<int> active;
@@ -659,7 +2347,7 @@ void AssetManager::playAnimation(EntityId e, int index, bool loop, bool reverse,
             asset.fadeGltfAnimationIndex = last.gltfIndex;
             asset.fadeDuration = crossfade;
             auto now = high_resolution_clock::now();
-            auto elapsed = float(std::chrono::duration_cast<std::chrono::milliseconds>(now - last.mStart).count()) / 1000.0f;
+            auto elapsed = std::chrono::duration<float>(now - last.mStart).count();
             asset.fadeOutAnimationStart = elapsed;
             for(int j = active.size() - 1; j >= 0; j--) {
                 asset.mAnimations.erase(asset.mAnimations.begin() + active[j]);
@@ -690,14 +2378,15 @@ void AssetManager::playAnimation(EntityId e, int index, bool loop, bool reverse,
 }
 
 void AssetManager::stopAnimation(EntityId entityId, int index) {
+    markDirty(RENDER_REASON_ANIMATION);
     std::lock_guard lock(_animationMutex);
 
-    const auto& pos = _entityIdLookup.find(entityId);
-    if(pos == _entityIdLookup.end()) {
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity.");
         return;
     }
-    auto& asset = _assets[pos->second];
+    auto& asset = *sceneAsset;
     
     asset.mAnimations.erase(std::remove_if(asset.mAnimations.begin(),
                                            asset.mAnimations.end(),
@@ -707,13 +2396,15 @@ void AssetManager::stopAnimation(EntityId entityId, int index) {
 }
 
 void AssetManager::loadTexture(EntityId entity, const char* resourcePath, int renderableIndex) {
+    TRACE_FUNCTION("texture");
+    markDirty(RENDER_REASON_MATERIAL);
     
-    const auto& pos = _entityIdLookup.find(entity);
-    if(pos == _entityIdLookup.end()) {
+    auto* sceneAsset = getSceneAsset(entity);
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity.");
         return;
     }
-    auto& asset = _assets[pos->second];
+    auto& asset = *sceneAsset;
     
     Log("Loading texture at %s for renderableIndex %d", resourcePath, renderableIndex);
     
@@ -763,8 +2454,8 @@ void AssetManager::loadTexture(EntityId entity, const char* resourcePath, int re
                                           Texture::Type::FLOAT, freeCallback);
     
     asset.mTexture->setImage(*_engine, 0, std::move(buffer));
-    MaterialInstance* const* inst = asset.mAsset->getInstance()->getMaterialInstances();
-    size_t mic =  asset.mAsset->getInstance()->getMaterialInstanceCount();
+    MaterialInstance* const* inst = asset.mInstance->getMaterialInstances();
+    size_t mic =  asset.mInstance->getMaterialInstanceCount();
     Log("Material instance count : %d", mic);
     
     auto sampler = TextureSampler();
@@ -778,42 +2469,43 @@ void AssetManager::loadTexture(EntityId entity, const char* resourcePath, int re
 
 
 void AssetManager::setAnimationFrame(EntityId entity, int animationIndex, int animationFrame) {
-    const auto& pos = _entityIdLookup.find(entity);
-    if(pos == _entityIdLookup.end()) {
+    markDirty(RENDER_REASON_ANIMATION);
+    auto* sceneAsset = getSceneAsset(entity);
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity.");
         return;
     }
-    auto& asset = _assets[pos->second];
+    auto& asset = *sceneAsset;
     auto offset = 60 * animationFrame * 1000; // TODO - don't hardcore 60fps framerate
     asset.mAnimator->applyAnimation(animationIndex, offset);
     asset.mAnimator->updateBoneMatrices();
 }
 
 float AssetManager::getAnimationDuration(EntityId entity, int animationIndex) {
-    const auto& pos = _entityIdLookup.find(entity);
+    auto* sceneAsset = getSceneAsset(entity);
     
     unique_ptr<vector<string>> names = make_unique<vector<string>>();
     
-    if(pos == _entityIdLookup.end()) {
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity id.");
         return -1.0f;
     }
     
-    auto& asset = _assets[pos->second];
+    auto& asset = *sceneAsset;
     return asset.mAnimator->getAnimationDuration(animationIndex);
 }
 
 unique_ptr<vector<string>> AssetManager::getAnimationNames(EntityId entity) {
     
-    const auto& pos = _entityIdLookup.find(entity);
+    auto* sceneAsset = getSceneAsset(entity);
     
     unique_ptr<vector<string>> names = make_unique<vector<string>>();
     
-    if(pos == _entityIdLookup.end()) {
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity id.");
         return names;
     }
-    auto& asset = _assets[pos->second];
+    auto& asset = *sceneAsset;
     
     size_t count = asset.mAnimator->getAnimationCount();
     
@@ -829,43 +2521,37 @@ unique_ptr<vector<string>> AssetManager::getMorphTargetNames(EntityId entity, co
     
     unique_ptr<vector<string>> names = make_unique<vector<string>>();
     
-    const auto& pos = _entityIdLookup.find(entity);
-    if(pos == _entityIdLookup.end()) {
+    auto* sceneAsset = getSceneAsset(entity);
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity.");
         return names;
     }
-    auto& asset = _assets[pos->second];
-    
-    const utils::Entity *entities = asset.mAsset->getEntities();
+    auto& asset = *sceneAsset;
     
-    for (int i = 0; i < asset.mAsset->getEntityCount(); i++) {
-        utils::Entity e = entities[i];
-        auto inst = _ncm->getInstance(e);
-        const char *name = _ncm->getName(inst);
-        
-        if (name && strcmp(name, meshName) == 0) {
-            size_t count = asset.mAsset->getMorphTargetCountAt(e);
-            for (int j = 0; j < count; j++) {
-                const char *morphName = asset.mAsset->getMorphTargetNameAt(e, j);
-                names->push_back(morphName);
-            }
-            break;
-        }
+    auto e = findEntityByName(asset, meshName);
+    if(e.isNull()) {
+        return names;
+    }
+    size_t count = asset.mAsset->getMorphTargetCountAt(e);
+    for (int j = 0; j < count; j++) {
+        const char *morphName = asset.mAsset->getMorphTargetNameAt(e, j);
+        names->push_back(morphName);
     }
     return names;
 }
 
 void AssetManager::transformToUnitCube(EntityId entity) {
-    const auto& pos = _entityIdLookup.find(entity);
-    if(pos == _entityIdLookup.end()) {
+    markDirty(RENDER_REASON_TRANSFORM);
+    auto* sceneAsset = getSceneAsset(entity);
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity.");
         return;
     }
-    auto& asset = _assets[pos->second];
+    auto& asset = *sceneAsset;
     
     Log("Transforming asset to unit cube.");
     auto &tm = _engine->getTransformManager();
-    FilamentInstance* inst = asset.mAsset->getInstance();
+    FilamentInstance* inst = asset.mInstance;
     auto aabb = inst->getBoundingBox();
     auto center = aabb.center();
     auto halfExtent = aabb.extent();
@@ -878,84 +2564,283 @@ void AssetManager::transformToUnitCube(EntityId entity) {
 
 void AssetManager::updateTransform(SceneAsset& asset) {
     auto &tm = _engine->getTransformManager();
-    auto transform =
-    asset.mPosition * asset.mRotation * math::mat4f::scaling(asset.mScale);
-    tm.setTransform(tm.getInstance(asset.mAsset->getRoot()), transform);
+    tm.setTransform(tm.getInstance(asset.mInstance->getRoot()), composeTransform(asset));
+}
+
+///
+/// Equivalent to mPosition * mRotation * scaling(mScale), but since mPosition is a pure translation and mRotation a pure rotation,
+/// we can just scale the rotation's basis vectors and drop in the translation rather than doing two full matrix multiplies.
+///
+math::mat4f AssetManager::composeTransform(const SceneAsset& asset) {
+    math::mat4f transform = asset.mRotation;
+    transform[0] *= asset.mScale;
+    transform[1] *= asset.mScale;
+    transform[2] *= asset.mScale;
+    transform[3] = asset.mPosition[3];
+    return transform;
+}
+
+///
+/// Applies position/rotation/scale to [count] assets in a single TransformManager transaction (so world transforms are only
+/// propagated once, at commit, rather than after every asset).
+/// [positions] is packed xyz (3 floats per asset), [rotations] is packed quaternions in xyzw order (4 floats per asset)
+/// and [scales] is a uniform scale (1 float per asset). Pass nullptr for any of these to leave that component unchanged.
+/// Returns the number of assets that were updated.
+///
+int AssetManager::setTransforms(const EntityId* entities, const float* positions, const float* rotations, const float* scales, int count) {
+    TRACE_FUNCTION("transform");
+    markDirty(RENDER_REASON_TRANSFORM);
+    auto &tm = _engine->getTransformManager();
+    int updated = 0;
+    tm.openLocalTransformTransaction();
+    for(int i = 0; i < count; i++) {
+        auto* sceneAsset = getSceneAsset(entities[i]);
+        if(!sceneAsset) {
+            continue;
+        }
+        auto& asset = *sceneAsset;
+        if(positions) {
+            const float* p = positions + i * 3;
+            asset.mPosition = math::mat4f::translation(math::float3(p[0], p[1], p[2]));
+        }
+        if(rotations) {
+            const float* q = rotations + i * 4;
+            asset.mRotation = math::mat4f(math::quatf(q[3], q[0], q[1], q[2]));
+        }
+        if(scales) {
+            asset.mScale = scales[i];
+        }
+        tm.setTransform(tm.getInstance(asset.mInstance->getRoot()), composeTransform(asset));
+        updated++;
+    }
+    tm.commitLocalTransformTransaction();
+    if(updated != count) {
+        Log("WARNING: %d of %d assets could not be found", count - updated, count);
+    }
+    return updated;
+}
+
+///
+/// Sets the transform of [count] assets from packed 4x3 affine matrices (12 floats per asset; the first three columns of a
+/// column-major 4x4 matrix followed by the translation, i.e. the implicit last row is 0,0,0,1), in a single TransformManager transaction.
+/// Returns the number of assets that were updated.
+///
+int AssetManager::setTransforms(const EntityId* entities, const float* matrices, int count) {
+    TRACE_FUNCTION("transform");
+    markDirty(RENDER_REASON_TRANSFORM);
+    auto &tm = _engine->getTransformManager();
+    int updated = 0;
+    tm.openLocalTransformTransaction();
+    for(int i = 0; i < count; i++) {
+        auto* sceneAsset = getSceneAsset(entities[i]);
+        if(!sceneAsset) {
+            continue;
+        }
+        auto& asset = *sceneAsset;
+        const float* m = matrices + i * 12;
+        math::mat4f transform(
+            math::float4(m[0], m[1], m[2], 0.0f),
+            math::float4(m[3], m[4], m[5], 0.0f),
+            math::float4(m[6], m[7], m[8], 0.0f),
+            math::float4(m[9], m[10], m[11], 1.0f));
+        tm.setTransform(tm.getInstance(asset.mInstance->getRoot()), transform);
+        updated++;
+    }
+    tm.commitLocalTransformTransaction();
+    if(updated != count) {
+        Log("WARNING: %d of %d assets could not be found", count - updated, count);
+    }
+    return updated;
 }
 
 void AssetManager::setScale(EntityId entity, float scale) {
-    const auto& pos = _entityIdLookup.find(entity);
-    if(pos == _entityIdLookup.end()) {
+    markDirty(RENDER_REASON_TRANSFORM);
+    auto* sceneAsset = getSceneAsset(entity);
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity.");
         return;
     }
-    auto& asset = _assets[pos->second];
+    auto& asset = *sceneAsset;
     asset.mScale = scale;
     updateTransform(asset);
 }
 
 void AssetManager::setPosition(EntityId entity, float x, float y, float z) {
-    const auto& pos = _entityIdLookup.find(entity);
-    if(pos == _entityIdLookup.end()) {
+    markDirty(RENDER_REASON_TRANSFORM);
+    auto* sceneAsset = getSceneAsset(entity);
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity.");
         return;
     }
-    auto& asset = _assets[pos->second];
+    auto& asset = *sceneAsset;
     asset.mPosition = math::mat4f::translation(math::float3(x,y,z));
     updateTransform(asset);
 }
 
 void AssetManager::setRotation(EntityId entity, float rads, float x, float y, float z) {
-    const auto& pos = _entityIdLookup.find(entity);
-    if(pos == _entityIdLookup.end()) {
+    markDirty(RENDER_REASON_TRANSFORM);
+    auto* sceneAsset = getSceneAsset(entity);
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity.");
         return;
     }
-    auto& asset = _assets[pos->second];
+    auto& asset = *sceneAsset;
     asset.mRotation = math::mat4f::rotation(rads, math::float3(x,y,z));
     updateTransform(asset);
 }
 
+void AssetManager::setTransform(EntityId entity, const math::mat4f& transform) {
+    markDirty(RENDER_REASON_TRANSFORM);
+    auto* sceneAsset = getSceneAsset(entity);
+    if(!sceneAsset) {
+        Log("ERROR: asset not found for entity.");
+        return;
+    }
+    auto& asset = *sceneAsset;
+    auto &tm = _engine->getTransformManager();
+    tm.setTransform(tm.getInstance(asset.mInstance->getRoot()), transform);
+}
+
 const utils::Entity *AssetManager::getCameraEntities(EntityId entity) {
-    const auto& pos = _entityIdLookup.find(entity);
-    if(pos == _entityIdLookup.end()) {
+    auto* sceneAsset = getSceneAsset(entity);
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity.");
         return nullptr;
     }
-    auto& asset = _assets[pos->second];
+    auto& asset = *sceneAsset;
     return asset.mAsset->getCameraEntities();
 }
 
 size_t AssetManager::getCameraEntityCount(EntityId entity) {
-    const auto& pos = _entityIdLookup.find(entity);
-    if(pos == _entityIdLookup.end()) {
+    auto* sceneAsset = getSceneAsset(entity);
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity.");
         return 0;
     }
-    auto& asset = _assets[pos->second];
+    auto& asset = *sceneAsset;
     return asset.mAsset->getCameraEntityCount();
 }
 
 const utils::Entity* AssetManager::getLightEntities(EntityId entity) const noexcept { 
-    const auto& pos = _entityIdLookup.find(entity);
-    if(pos == _entityIdLookup.end()) {
+    auto* sceneAsset = getSceneAsset(entity);
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity.");
         return nullptr;
     }
-    auto& asset = _assets[pos->second];
+    auto& asset = *sceneAsset;
     return asset.mAsset->getLightEntities();
 }
 
 size_t AssetManager::getLightEntityCount(EntityId entity) const noexcept {
-    const auto& pos = _entityIdLookup.find(entity);
-    if(pos == _entityIdLookup.end()) {
+    auto* sceneAsset = getSceneAsset(entity);
+    if(!sceneAsset) {
         Log("ERROR: asset not found for entity.");
         return 0;
     }
-    auto& asset = _assets[pos->second];
+    auto& asset = *sceneAsset;
     return asset.mAsset->getLightEntityCount();
 }
 
+// appends little-endian, unaligned values (see ASSET_DESCRIPTION_MAGIC)
+struct DescriptionWriter {
+    vector<uint8_t>& out;
+
+    template <typename T>
+    void write(T value) {
+        auto offset = out.size();
+        out.resize(offset + sizeof(T));
+        memcpy(out.data() + offset, &value, sizeof(T));
+    }
+
+    void writeString(const char* str) {
+        size_t length = str ? std::min<size_t>(strlen(str), UINT16_MAX) : 0;
+        write<uint16_t>(length);
+        out.insert(out.end(), (const uint8_t*)str, (const uint8_t*)str + length);
+    }
+};
+
+///
+/// Serializes the node hierarchy, morph target names, animations and skins for [entityId] into [out] in a single pass
+/// (see ASSET_DESCRIPTION_MAGIC in FlutterFilamentApi.h for the layout).
+/// Returns false if the asset doesn't exist.
+///
+bool AssetManager::describe(EntityId entityId, vector<uint8_t>& out) {
+    TRACE_FUNCTION("api");
+    auto* sceneAsset = getSceneAsset(entityId);
+    if(!sceneAsset) {
+        Log("ERROR: asset not found for entity.");
+        return false;
+    }
+    auto& asset = *sceneAsset;
+    auto instance = asset.mInstance;
+    auto& tm = _engine->getTransformManager();
+    auto& rm = _engine->getRenderableManager();
+    auto& lm = _engine->getLightManager();
+
+    const utils::Entity* entities = instance->getEntities();
+    size_t entityCount = instance->getEntityCount();
+    tsl::robin_map<uint32_t, int32_t> nodeIndices;
+    for(size_t i = 0; i < entityCount; i++) {
+        nodeIndices.emplace(entities[i].getId(), (int32_t)i);
+    }
+    auto nodeIndex = [&](utils::Entity entity) -> int32_t {
+        auto it = nodeIndices.find(entity.getId());
+        return it == nodeIndices.end() ? -1 : it->second;
+    };
+
+    size_t animationCount = asset.mAnimator->getAnimationCount();
+    size_t skinCount = instance->getSkinCount();
+
+    out.clear();
+    out.reserve(16 + entityCount * 32);
+    DescriptionWriter writer { out };
+    writer.write<uint32_t>(ASSET_DESCRIPTION_MAGIC);
+    writer.write<uint16_t>(ASSET_DESCRIPTION_VERSION);
+    writer.write<uint16_t>(0);
+    writer.write<uint32_t>(entityCount);
+    writer.write<uint32_t>(animationCount);
+    writer.write<uint32_t>(skinCount);
+
+    for(size_t i = 0; i < entityCount; i++) {
+        auto entity = entities[i];
+        writer.writeString(_ncm->getName(_ncm->getInstance(entity)));
+        auto transform = tm.getInstance(entity);
+        writer.write<int32_t>(transform.isValid() ? nodeIndex(tm.getParent(transform)) : -1);
+        uint8_t flags = 0;
+        if(rm.hasComponent(entity)) {
+            flags |= ASSET_NODE_RENDERABLE;
+        }
+        if(lm.hasComponent(entity)) {
+            flags |= ASSET_NODE_LIGHT;
+        }
+        if(_engine->getCameraComponent(entity)) {
+            flags |= ASSET_NODE_CAMERA;
+        }
+        writer.write<uint8_t>(flags);
+        size_t morphTargetCount = std::min<size_t>(asset.mAsset->getMorphTargetCountAt(entity), UINT16_MAX);
+        writer.write<uint16_t>(morphTargetCount);
+        for(size_t j = 0; j < morphTargetCount; j++) {
+            writer.writeString(asset.mAsset->getMorphTargetNameAt(entity, j));
+        }
+    }
+
+    for(size_t i = 0; i < animationCount; i++) {
+        writer.writeString(asset.mAnimator->getAnimationName(i));
+        writer.write<float>(asset.mAnimator->getAnimationDuration(i));
+    }
+
+    for(size_t i = 0; i < skinCount; i++) {
+        writer.writeString(instance->getSkinNameAt(i));
+        size_t jointCount = instance->getJointCountAt(i);
+        const utils::Entity* joints = instance->getJointsAt(i);
+        writer.write<uint32_t>(jointCount);
+        for(size_t j = 0; j < jointCount; j++) {
+            writer.write<int32_t>(nodeIndex(joints[j]));
+        }
+    }
+    return true;
+}
+
 const char* AssetManager::getNameForEntity(EntityId entityId) {
   const auto& entity = Entity::import(entityId);
   auto nameInstance = _ncm->getInstance(entity);
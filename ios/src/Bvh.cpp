@@ -0,0 +1,319 @@
+#include "Bvh.hpp"
+
+#include <math/vec4.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+
+namespace polyvox {
+
+using namespace filament;
+using namespace filament::math;
+
+// the traversal stack is sized to match, so the builder never creates a deeper tree than this
+static constexpr uint32_t kMaxBvhDepth = 64;
+static constexpr int kSahBins = 12;
+
+static inline float halfArea(const float3& min, const float3& max) {
+    float3 e = max - min;
+    return e.x * e.y + e.y * e.z + e.z * e.x;
+}
+
+static inline void grow(float3& min, float3& max, const float3& pmin, const float3& pmax) {
+    min = float3(std::min(min.x, pmin.x), std::min(min.y, pmin.y), std::min(min.z, pmin.z));
+    max = float3(std::max(max.x, pmax.x), std::max(max.y, pmax.y), std::max(max.z, pmax.z));
+}
+
+///
+/// Slab test. On a hit, [tNear] is the distance at which the ray enters the box (clamped to 0).
+///
+static inline bool intersectBox(const Ray& ray, const float3& min, const float3& max, float tMax, float& tNear) {
+    float3 t0 = (min - ray.origin) * ray.inverseDirection;
+    float3 t1 = (max - ray.origin) * ray.inverseDirection;
+    float enter = std::fmax(std::fmax(std::fmin(t0.x, t1.x), std::fmin(t0.y, t1.y)), std::fmax(std::fmin(t0.z, t1.z), 0.0f));
+    float exit = std::fmin(std::fmin(std::fmax(t0.x, t1.x), std::fmax(t0.y, t1.y)), std::fmin(std::fmax(t0.z, t1.z), tMax));
+    tNear = enter;
+    return enter <= exit;
+}
+
+///
+/// Visits every leaf whose bounds are hit by [ray] within the current best distance (re-read via [maxDistance] after each leaf),
+/// nearest child first.
+///
+template <typename F>
+static void traverse(const std::vector<BvhNode>& nodes, const Ray& ray, const float& maxDistance, F&& visitLeaf) {
+    float tNear;
+    if(nodes.empty() || !intersectBox(ray, nodes[0].min, nodes[0].max, maxDistance, tNear)) {
+        return;
+    }
+    uint32_t stack[kMaxBvhDepth];
+    uint32_t stackSize = 0;
+    uint32_t index = 0;
+    while(true) {
+        const BvhNode& node = nodes[index];
+        if(node.count > 0) {
+            visitLeaf(node);
+        } else {
+            uint32_t left = node.first;
+            uint32_t right = node.first + 1;
+            float tLeft, tRight;
+            bool hitLeft = intersectBox(ray, nodes[left].min, nodes[left].max, maxDistance, tLeft);
+            bool hitRight = intersectBox(ray, nodes[right].min, nodes[right].max, maxDistance, tRight);
+            if(hitLeft && hitRight) {
+                if(tRight < tLeft) {
+                    std::swap(left, right);
+                }
+                stack[stackSize++] = right;
+                index = left;
+                continue;
+            }
+            if(hitLeft || hitRight) {
+                index = hitLeft ? left : right;
+                continue;
+            }
+        }
+        if(stackSize == 0) {
+            break;
+        }
+        index = stack[--stackSize];
+    }
+}
+
+void buildBvh(const float3* mins, const float3* maxs, size_t count, uint32_t maxLeafSize,
+              std::vector<BvhNode>& nodes, std::vector<uint32_t>& order) {
+    nodes.clear();
+    order.resize(count);
+    std::iota(order.begin(), order.end(), 0);
+    if(count == 0) {
+        return;
+    }
+
+    std::vector<float3> centroids(count);
+    for(size_t i = 0; i < count; i++) {
+        centroids[i] = (mins[i] + maxs[i]) * 0.5f;
+    }
+
+    struct Task {
+        uint32_t node;
+        uint32_t first;
+        uint32_t count;
+        uint32_t depth;
+    };
+    std::vector<Task> tasks;
+    tasks.push_back({ 0, 0, (uint32_t)count, 1 });
+    nodes.reserve(count * 2);
+    nodes.push_back({});
+
+    while(!tasks.empty()) {
+        Task task = tasks.back();
+        tasks.pop_back();
+
+        float3 min(FLT_MAX), max(-FLT_MAX), centroidMin(FLT_MAX), centroidMax(-FLT_MAX);
+        for(uint32_t i = task.first; i < task.first + task.count; i++) {
+            uint32_t p = order[i];
+            grow(min, max, mins[p], maxs[p]);
+            grow(centroidMin, centroidMax, centroids[p], centroids[p]);
+        }
+        nodes[task.node] = { min, task.first, max, task.count };
+
+        if(task.count <= maxLeafSize || task.depth >= kMaxBvhDepth) {
+            continue;
+        }
+
+        float3 extent = centroidMax - centroidMin;
+        int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+        if(extent[axis] <= 0.0f) {
+            // every centroid coincides, so no split can separate them
+            continue;
+        }
+
+        struct Bin {
+            float3 min = float3(FLT_MAX);
+            float3 max = float3(-FLT_MAX);
+            uint32_t count = 0;
+        };
+        Bin bins[kSahBins];
+        float scale = kSahBins / extent[axis];
+        auto binOf = [&](uint32_t p) {
+            return std::min(kSahBins - 1, (int)((centroids[p][axis] - centroidMin[axis]) * scale));
+        };
+        for(uint32_t i = task.first; i < task.first + task.count; i++) {
+            uint32_t p = order[i];
+            auto& bin = bins[binOf(p)];
+            grow(bin.min, bin.max, mins[p], maxs[p]);
+            bin.count++;
+        }
+
+        // sweep from the right to get the cost of every right-hand side, then from the left to find the cheapest split
+        float rightCost[kSahBins];
+        float3 rmin(FLT_MAX), rmax(-FLT_MAX);
+        uint32_t rcount = 0;
+        for(int b = kSahBins - 1; b > 0; b--) {
+            if(bins[b].count) {
+                grow(rmin, rmax, bins[b].min, bins[b].max);
+                rcount += bins[b].count;
+            }
+            rightCost[b] = rcount ? rcount * halfArea(rmin, rmax) : 0.0f;
+        }
+        float3 lmin(FLT_MAX), lmax(-FLT_MAX);
+        uint32_t lcount = 0;
+        float bestCost = FLT_MAX;
+        int bestSplit = -1;
+        for(int b = 0; b < kSahBins - 1; b++) {
+            if(bins[b].count) {
+                grow(lmin, lmax, bins[b].min, bins[b].max);
+                lcount += bins[b].count;
+            }
+            if(lcount == 0 || lcount == task.count) {
+                continue;
+            }
+            float cost = lcount * halfArea(lmin, lmax) + rightCost[b + 1];
+            if(cost < bestCost) {
+                bestCost = cost;
+                bestSplit = b;
+            }
+        }
+
+        uint32_t* begin = order.data() + task.first;
+        uint32_t* end = begin + task.count;
+        uint32_t* mid;
+        if(bestSplit >= 0) {
+            mid = std::partition(begin, end, [&](uint32_t p) { return binOf(p) <= bestSplit; });
+        } else {
+            mid = begin + task.count / 2;
+            std::nth_element(begin, mid, end, [&](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+        }
+        uint32_t leftCount = (uint32_t)(mid - begin);
+
+        uint32_t left = (uint32_t)nodes.size();
+        nodes.push_back({});
+        nodes.push_back({});
+        nodes[task.node].first = left;
+        nodes[task.node].count = 0;
+        tasks.push_back({ left, task.first, leftCount, task.depth + 1 });
+        tasks.push_back({ left + 1, task.first + leftCount, task.count - leftCount, task.depth + 1 });
+    }
+}
+
+void MeshBvh::build(const std::vector<float3>& positions, const std::vector<uint32_t>& primitives, const std::vector<uint32_t>& triangles) {
+    size_t count = positions.size() / 3;
+    std::vector<float3> mins(count), maxs(count);
+    for(size_t i = 0; i < count; i++) {
+        const float3* v = &positions[i * 3];
+        mins[i] = maxs[i] = v[0];
+        grow(mins[i], maxs[i], v[1], v[1]);
+        grow(mins[i], maxs[i], v[2], v[2]);
+    }
+    std::vector<uint32_t> order;
+    buildBvh(mins.data(), maxs.data(), count, 4, _nodes, order);
+
+    _triangles.resize(count);
+    for(size_t i = 0; i < count; i++) {
+        uint32_t t = order[i];
+        const float3* v = &positions[t * 3];
+        _triangles[i] = { v[0], v[1] - v[0], v[2] - v[0], primitives[t], triangles[t] };
+    }
+}
+
+bool MeshBvh::intersect(const Ray& ray, Hit& hit) const {
+    bool found = false;
+    traverse(_nodes, ray, hit.distance, [&](const BvhNode& leaf) {
+        for(uint32_t i = leaf.first; i < leaf.first + leaf.count; i++) {
+            // Moller-Trumbore, double-sided
+            const Triangle& tri = _triangles[i];
+            float3 p = cross(ray.direction, tri.e2);
+            float det = dot(tri.e1, p);
+            if(std::fabs(det) < 1e-12f) {
+                continue;
+            }
+            float inverseDet = 1.0f / det;
+            float3 s = ray.origin - tri.v0;
+            float u = dot(s, p) * inverseDet;
+            if(u < 0.0f || u > 1.0f) {
+                continue;
+            }
+            float3 q = cross(s, tri.e1);
+            float v = dot(ray.direction, q) * inverseDet;
+            if(v < 0.0f || u + v > 1.0f) {
+                continue;
+            }
+            float t = dot(tri.e2, q) * inverseDet;
+            if(t > 0.0f && t < hit.distance) {
+                hit = { t, u, v, tri.primitive, tri.triangle };
+                found = true;
+            }
+        }
+    });
+    return found;
+}
+
+void SceneBvh::build(std::vector<Instance> instances) {
+    std::vector<float3> mins(instances.size()), maxs(instances.size());
+    for(size_t i = 0; i < instances.size(); i++) {
+        mins[i] = instances[i].min;
+        maxs[i] = instances[i].max;
+    }
+    std::vector<uint32_t> order;
+    buildBvh(mins.data(), maxs.data(), instances.size(), 2, _nodes, order);
+    _instances.resize(instances.size());
+    for(size_t i = 0; i < order.size(); i++) {
+        _instances[i] = instances[order[i]];
+    }
+}
+
+///
+/// Updates the inverse transform and world-space bounds of [instance] (using Arvo's method to transform the mesh bounds).
+///
+void SceneBvh::setWorldTransform(Instance& instance, const mat4f& localToWorld) {
+    instance.worldToLocal = inverse(localToWorld);
+    float3 center = (instance.mesh->getMin() + instance.mesh->getMax()) * 0.5f;
+    float3 halfExtent = (instance.mesh->getMax() - instance.mesh->getMin()) * 0.5f;
+    float3 worldCenter = (localToWorld * float4(center, 1.0f)).xyz;
+    float3 worldHalfExtent;
+    for(int row = 0; row < 3; row++) {
+        worldHalfExtent[row] = std::fabs(localToWorld[0][row]) * halfExtent.x
+            + std::fabs(localToWorld[1][row]) * halfExtent.y
+            + std::fabs(localToWorld[2][row]) * halfExtent.z;
+    }
+    instance.min = worldCenter - worldHalfExtent;
+    instance.max = worldCenter + worldHalfExtent;
+}
+
+void SceneBvh::refitNodes() {
+    for(size_t i = _nodes.size(); i-- > 0;) {
+        BvhNode& node = _nodes[i];
+        float3 min(FLT_MAX), max(-FLT_MAX);
+        if(node.count > 0) {
+            for(uint32_t j = node.first; j < node.first + node.count; j++) {
+                grow(min, max, _instances[j].min, _instances[j].max);
+            }
+        } else {
+            grow(min, max, _nodes[node.first].min, _nodes[node.first].max);
+            grow(min, max, _nodes[node.first + 1].min, _nodes[node.first + 1].max);
+        }
+        node.min = min;
+        node.max = max;
+    }
+}
+
+bool SceneBvh::intersect(const Ray& ray, float maxDistance, Hit& hit) const {
+    hit.instance = nullptr;
+    hit.mesh.distance = maxDistance;
+    traverse(_nodes, ray, hit.mesh.distance, [&](const BvhNode& leaf) {
+        for(uint32_t i = leaf.first; i < leaf.first + leaf.count; i++) {
+            const Instance& instance = _instances[i];
+            // the transformed direction isn't renormalized, so distances along it are the same in both spaces
+            Ray local(
+                (instance.worldToLocal * float4(ray.origin, 1.0f)).xyz,
+                (instance.worldToLocal * float4(ray.direction, 0.0f)).xyz);
+            if(instance.mesh->intersect(local, hit.mesh)) {
+                hit.instance = &instance;
+            }
+        }
+    });
+    return hit.instance != nullptr;
+}
+
+}
@@ -0,0 +1,190 @@
+#include <cstring>
+#include <vector>
+
+#include "CommandBuffer.hpp"
+#include "FilamentViewer.hpp"
+#include "FlutterFilamentFFIApi.h"
+#include "Log.hpp"
+
+namespace polyvox {
+
+  //
+  // Bounds-checked reader over a (possibly unaligned) little-endian byte stream.
+  //
+  class CommandReader {
+    public:
+      CommandReader(const uint8_t* const data, size_t length) : _end(data + length), _cursor(data) {}
+
+      template <typename T>
+      bool read(T& out) {
+        if(remaining() < sizeof(T)) {
+          return false;
+        }
+        memcpy(&out, _cursor, sizeof(T));
+        _cursor += sizeof(T);
+        return true;
+      }
+
+      bool read(float* out, size_t count) {
+        if(remaining() < count * sizeof(float)) {
+          return false;
+        }
+        memcpy(out, _cursor, count * sizeof(float));
+        _cursor += count * sizeof(float);
+        return true;
+      }
+
+      const uint8_t* cursor() const { return _cursor; }
+      size_t remaining() const { return _end - _cursor; }
+      void skip(size_t length) { _cursor += length; }
+
+    private:
+      const uint8_t* const _end;
+      const uint8_t* _cursor;
+  };
+
+  bool CommandBuffer::validate(const uint8_t* const data, size_t length) {
+    if(!data || length < kHeaderSize) {
+      return false;
+    }
+    CommandReader reader(data, length);
+    uint32_t magic;
+    uint16_t version;
+    reader.read(magic);
+    reader.read(version);
+    if(magic != COMMAND_BUFFER_MAGIC) {
+      Log("Invalid command buffer (bad magic %u)", magic);
+      return false;
+    }
+    if(version != COMMAND_BUFFER_VERSION) {
+      Log("Unsupported command buffer version %d (expected %d)", version, COMMAND_BUFFER_VERSION);
+      return false;
+    }
+    return true;
+  }
+
+  static bool applyCommand(FilamentViewer* const viewer, uint16_t opcode, CommandReader& payload) {
+    AssetManager* const assetManager = viewer->getAssetManager();
+    switch(opcode) {
+      case COMMAND_SET_POSITION: {
+        EntityId asset;
+        float xyz[3];
+        if(!payload.read(asset) || !payload.read(xyz, 3)) {
+          return false;
+        }
+        assetManager->setPosition(asset, xyz[0], xyz[1], xyz[2]);
+        return true;
+      }
+      case COMMAND_SET_ROTATION: {
+        EntityId asset;
+        float rotation[4];
+        if(!payload.read(asset) || !payload.read(rotation, 4)) {
+          return false;
+        }
+        assetManager->setRotation(asset, rotation[0], rotation[1], rotation[2], rotation[3]);
+        return true;
+      }
+      case COMMAND_SET_SCALE: {
+        EntityId asset;
+        float scale;
+        if(!payload.read(asset) || !payload.read(scale)) {
+          return false;
+        }
+        assetManager->setScale(asset, scale);
+        return true;
+      }
+      case COMMAND_SET_TRANSFORM: {
+        EntityId asset;
+        math::mat4f transform;
+        if(!payload.read(asset) || !payload.read(&transform[0][0], 16)) {
+          return false;
+        }
+        assetManager->setTransform(asset, transform);
+        return true;
+      }
+      case COMMAND_SET_MORPH_WEIGHTS: {
+        EntityId asset;
+        uint16_t nameLength;
+        uint16_t numWeights;
+        if(!payload.read(asset) || !payload.read(nameLength) || !payload.read(numWeights) || payload.remaining() < nameLength) {
+          return false;
+        }
+        string entityName((const char*)payload.cursor(), nameLength);
+        payload.skip(nameLength);
+        vector<float> weights(numWeights);
+        if(!payload.read(weights.data(), numWeights)) {
+          return false;
+        }
+        assetManager->setMorphTargetWeights(asset, entityName.c_str(), weights.data(), numWeights);
+        return true;
+      }
+      case COMMAND_PLAY_ANIMATION: {
+        EntityId asset;
+        int32_t index;
+        uint8_t flags[4]; // loop, reverse, replaceActive, reserved
+        float crossfade;
+        if(!payload.read(asset) || !payload.read(index) || !payload.read(flags) || !payload.read(crossfade)) {
+          return false;
+        }
+        assetManager->playAnimation(asset, index, flags[0], flags[1], flags[2], crossfade);
+        return true;
+      }
+      case COMMAND_STOP_ANIMATION: {
+        EntityId asset;
+        int32_t index;
+        if(!payload.read(asset) || !payload.read(index)) {
+          return false;
+        }
+        assetManager->stopAnimation(asset, index);
+        return true;
+      }
+      case COMMAND_SET_ANIMATION_FRAME: {
+        EntityId asset;
+        int32_t index;
+        int32_t frame;
+        if(!payload.read(asset) || !payload.read(index) || !payload.read(frame)) {
+          return false;
+        }
+        assetManager->setAnimationFrame(asset, index, frame);
+        return true;
+      }
+      case COMMAND_SET_CAMERA_MODEL_MATRIX: {
+        float matrix[16];
+        if(!payload.read(matrix, 16)) {
+          return false;
+        }
+        viewer->setCameraModelMatrix(matrix);
+        return true;
+      }
+      default:
+        Log("Skipping unknown command buffer opcode %d", opcode);
+        return false;
+    }
+  }
+
+  int CommandBuffer::apply(FilamentViewer* const viewer, const uint8_t* const data, size_t length) {
+    if(!validate(data, length)) {
+      return 0;
+    }
+
+    CommandReader reader(data + 8, length - 8);
+    uint32_t commandCount;
+    reader.read(commandCount);
+
+    int applied = 0;
+    for(uint32_t i = 0; i < commandCount; i++) {
+      uint16_t opcode;
+      uint16_t payloadLength;
+      if(!reader.read(opcode) || !reader.read(payloadLength) || reader.remaining() < payloadLength) {
+        Log("Command buffer truncated at command %d of %d", i, commandCount);
+        break;
+      }
+      CommandReader payload(reader.cursor(), payloadLength);
+      if(applyCommand(viewer, opcode, payload)) {
+        applied++;
+      }
+      reader.skip(payloadLength);
+    }
+    return applied;
+  }
+}
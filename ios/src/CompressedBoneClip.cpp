@@ -0,0 +1,300 @@
+#include "CompressedBoneClip.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace polyvox {
+
+using namespace filament;
+using namespace filament::math;
+
+static constexpr int kFloatsPerBone = 7;
+// bounds the cost of keyframe reduction (which checks every frame a key would span, for every span it tries)
+static constexpr int kMaxKeySpacing = 64;
+// the components other than the largest of a unit quaternion are within +/- 1/sqrt(2)
+static constexpr float kSmallestThreeRange = 0.70710678f;
+static constexpr float kRotationScale = 32767.0f;
+static constexpr float kTranslationScale = 65535.0f;
+
+static inline quatf rotationFrom(const float* bone) {
+    return normalize(quatf { bone[3], bone[4], bone[5], bone[6] });
+}
+
+static inline float3 translationFrom(const float* bone) {
+    return float3 { bone[0], bone[1], bone[2] };
+}
+
+// the angle of the rotation between two unit quaternions (via the chord length, since acos(dot) is inaccurate for small angles)
+static inline float angleBetween(const quatf& a, const quatf& b) {
+    quatf d = dot(a, b) < 0.0f ? a + b : a - b;
+    return 4.0f * std::asin(std::min(std::sqrt(dot(d, d)) * 0.5f, 1.0f));
+}
+
+///
+/// "Smallest three" encoding: the largest component is dropped (its index goes in the top bits of the first two values) and
+/// the other three are quantized to 15 bits each.
+///
+static void quantizeRotation(quatf q, uint16_t* out) {
+    float components[4] = { q.x, q.y, q.z, q.w };
+    int largest = 0;
+    for(int i = 1; i < 4; i++) {
+        if(std::abs(components[i]) > std::abs(components[largest])) {
+            largest = i;
+        }
+    }
+    // q and -q are the same rotation, so make the dropped component positive
+    float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+    uint16_t quantized[3];
+    for(int i = 0, j = 0; i < 4; i++) {
+        if(i == largest) {
+            continue;
+        }
+        float normalized = std::clamp(sign * components[i] / kSmallestThreeRange * 0.5f + 0.5f, 0.0f, 1.0f);
+        quantized[j++] = (uint16_t)std::lround(normalized * kRotationScale);
+    }
+    out[0] = quantized[0] | (uint16_t)((largest >> 1) << 15);
+    out[1] = quantized[1] | (uint16_t)((largest & 1) << 15);
+    out[2] = quantized[2];
+}
+
+static quatf dequantizeRotation(const uint16_t* in) {
+    int largest = ((in[0] >> 15) << 1) | (in[1] >> 15);
+    float small[3] = {
+        ((in[0] & 0x7fff) / kRotationScale * 2.0f - 1.0f) * kSmallestThreeRange,
+        ((in[1] & 0x7fff) / kRotationScale * 2.0f - 1.0f) * kSmallestThreeRange,
+        ((in[2] & 0x7fff) / kRotationScale * 2.0f - 1.0f) * kSmallestThreeRange
+    };
+    float components[4];
+    float sumSquares = small[0] * small[0] + small[1] * small[1] + small[2] * small[2];
+    for(int i = 0, j = 0; i < 4; i++) {
+        components[i] = i == largest ? std::sqrt(std::max(1.0f - sumSquares, 0.0f)) : small[j++];
+    }
+    return normalize(quatf { components[3], components[0], components[1], components[2] });
+}
+
+static void quantizeTranslation(float3 v, float3 min, float3 extent, uint16_t* out) {
+    for(int i = 0; i < 3; i++) {
+        float normalized = extent[i] > 0.0f ? std::clamp((v[i] - min[i]) / extent[i], 0.0f, 1.0f) : 0.0f;
+        out[i] = (uint16_t)std::lround(normalized * kTranslationScale);
+    }
+}
+
+static inline float3 dequantizeTranslation(const uint16_t* in, float3 min, float3 extent) {
+    return min + extent * float3 { in[0] / kTranslationScale, in[1] / kTranslationScale, in[2] / kTranslationScale };
+}
+
+///
+/// Greedily picks the keyframes of a track: each key is placed as far from the previous one as possible while every frame in
+/// between is still reproduced within [tolerance] by interpolating between the two (quantized) keys.
+/// [error] returns the distance between frame [frame] and the interpolation of frames [from] and [to].
+///
+template <typename ErrorAt>
+static void reduceKeyframes(int numFrames, float tolerance, ErrorAt&& error, std::vector<uint32_t>& keys) {
+    keys.push_back(0);
+    int from = 0;
+    while(from < numFrames - 1) {
+        int to = from + 1;
+        if(tolerance > 0.0f) {
+            int limit = std::min(numFrames - 1, from + kMaxKeySpacing);
+            while(to < limit) {
+                int candidate = to + 1;
+                bool fits = true;
+                for(int frame = from + 1; frame < candidate && fits; frame++) {
+                    fits = error(frame, from, candidate) <= tolerance;
+                }
+                if(!fits) {
+                    break;
+                }
+                to = candidate;
+            }
+        }
+        keys.push_back(to);
+        from = to;
+    }
+}
+
+void CompressedBoneClip::compress(const float* frameData, int numFrames, int numBones, float rotationTolerance, float translationTolerance) {
+    compressTracks(frameData, numFrames, numBones, rotationTolerance, translationTolerance, true);
+}
+
+void CompressedBoneClip::compressRotations(const float* frameData, int numFrames, int numBones, float rotationTolerance) {
+    compressTracks(frameData, numFrames, numBones, rotationTolerance, 0.0f, false);
+}
+
+void CompressedBoneClip::compressTracks(const float* frameData, int numFrames, int numBones, float rotationTolerance,
+                                        float translationTolerance, bool withTranslations) {
+    _numFrames = numFrames;
+    _numBones = numBones;
+    _rotationTracks.assign(numBones, Track());
+    _translationTracks.assign(withTranslations ? numBones : 0, Track());
+    _rotationKeyFrames.clear();
+    _translationKeyFrames.clear();
+    _rotationKeys.clear();
+    _translationKeys.clear();
+    _stats = Stats();
+    if(numFrames <= 0 || numBones <= 0) {
+        return;
+    }
+
+    auto bone = [&](int frame, int index) {
+        return frameData + ((size_t)frame * numBones + index) * kFloatsPerBone;
+    };
+
+    std::vector<uint32_t> keys;
+    // each frame of the track being compressed, as it would be decompressed if it were a key
+    std::vector<quatf> quantizedRotations(numFrames);
+    std::vector<float3> quantizedTranslations(numFrames);
+    for(int index = 0; index < numBones; index++) {
+        // rotations
+        auto& rotationTrack = _rotationTracks[index];
+        rotationTrack.firstKey = (uint32_t)_rotationKeyFrames.size();
+        bool constant = true;
+        quatf first = rotationFrom(bone(0, index));
+        for(int frame = 1; frame < numFrames && constant; frame++) {
+            constant = angleBetween(first, rotationFrom(bone(frame, index))) <= rotationTolerance;
+        }
+        keys.clear();
+        if(constant) {
+            keys.push_back(0);
+        } else {
+            for(int frame = 0; frame < numFrames; frame++) {
+                uint16_t q[3];
+                quantizeRotation(rotationFrom(bone(frame, index)), q);
+                quantizedRotations[frame] = dequantizeRotation(q);
+            }
+            reduceKeyframes(numFrames, rotationTolerance, [&](int frame, int from, int to) {
+                float t = float(frame - from) / float(to - from);
+                return angleBetween(shortestNlerp(quantizedRotations[from], quantizedRotations[to], t), rotationFrom(bone(frame, index)));
+            }, keys);
+        }
+        rotationTrack.keyCount = (uint32_t)keys.size();
+        for(auto frame : keys) {
+            _rotationKeyFrames.push_back(frame);
+            uint16_t q[3];
+            quantizeRotation(rotationFrom(bone(frame, index)), q);
+            _rotationKeys.insert(_rotationKeys.end(), q, q + 3);
+        }
+
+        if(!withTranslations) {
+            continue;
+        }
+
+        // translations
+        auto& translationTrack = _translationTracks[index];
+        translationTrack.firstKey = (uint32_t)_translationKeyFrames.size();
+        float3 min = translationFrom(bone(0, index));
+        float3 max = min;
+        for(int frame = 1; frame < numFrames; frame++) {
+            float3 v = translationFrom(bone(frame, index));
+            min = float3 { std::min(min.x, v.x), std::min(min.y, v.y), std::min(min.z, v.z) };
+            max = float3 { std::max(max.x, v.x), std::max(max.y, v.y), std::max(max.z, v.z) };
+        }
+        translationTrack.min = min;
+        translationTrack.extent = max - min;
+        keys.clear();
+        if(std::max(std::max(translationTrack.extent.x, translationTrack.extent.y), translationTrack.extent.z) <= translationTolerance) {
+            // constant; the single key is stored exactly in min
+            translationTrack.extent = float3(0.0f);
+            keys.push_back(0);
+        } else {
+            for(int frame = 0; frame < numFrames; frame++) {
+                uint16_t q[3];
+                quantizeTranslation(translationFrom(bone(frame, index)), translationTrack.min, translationTrack.extent, q);
+                quantizedTranslations[frame] = dequantizeTranslation(q, translationTrack.min, translationTrack.extent);
+            }
+            reduceKeyframes(numFrames, translationTolerance, [&](int frame, int from, int to) {
+                float t = float(frame - from) / float(to - from);
+                float3 interpolated = quantizedTranslations[from] * (1.0f - t) + quantizedTranslations[to] * t;
+                return length(interpolated - translationFrom(bone(frame, index)));
+            }, keys);
+        }
+        translationTrack.keyCount = (uint32_t)keys.size();
+        for(auto frame : keys) {
+            _translationKeyFrames.push_back(frame);
+            uint16_t q[3];
+            quantizeTranslation(translationFrom(bone(frame, index)), translationTrack.min, translationTrack.extent, q);
+            _translationKeys.insert(_translationKeys.end(), q, q + 3);
+        }
+    }
+
+    // the source data is measured as uploaded, so discarded translations count towards the saving
+    _stats.uncompressedBytes = (size_t)numFrames * numBones * kFloatsPerBone * sizeof(float);
+    _stats.compressedBytes = sizeof(Track) * (_rotationTracks.size() + _translationTracks.size())
+        + sizeof(uint32_t) * (_rotationKeyFrames.size() + _translationKeyFrames.size())
+        + sizeof(uint16_t) * (_rotationKeys.size() + _translationKeys.size());
+
+    std::vector<float3> translations(numBones);
+    std::vector<quatf> rotations(numBones);
+    for(int frame = 0; frame < numFrames; frame++) {
+        sample(frame, frame, 0.0f, translations.data(), rotations.data());
+        for(int index = 0; index < numBones; index++) {
+            _stats.maxRotationError = std::max(_stats.maxRotationError, angleBetween(rotations[index], rotationFrom(bone(frame, index))));
+            if(withTranslations) {
+                _stats.maxTranslationError = std::max(_stats.maxTranslationError, length(translations[index] - translationFrom(bone(frame, index))));
+            }
+        }
+    }
+}
+
+///
+/// Finds the keys either side of [frame] in a track (binary search over its key frames).
+///
+static inline void findKeys(const uint32_t* keyFrames, uint32_t keyCount, int frame, uint32_t& k0, uint32_t& k1, float& t) {
+    if(keyCount == 1) {
+        k0 = k1 = 0;
+        t = 0.0f;
+        return;
+    }
+    k1 = (uint32_t)(std::upper_bound(keyFrames, keyFrames + keyCount, (uint32_t)frame) - keyFrames);
+    if(k1 >= keyCount) {
+        k0 = k1 = keyCount - 1;
+        t = 0.0f;
+        return;
+    }
+    k0 = k1 - 1;
+    t = float(frame - (int)keyFrames[k0]) / float(keyFrames[k1] - keyFrames[k0]);
+}
+
+quatf CompressedBoneClip::rotationAt(const Track& track, int frame) const {
+    uint32_t k0, k1;
+    float t;
+    findKeys(_rotationKeyFrames.data() + track.firstKey, track.keyCount, frame, k0, k1, t);
+    quatf a = dequantizeRotation(_rotationKeys.data() + (track.firstKey + k0) * 3);
+    if(k0 == k1 || t == 0.0f) {
+        return a;
+    }
+    return shortestNlerp(a, dequantizeRotation(_rotationKeys.data() + (track.firstKey + k1) * 3), t);
+}
+
+float3 CompressedBoneClip::translationAt(const Track& track, int frame) const {
+    uint32_t k0, k1;
+    float t;
+    findKeys(_translationKeyFrames.data() + track.firstKey, track.keyCount, frame, k0, k1, t);
+    float3 a = dequantizeTranslation(_translationKeys.data() + (track.firstKey + k0) * 3, track.min, track.extent);
+    if(k0 == k1 || t == 0.0f) {
+        return a;
+    }
+    return a + (dequantizeTranslation(_translationKeys.data() + (track.firstKey + k1) * 3, track.min, track.extent) - a) * t;
+}
+
+void CompressedBoneClip::sample(int from, int to, float t, float3* translations, quatf* rotations) const {
+    for(int index = 0; index < _numBones; index++) {
+        const auto& track = _rotationTracks[index];
+        quatf a = rotationAt(track, from);
+        rotations[index] = from == to || t == 0.0f ? a : shortestNlerp(a, rotationAt(track, to), t);
+    }
+    if(!translations) {
+        return;
+    }
+    if(_translationTracks.empty()) {
+        std::fill(translations, translations + _numBones, float3(0.0f));
+        return;
+    }
+    for(int index = 0; index < _numBones; index++) {
+        const auto& track = _translationTracks[index];
+        float3 a = translationAt(track, from);
+        translations[index] = from == to || t == 0.0f ? a : a + (translationAt(track, to) - a) * t;
+    }
+}
+
+}
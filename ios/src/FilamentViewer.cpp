@@ -80,6 +80,7 @@
 #include "StreamBufferAdapter.hpp"
 #include "material/image.h"
 #include "TimeIt.hpp"
+#include "Trace.hpp"
 
 using namespace filament;
 using namespace filament::math;
@@ -99,6 +100,10 @@ namespace polyvox
   const double kNearPlane = 0.05;  // 5 cm
   const double kFarPlane = 1000.0; // 1 km
 
+  // picks normally resolve within a couple of frames; any still outstanding after this many are given up on, so a lost
+  // query can't keep the view rendering forever
+  const uint32_t kMaxPickWaitFrames = 10;
+
   // const float kAperture = 1.0f;
   // const float kShutterSpeed = 1.0f;
   // const float kSensitivity = 50.0f;
@@ -133,11 +138,11 @@ namespace polyvox
 
     _renderer = _engine->createRenderer();
 
-    float fr = 60.0f;
-    _renderer->setDisplayInfo({.refreshRate = fr});
+    _renderer->setDisplayInfo({.refreshRate = _refreshRate});
 
+    // FrameRateOptions::interval is a multiple of the display refresh period (not a duration)
     Renderer::FrameRateOptions fro;
-    fro.interval = 1 / fr;
+    fro.interval = 1;
     _renderer->setFrameRateOptions(fro);
 
     _scene = _engine->createScene();
@@ -259,11 +264,13 @@ namespace polyvox
 
   void FilamentViewer::setPostProcessing(bool enabled)
   {
+    markDirty(RENDER_REASON_VIEW);
     _view->setPostProcessingEnabled(enabled);
   }
 
   void FilamentViewer::setBloom(float strength)
   {
+    markDirty(RENDER_REASON_VIEW);
     decltype(_view->getBloomOptions()) opts;
     opts.enabled = true;
     opts.strength = strength;
@@ -272,6 +279,7 @@ namespace polyvox
 
   void FilamentViewer::setToneMapping(ToneMapping toneMapping)
   {
+    markDirty(RENDER_REASON_VIEW);
 
     ToneMapper *tm;
     switch (toneMapping)
@@ -299,16 +307,26 @@ namespace polyvox
     delete tm;
   }
 
+  ///
+  /// Sets the desired frame interval (in seconds), rounded to a whole number of display refresh periods.
+  ///
   void FilamentViewer::setFrameInterval(float frameInterval)
   {
     Renderer::FrameRateOptions fro;
-    fro.interval = frameInterval;
+    fro.interval = (uint8_t)std::max(1.0f, std::min(255.0f, std::round(frameInterval * _refreshRate)));
     _renderer->setFrameRateOptions(fro);
-    Log("Set framerate interval to %f", frameInterval);
+    Log("Set framerate interval to %f (%d refresh periods)", frameInterval, fro.interval);
+  }
+
+  void FilamentViewer::setRefreshRate(float refreshRate)
+  {
+    _refreshRate = refreshRate;
+    _renderer->setDisplayInfo({.refreshRate = refreshRate});
   }
 
   int32_t FilamentViewer::addLight(LightManager::Type t, float colour, float intensity, float posX, float posY, float posZ, float dirX, float dirY, float dirZ, bool shadows)
   {
+    markDirty(RENDER_REASON_LIGHT);
     auto light = EntityManager::get().create();
     LightManager::Builder(t)
         .color(Color::cct(colour))
@@ -326,6 +344,7 @@ namespace polyvox
 
   void FilamentViewer::removeLight(EntityId entityId)
   {
+    markDirty(RENDER_REASON_LIGHT);
     Log("Removing light with entity ID %d", entityId);
     auto entity = utils::Entity::import(entityId);
     if (entity.isNull())
@@ -342,6 +361,7 @@ namespace polyvox
 
   void FilamentViewer::clearLights()
   {
+    markDirty(RENDER_REASON_LIGHT);
     Log("Removing all lights");
     _scene->removeEntities(_lights.data(), _lights.size());
     EntityManager::get().destroy(_lights.size(), _lights.data());
@@ -355,6 +375,7 @@ namespace polyvox
 
   void FilamentViewer::loadKtx2Texture(string path, ResourceBuffer rb)
   {
+    TRACE_FUNCTION("texture");
 
     // TODO - check all this
 
@@ -377,6 +398,7 @@ namespace polyvox
 
   void FilamentViewer::loadKtxTexture(string path, ResourceBuffer rb)
   {
+    TRACE_FUNCTION("texture");
     ktxreader::Ktx1Bundle *bundle =
         new ktxreader::Ktx1Bundle(static_cast<const uint8_t *>(rb.data),
                                   static_cast<uint32_t>(rb.size));
@@ -405,6 +427,7 @@ namespace polyvox
 
   void FilamentViewer::loadPngTexture(string path, ResourceBuffer rb)
   {
+    TRACE_FUNCTION("texture");
 
     polyvox::StreamBufferAdapter sb((char *)rb.data, (char *)rb.data + rb.size);
 
@@ -479,6 +502,7 @@ namespace polyvox
 
   void FilamentViewer::setBackgroundColor(const float r, const float g, const float b, const float a)
   {
+    markDirty(RENDER_REASON_SCENE);
     _imageMaterial->setDefaultParameter("showImage", 0);
     _imageMaterial->setDefaultParameter("backgroundColor", RgbaType::sRGB, float4(r, g, b, a));
     _imageMaterial->setDefaultParameter("transform", _imageScale);
@@ -486,6 +510,7 @@ namespace polyvox
 
   void FilamentViewer::clearBackgroundImage()
   {
+    markDirty(RENDER_REASON_SCENE);
     _imageMaterial->setDefaultParameter("showImage", 0);
     if (_imageTexture)
     {
@@ -497,6 +522,7 @@ namespace polyvox
 
   void FilamentViewer::setBackgroundImage(const char *resourcePath, bool fillHeight)
   {
+    markDirty(RENDER_REASON_SCENE);
 
     string resourcePathString(resourcePath);
 
@@ -538,6 +564,7 @@ namespace polyvox
   ///
   void FilamentViewer::setBackgroundImagePosition(float x, float y, bool clamp = false)
   {
+    markDirty(RENDER_REASON_SCENE);
 
     // to translate the background image, we apply a transform to the UV coordinates of the quad texture, not the quad itself (see image.mat).
     // this allows us to set a background colour for the quad when the texture has been translated outside the quad's bounds.
@@ -616,6 +643,9 @@ namespace polyvox
 
   FilamentViewer::~FilamentViewer()
   {
+    // don't call back into the client while tearing down
+    _pickResultsCallback = nullptr;
+    abandonPicks();
     clearAssets();
     delete _assetManager;
 
@@ -638,6 +668,7 @@ namespace polyvox
 
   void FilamentViewer::createSwapChain(const void *window, uint32_t width, uint32_t height)
   {
+    markDirty(RENDER_REASON_VIEW);
 #if TARGET_OS_IPHONE
     _swapChain = _engine->createSwapChain((void *)window, filament::backend::SWAP_CHAIN_CONFIG_APPLE_CVPIXELBUFFER);
 #else
@@ -656,6 +687,7 @@ namespace polyvox
 
   void FilamentViewer::createRenderTarget(intptr_t texture, uint32_t width, uint32_t height)
   {
+    markDirty(RENDER_REASON_VIEW);
     // Create filament textures and render targets (note the color buffer has the import call)
     _rtColor = filament::Texture::Builder()
                    .width(width)
@@ -683,6 +715,8 @@ namespace polyvox
 
   void FilamentViewer::destroySwapChain()
   {
+    // nothing more will be rendered into the current target, so its picks won't resolve
+    abandonPicks();
     if (_rt)
     {
       _view->setRenderTarget(nullptr);
@@ -704,6 +738,7 @@ namespace polyvox
 
   void FilamentViewer::clearAssets()
   {
+    markDirty(RENDER_REASON_SCENE);
     Log("Clearing all assets");
     if (_mainCamera)
     {
@@ -717,6 +752,7 @@ namespace polyvox
 
   void FilamentViewer::removeAsset(EntityId asset)
   {
+    markDirty(RENDER_REASON_SCENE);
     Log("Removing asset from scene");
 
     mtx.lock();
@@ -731,6 +767,7 @@ namespace polyvox
   ///
   void FilamentViewer::setCameraExposure(float aperture, float shutterSpeed, float sensitivity)
   {
+    markDirty(RENDER_REASON_CAMERA);
     Camera &cam = _view->getCamera();
     Log("Setting aperture (%03f) shutterSpeed (%03f) and sensitivity (%03f)", aperture, shutterSpeed, sensitivity);
     cam.setExposure(aperture, shutterSpeed, sensitivity);
@@ -741,6 +778,7 @@ namespace polyvox
   ///
   void FilamentViewer::setCameraFocalLength(float focalLength)
   {
+    markDirty(RENDER_REASON_CAMERA);
     Camera &cam = _view->getCamera();
     _cameraFocalLength = focalLength;
     cam.setLensProjection(_cameraFocalLength, 1.0f, kNearPlane,
@@ -752,6 +790,7 @@ namespace polyvox
   ///
   void FilamentViewer::setCameraFocusDistance(float focusDistance)
   {
+    markDirty(RENDER_REASON_CAMERA);
     Camera &cam = _view->getCamera();
     _cameraFocusDistance = focusDistance;
     cam.setFocusDistance(_cameraFocusDistance);
@@ -764,6 +803,7 @@ namespace polyvox
   ///
   bool FilamentViewer::setCamera(EntityId entityId, const char *cameraName)
   {
+    markDirty(RENDER_REASON_CAMERA);
 
     auto asset = _assetManager->getAssetByEntityId(entityId);
     if (!asset)
@@ -828,6 +868,7 @@ namespace polyvox
 
   void FilamentViewer::loadSkybox(const char *const skyboxPath)
   {
+    markDirty(RENDER_REASON_SCENE);
 
     removeSkybox();
 
@@ -877,6 +918,7 @@ namespace polyvox
 
   void FilamentViewer::removeSkybox()
   {
+    markDirty(RENDER_REASON_SCENE);
     Log("Removing skybox");
     _scene->setSkybox(nullptr);
     if (_skybox)
@@ -893,6 +935,7 @@ namespace polyvox
 
   void FilamentViewer::removeIbl()
   {
+    markDirty(RENDER_REASON_SCENE);
     if (_indirectLight)
     {
       _engine->destroy(_indirectLight);
@@ -905,6 +948,7 @@ namespace polyvox
 
   void FilamentViewer::loadIbl(const char *const iblPath, float intensity)
   {
+    markDirty(RENDER_REASON_SCENE);
     removeIbl();
     if (iblPath)
     {
@@ -951,10 +995,28 @@ namespace polyvox
     }
   }
 
-  double _elapsed = 0;
-  int _frameCount = 0;
+  static float millisecondsBetween(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+  {
+    return std::chrono::duration<float, std::milli>(end - start).count();
+  }
 
-  void FilamentViewer::render(
+  ///
+  /// Enables/disables on-demand rendering.
+  /// When enabled, render() only renders a frame if something has changed since the last frame (see RenderReason),
+  /// or (if [idleFrameRate] is greater than zero) if more than 1/idleFrameRate seconds have passed since the last frame.
+  ///
+  void FilamentViewer::setOnDemandRendering(bool enabled, float idleFrameRate)
+  {
+    _onDemandRendering = enabled;
+    _idleFrameRate = idleFrameRate;
+    markDirty(RENDER_REASON_REQUESTED);
+  }
+
+  ///
+  /// Updates animations and the camera manipulator, then renders a frame if needed.
+  /// Returns true if a frame was actually rendered (i.e. it was needed and not skipped by the Renderer).
+  ///
+  bool FilamentViewer::render(
       uint64_t frameTimeInNanos,
       void *pixelBuffer,
       void (*callback)(void *buf, size_t size, void *data),
@@ -964,22 +1026,38 @@ namespace polyvox
     if (!_view || !_mainCamera || !_swapChain)
     {
       Log("Not ready for rendering");
-      return;
+      return false;
     }
 
-    if (_frameCount == 60)
+    _assetManager->updateAsyncLoads();
+
+    FrameTimingRecord timing = {};
+    auto frameStart = std::chrono::steady_clock::now();
+    timing.startTimeInNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(frameStart.time_since_epoch()).count();
+    timing.vsyncTimeInNanos = frameTimeInNanos;
+    timing.taskDrainInMilliseconds = _pendingTaskDrainInMilliseconds;
+    _pendingTaskDrainInMilliseconds = 0;
+
+    uint32_t reasons = _dirtyReasons.exchange(RENDER_REASON_NONE) | _assetManager->consumeDirtyReasons();
+
+    // pick results are only resolved when the engine is pumped at the start of a frame, so keep rendering until they arrive
+    if (_picksInFlight > 0 && ++_pickFramesWaiting > kMaxPickWaitFrames)
     {
-      // Log("1 sec average for asset animation update %f", _elapsed / 60);
-      _elapsed = 0;
-      _frameCount = 0;
+      Log("Giving up on %u unresolved pick requests", _picksInFlight);
+      abandonPicks();
+    }
+    if (!_pendingPicks.empty() || _picksInFlight > 0)
+    {
+      reasons |= RENDER_REASON_REQUESTED;
     }
 
-    Timer tmr;
-
-    _assetManager->updateAnimations();
+    if (_assetManager->updateAnimations())
+    {
+      reasons |= RENDER_REASON_ANIMATION;
+    }
 
-    _elapsed += tmr.elapsed();
-    _frameCount++;
+    auto animationsUpdated = std::chrono::steady_clock::now();
+    timing.updateAnimationsInMilliseconds = millisecondsBetween(frameStart, animationsUpdated);
 
     // if a manipulator is active, update the active camera orientation
     if (_manipulator)
@@ -987,7 +1065,33 @@ namespace polyvox
       math::double3 eye, target, upward;
       Camera &cam = _view->getCamera();
       _manipulator->getLookAt(&eye, &target, &upward);
-      cam.lookAt(eye, target, upward);
+      if (eye != _lastEye || target != _lastTarget || upward != _lastUpward)
+      {
+        cam.lookAt(eye, target, upward);
+        _lastEye = eye;
+        _lastTarget = target;
+        _lastUpward = upward;
+        reasons |= RENDER_REASON_MANIPULATOR;
+      }
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    timing.manipulatorInMilliseconds = millisecondsBetween(animationsUpdated, now);
+
+    if (!_onDemandRendering)
+    {
+      reasons |= RENDER_REASON_CONTINUOUS;
+    }
+    else if (reasons == RENDER_REASON_NONE && _idleFrameRate > 0 &&
+             std::chrono::duration<float>(now - _lastRenderTime).count() >= 1.0f / _idleFrameRate)
+    {
+      reasons |= RENDER_REASON_IDLE;
+    }
+
+    if (reasons == RENDER_REASON_NONE)
+    {
+      deliverPickResults();
+      return false;
     }
 
     // // TODO - this was an experiment but probably useful to keep for debugging
@@ -1007,22 +1111,46 @@ namespace polyvox
     // else
     // {
     // Render the scene, unless the renderer wants to skip the frame.
-    if (_renderer->beginFrame(_swapChain, frameTimeInNanos))
+    timing.renderReasons = reasons;
+    TRACE_BEGIN(beginFrame, "Renderer::beginFrame", "render");
+    bool rendered = _renderer->beginFrame(_swapChain, frameTimeInNanos);
+    TRACE_END(beginFrame);
+    auto frameBegun = std::chrono::steady_clock::now();
+    timing.beginFrameInMilliseconds = millisecondsBetween(now, frameBegun);
+    if (rendered)
     {
+      TRACE_BEGIN(render, "Renderer::render", "render");
+      submitPicks();
       _renderer->render(_view);
+      TRACE_END(render);
+      auto viewRendered = std::chrono::steady_clock::now();
+      TRACE_BEGIN(endFrame, "Renderer::endFrame", "render");
       _renderer->endFrame();
+      TRACE_END(endFrame);
+      auto frameEnded = std::chrono::steady_clock::now();
+      timing.renderInMilliseconds = millisecondsBetween(frameBegun, viewRendered);
+      timing.endFrameInMilliseconds = millisecondsBetween(viewRendered, frameEnded);
+      timing.totalInMilliseconds = millisecondsBetween(frameStart, frameEnded);
+      _lastRenderTime = now;
+      _lastRenderReasons = reasons;
     }
     else
     {
-      // std::cout << "Skipped" << std::endl;
-      // skipped frame
+      // skipped frame, so carry the reasons over to the next frame
+      _dirtyReasons |= reasons & ~(RENDER_REASON_CONTINUOUS | RENDER_REASON_IDLE);
+      timing.skipped = 1;
+      timing.totalInMilliseconds = millisecondsBetween(frameStart, frameBegun);
     }
+    _frameTimings.push(timing);
+    deliverPickResults();
+    return rendered;
     // }
   }
 
   void FilamentViewer::updateViewportAndCameraProjection(
       int width, int height, float contentScaleFactor)
   {
+    markDirty(RENDER_REASON_VIEW);
     if (!_view || !_mainCamera)
     {
       Log("Skipping camera update, no view or camrea");
@@ -1047,11 +1175,13 @@ namespace polyvox
 
   void FilamentViewer::setViewFrustumCulling(bool enabled)
   {
+    markDirty(RENDER_REASON_VIEW);
     _view->setFrustumCullingEnabled(enabled);
   }
 
   void FilamentViewer::setCameraPosition(float x, float y, float z)
   {
+    markDirty(RENDER_REASON_CAMERA);
     Camera &cam = _view->getCamera();
 
     _cameraPosition = math::mat4f::translation(math::float3(x, y, z));
@@ -1060,14 +1190,15 @@ namespace polyvox
 
   void FilamentViewer::moveCameraToAsset(EntityId entityId)
   {
-    auto asset = _assetManager->getAssetByEntityId(entityId);
-    if (!asset)
+    markDirty(RENDER_REASON_CAMERA);
+    auto instance = _assetManager->getInstanceByEntityId(entityId);
+    if (!instance)
     {
       Log("Failed to find asset attached to specified entity id.");
       return;
     }
 
-    const filament::Aabb bb = asset->getBoundingBox();
+    const filament::Aabb bb = instance->getBoundingBox();
     auto corners = bb.getCorners();
     Camera &cam = _view->getCamera();
     auto eye = corners.vertices[0] * 1.5;
@@ -1078,6 +1209,7 @@ namespace polyvox
 
   void FilamentViewer::setCameraRotation(float rads, float x, float y, float z)
   {
+    markDirty(RENDER_REASON_CAMERA);
     Camera &cam = _view->getCamera();
     _cameraRotation = math::mat4f::rotation(rads, math::float3(x, y, z));
     cam.setModelMatrix(_cameraPosition * _cameraRotation);
@@ -1085,6 +1217,7 @@ namespace polyvox
 
   void FilamentViewer::setCameraModelMatrix(const float *const matrix)
   {
+    markDirty(RENDER_REASON_CAMERA);
     Camera &cam = _view->getCamera();
 
     mat4 modelMatrix(
@@ -1109,6 +1242,7 @@ namespace polyvox
 
   void FilamentViewer::setCameraProjectionMatrix(const double *const matrix, double near, double far)
   {
+    markDirty(RENDER_REASON_CAMERA);
     Camera &cam = _view->getCamera();
 
     mat4 projectionMatrix(
@@ -1190,6 +1324,7 @@ namespace polyvox
 
   void FilamentViewer::setCameraManipulatorOptions(filament::camutils::Mode mode, double orbitSpeedX, double orbitSpeedY, double zoomSpeed)
   {
+    markDirty(RENDER_REASON_CAMERA);
     _manipulatorMode = mode;
     _orbitSpeedX = orbitSpeedX;
     _orbitSpeedY = orbitSpeedY;
@@ -1198,6 +1333,7 @@ namespace polyvox
 
   void FilamentViewer::grabBegin(float x, float y, bool pan)
   {
+    markDirty(RENDER_REASON_MANIPULATOR);
     if (!_view || !_mainCamera || !_swapChain)
     {
       Log("View not ready, ignoring grab");
@@ -1221,6 +1357,7 @@ namespace polyvox
 
   void FilamentViewer::grabUpdate(float x, float y)
   {
+    markDirty(RENDER_REASON_MANIPULATOR);
     if (!_view || !_swapChain)
     {
       Log("View not ready, ignoring grab");
@@ -1239,6 +1376,7 @@ namespace polyvox
 
   void FilamentViewer::grabEnd()
   {
+    markDirty(RENDER_REASON_MANIPULATOR);
     if (!_view || !_mainCamera || !_swapChain)
     {
       Log("View not ready, ignoring grab");
@@ -1258,6 +1396,7 @@ namespace polyvox
 
   void FilamentViewer::scrollBegin()
   {
+    markDirty(RENDER_REASON_MANIPULATOR);
     if (!_manipulator)
     {
       _createManipulator();
@@ -1266,6 +1405,7 @@ namespace polyvox
 
   void FilamentViewer::scrollUpdate(float x, float y, float delta)
   {
+    markDirty(RENDER_REASON_MANIPULATOR);
     if (_manipulator)
     {
       _manipulator->scroll(int(x), int(y), delta);
@@ -1278,14 +1418,131 @@ namespace polyvox
 
   void FilamentViewer::scrollEnd()
   {
+    markDirty(RENDER_REASON_MANIPULATOR);
     delete _manipulator;
     _manipulator = nullptr;
   }
 
+  ///
+  /// Writes the renderable at (x,y) to [entityId] (0 if there is none).
+  /// View::pick only resolves after the next frame has been rendered, so this uses the CPU ray caster to return the result immediately.
+  ///
   void FilamentViewer::pick(uint32_t x, uint32_t y, EntityId *entityId)
+  {
+    RaycastHit hit;
+    raycast(static_cast<float>(x), static_cast<float>(y), &hit);
+    *entityId = hit.entity;
+  }
+
+  ///
+  /// Queues a GPU pick for each of the [count] points (x,y pairs in viewport coordinates, origin at the bottom-left) in [points],
+  /// assigning consecutive request IDs starting at [firstRequestId].
+  /// If [channel] is non-zero, any requests on the same channel that haven't yet been submitted to the GPU are discarded,
+  /// so a pointer moving faster than frames are rendered only ever has its latest position picked.
+  ///
+  void FilamentViewer::queuePicks(const int32_t *points, int count, uint32_t channel, uint32_t firstRequestId)
+  {
+    if (channel != 0)
+    {
+      _pendingPicks.erase(std::remove_if(_pendingPicks.begin(), _pendingPicks.end(), [=](const PickRequest &request)
+                                         { return request.channel == channel; }),
+                          _pendingPicks.end());
+    }
+    for (int i = 0; i < count; i++)
+    {
+      _pendingPicks.push_back({firstRequestId + i, channel, points[i * 2], points[i * 2 + 1]});
+    }
+    markDirty(RENDER_REASON_REQUESTED);
+  }
+
+  ///
+  /// Issues every pending pick request against the frame about to be rendered.
+  ///
+  void FilamentViewer::submitPicks()
+  {
+    if (!_pendingPicks.empty())
+    {
+      _pickFramesWaiting = 0;
+    }
+    for (const auto &request : _pendingPicks)
+    {
+      _picksInFlight++;
+      _view->pick(request.x, request.y, [this, request, generation = _pickGeneration](filament::View::PickingQueryResult const &result)
+                  {
+                    // a late result for an abandoned pick is still delivered, but was already dropped from the count
+                    if (generation == _pickGeneration)
+                    {
+                      _picksInFlight--;
+                    }
+                    _pickResults.push_back({request.requestId,
+                                            request.channel,
+                                            Entity::smuggle(result.renderable),
+                                            result.depth,
+                                            {result.fragCoords.x, result.fragCoords.y, result.fragCoords.z},
+                                            request.x,
+                                            request.y}); });
+    }
+    _pendingPicks.clear();
+  }
+
+  ///
+  /// Stops waiting for any submitted picks (see kMaxPickWaitFrames), so they no longer keep the view rendering.
+  ///
+  void FilamentViewer::abandonPicks()
+  {
+    _pickGeneration++;
+    _picksInFlight = 0;
+    _pickFramesWaiting = 0;
+  }
+
+  void FilamentViewer::deliverPickResults()
+  {
+    if (_pickResults.empty())
+    {
+      return;
+    }
+    if (_pickResultsCallback)
+    {
+      _pickResultsCallback(_pickResults.data(), static_cast<int32_t>(_pickResults.size()));
+    }
+    _pickResults.clear();
+  }
+
+  ///
+  /// Casts a ray from the active camera through (x,y), in viewport coordinates with the origin at the bottom-left (as for pick).
+  ///
+  bool FilamentViewer::raycast(float x, float y, RaycastHit *out)
+  {
+    const Viewport &vp = _view->getViewport();
+    if (vp.width == 0 || vp.height == 0)
+    {
+      Log("Can't raycast with an empty viewport");
+      *out = {};
+      return false;
+    }
+    Camera &cam = _view->getCamera();
+    double ndcX = 2.0 * x / vp.width - 1.0;
+    double ndcY = 2.0 * y / vp.height - 1.0;
+    auto clipToWorld = cam.getModelMatrix() * inverse(cam.getProjectionMatrix());
+    auto unproject = [&](double ndcZ)
+    {
+      math::double4 p = clipToWorld * math::double4(ndcX, ndcY, ndcZ, 1.0);
+      return p.xyz / p.w;
+    };
+    // the projection used for rendering has its far plane at infinity, so take the direction from the near plane to z=0
+    math::double3 near = unproject(-1.0);
+    math::double3 direction = unproject(0.0) - near;
+    return _assetManager->raycast(math::float3(near), math::float3(direction), out);
+  }
+
+  ///
+  /// Picks the renderable at (x,y) and invokes [callback] with the result.
+  /// The callback is invoked on the render thread once the pick query has been resolved (usually a frame or two later).
+  ///
+  void FilamentViewer::pick(uint32_t x, uint32_t y, void (*callback)(EntityId entityId, int x, int y))
   {
     _view->pick(x, y, [=](filament::View::PickingQueryResult const &result)
-                { *entityId = Entity::smuggle(result.renderable); });
+                { callback(Entity::smuggle(result.renderable), x, y); });
   }
 
 } // namespace polyvox
@@ -4,6 +4,7 @@
 #include "filament/LightManager.h"
 #include "Log.hpp"
 #include "ThreadPool.hpp"
+#include "Trace.hpp"
 
 #include <thread>
 #include <functional>
@@ -17,72 +18,86 @@ extern "C"
 
     FLUTTER_PLUGIN_EXPORT const void *create_filament_viewer(const void *context, const ResourceLoaderWrapper *const loader, void *const platform, const char *uberArchivePath)
     {
+        TRACE_FUNCTION("api");
         return (const void *)new FilamentViewer(context, loader, platform, uberArchivePath);
     }
 
     FLUTTER_PLUGIN_EXPORT ResourceLoaderWrapper *make_resource_loader(LoadFilamentResourceFromOwner loadFn, FreeFilamentResourceFromOwner freeFn, void *const owner)
     {
+        TRACE_FUNCTION("api");
         return new ResourceLoaderWrapper(loadFn, freeFn, owner);
     }
 
     FLUTTER_PLUGIN_EXPORT void create_render_target(const void *const viewer, intptr_t texture, uint32_t width, uint32_t height)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->createRenderTarget(texture, width, height);
     }
 
     FLUTTER_PLUGIN_EXPORT void destroy_filament_viewer(const void *const viewer)
     {
+        TRACE_FUNCTION("api");
         delete ((FilamentViewer *)viewer);
     }
 
     FLUTTER_PLUGIN_EXPORT void set_background_color(const void *const viewer, const float r, const float g, const float b, const float a)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->setBackgroundColor(r, g, b, a);
     }
 
     FLUTTER_PLUGIN_EXPORT void clear_background_image(const void *const viewer)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->clearBackgroundImage();
     }
 
     FLUTTER_PLUGIN_EXPORT void set_background_image(const void *const viewer, const char *path, bool fillHeight)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->setBackgroundImage(path, fillHeight);
     }
 
     FLUTTER_PLUGIN_EXPORT void set_background_image_position(const void *const viewer, float x, float y, bool clamp)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->setBackgroundImagePosition(x, y, clamp);
     }
 
     FLUTTER_PLUGIN_EXPORT void set_tone_mapping(const void *const viewer, int toneMapping)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->setToneMapping((ToneMapping)toneMapping);
     }
 
     FLUTTER_PLUGIN_EXPORT void set_bloom(const void *const viewer, float strength)
     {
+        TRACE_FUNCTION("api");
         Log("Setting bloom to %f", strength);
         ((FilamentViewer *)viewer)->setBloom(strength);
     }
 
     FLUTTER_PLUGIN_EXPORT void load_skybox(const void *const viewer, const char *skyboxPath)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->loadSkybox(skyboxPath);
     }
 
     FLUTTER_PLUGIN_EXPORT void load_ibl(const void *const viewer, const char *iblPath, float intensity)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->loadIbl(iblPath, intensity);
     }
 
     FLUTTER_PLUGIN_EXPORT void remove_skybox(const void *const viewer)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->removeSkybox();
     }
 
     FLUTTER_PLUGIN_EXPORT void remove_ibl(const void *const viewer)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->removeIbl();
     }
 
@@ -93,26 +108,79 @@ extern "C"
 
     FLUTTER_PLUGIN_EXPORT void remove_light(const void *const viewer, int32_t entityId)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->removeLight(entityId);
     }
 
     FLUTTER_PLUGIN_EXPORT void clear_lights(const void *const viewer)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->clearLights();
     }
 
     FLUTTER_PLUGIN_EXPORT EntityId load_glb(void *assetManager, const char *assetPath, bool unlit)
     {
+        TRACE_FUNCTION("api");
         return ((AssetManager *)assetManager)->loadGlb(assetPath, unlit);
     }
 
+    FLUTTER_PLUGIN_EXPORT int load_glb_instanced(void *assetManager, const char *assetPath, int numInstances, EntityId *out)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->loadGlbInstanced(assetPath, numInstances, out);
+    }
+
+    FLUTTER_PLUGIN_EXPORT EntityId create_instance(void *assetManager, EntityId entityId)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->createInstance(entityId);
+    }
+
+    FLUTTER_PLUGIN_EXPORT void set_asset_cache_budget(void *assetManager, uint64_t budgetInBytes)
+    {
+        TRACE_FUNCTION("api");
+        ((AssetManager *)assetManager)->setAssetCacheBudget(budgetInBytes);
+    }
+
+    FLUTTER_PLUGIN_EXPORT void get_asset_cache_stats(void *assetManager, AssetCacheStats *out)
+    {
+        TRACE_FUNCTION("api");
+        ((AssetManager *)assetManager)->getAssetCacheStats(out);
+    }
+
     FLUTTER_PLUGIN_EXPORT EntityId load_gltf(void *assetManager, const char *assetPath, const char *relativePath)
     {
+        TRACE_FUNCTION("api");
         return ((AssetManager *)assetManager)->loadGltf(assetPath, relativePath);
     }
 
+    FLUTTER_PLUGIN_EXPORT EntityId load_glb_async(void *assetManager, const char *assetPath, AssetLoadCallback callback)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->loadGlbAsync(assetPath, callback);
+    }
+
+    FLUTTER_PLUGIN_EXPORT EntityId load_gltf_async(void *assetManager, const char *assetPath, const char *relativePath, AssetLoadCallback callback)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->loadGltfAsync(assetPath, relativePath, callback);
+    }
+
+    FLUTTER_PLUGIN_EXPORT bool get_load_progress(void *assetManager, EntityId asset, AssetLoadProgress *out)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->getLoadProgress(asset, out);
+    }
+
+    FLUTTER_PLUGIN_EXPORT bool cancel_load(void *assetManager, EntityId asset)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->cancelLoad(asset);
+    }
+
     FLUTTER_PLUGIN_EXPORT bool set_camera(const void *const viewer, EntityId asset, const char *nodeName)
     {
+        TRACE_FUNCTION("api");
         return ((FilamentViewer *)viewer)->setCamera(asset, nodeName);
     }
 
@@ -170,113 +238,204 @@ extern "C"
 
     FLUTTER_PLUGIN_EXPORT void set_camera_manipulator_options(const void *const viewer, _ManipulatorMode mode, double orbitSpeedX, double orbitSpeedY, double zoomSpeed)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->setCameraManipulatorOptions((filament::camutils::Mode)mode, orbitSpeedX, orbitSpeedY, zoomSpeed);
     }
 
     FLUTTER_PLUGIN_EXPORT void set_view_frustum_culling(const void *const viewer, bool enabled)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->setViewFrustumCulling(enabled);
     }
 
     FLUTTER_PLUGIN_EXPORT void move_camera_to_asset(const void *const viewer, EntityId asset)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->moveCameraToAsset(asset);
     }
 
     FLUTTER_PLUGIN_EXPORT void set_camera_focus_distance(const void *const viewer, float distance)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->setCameraFocusDistance(distance);
     }
 
     FLUTTER_PLUGIN_EXPORT void set_camera_exposure(const void *const viewer, float aperture, float shutterSpeed, float sensitivity)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->setCameraExposure(aperture, shutterSpeed, sensitivity);
     }
 
     FLUTTER_PLUGIN_EXPORT void set_camera_position(const void *const viewer, float x, float y, float z)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->setCameraPosition(x, y, z);
     }
 
     FLUTTER_PLUGIN_EXPORT void set_camera_rotation(const void *const viewer, float rads, float x, float y, float z)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->setCameraRotation(rads, x, y, z);
     }
 
     FLUTTER_PLUGIN_EXPORT void set_camera_model_matrix(const void *const viewer, const float *const matrix)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->setCameraModelMatrix(matrix);
     }
 
     FLUTTER_PLUGIN_EXPORT void set_camera_focal_length(const void *const viewer, float focalLength)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->setCameraFocalLength(focalLength);
     }
 
-    FLUTTER_PLUGIN_EXPORT void render(
+    FLUTTER_PLUGIN_EXPORT bool render(
         const void *const viewer,
         uint64_t frameTimeInNanos,
         void *pixelBuffer,
         void (*callback)(void *buf, size_t size, void *data),
         void *data)
     {
-        ((FilamentViewer *)viewer)->render(frameTimeInNanos, pixelBuffer, callback, data);
+        TRACE_FUNCTION("api");
+        return ((FilamentViewer *)viewer)->render(frameTimeInNanos, pixelBuffer, callback, data);
     }
 
     FLUTTER_PLUGIN_EXPORT void set_frame_interval(
         const void *const viewer,
         float frameInterval)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->setFrameInterval(frameInterval);
     }
 
+    FLUTTER_PLUGIN_EXPORT void set_refresh_rate(
+        const void *const viewer,
+        float refreshRate)
+    {
+        TRACE_FUNCTION("api");
+        ((FilamentViewer *)viewer)->setRefreshRate(refreshRate);
+    }
+
+    FLUTTER_PLUGIN_EXPORT void set_on_demand_rendering(
+        const void *const viewer,
+        bool enabled,
+        float idleFrameRate)
+    {
+        TRACE_FUNCTION("api");
+        ((FilamentViewer *)viewer)->setOnDemandRendering(enabled, idleFrameRate);
+    }
+
+    FLUTTER_PLUGIN_EXPORT void request_frame(const void *const viewer)
+    {
+        TRACE_FUNCTION("api");
+        ((FilamentViewer *)viewer)->markDirty(RENDER_REASON_REQUESTED);
+    }
+
+    FLUTTER_PLUGIN_EXPORT uint32_t get_last_render_reasons(const void *const viewer)
+    {
+        TRACE_FUNCTION("api");
+        return ((FilamentViewer *)viewer)->getLastRenderReasons();
+    }
+
+    ///
+    /// Starts recording trace events (see Trace.hpp), keeping at most the last [maxEvents].
+    /// Returns false if tracing was not compiled in (FLUTTER_FILAMENT_TRACING) or is already running.
+    ///
+    FLUTTER_PLUGIN_EXPORT bool start_tracing(const char *outputPath, int maxEvents)
+    {
+#ifdef FLUTTER_FILAMENT_TRACING
+        return maxEvents > 0 && Tracer::start(outputPath, maxEvents);
+#else
+        Log("Tracing is not enabled in this build (define FLUTTER_FILAMENT_TRACING)");
+        return false;
+#endif
+    }
+
+    ///
+    /// Stops recording and writes all recorded trace events to the path passed to [start_tracing] in Chrome trace-event JSON format.
+    ///
+    FLUTTER_PLUGIN_EXPORT bool stop_tracing()
+    {
+#ifdef FLUTTER_FILAMENT_TRACING
+        return Tracer::stop();
+#else
+        Log("Tracing is not enabled in this build (define FLUTTER_FILAMENT_TRACING)");
+        return false;
+#endif
+    }
+
+    ///
+    /// Copies up to [maxRecords] of the most recent frame timings (oldest first) into [out] and returns the number copied.
+    /// This never blocks the render thread, so it is safe to call from any thread.
+    ///
+    FLUTTER_PLUGIN_EXPORT int get_frame_timings(const void *const viewer, FrameTimingRecord *out, int maxRecords)
+    {
+        TRACE_FUNCTION("api");
+        if (maxRecords <= 0)
+        {
+            return 0;
+        }
+        return (int)((FilamentViewer *)viewer)->getFrameTimings(out, maxRecords);
+    }
+
     FLUTTER_PLUGIN_EXPORT void destroy_swap_chain(const void *const viewer)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->destroySwapChain();
     }
 
     FLUTTER_PLUGIN_EXPORT void create_swap_chain(const void *const viewer, const void *const window, uint32_t width, uint32_t height)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->createSwapChain(window, width, height);
     }
 
     FLUTTER_PLUGIN_EXPORT void update_viewport_and_camera_projection(const void *const viewer, uint32_t width, uint32_t height, float scaleFactor)
     {
+        TRACE_FUNCTION("api");
         return ((FilamentViewer *)viewer)->updateViewportAndCameraProjection(width, height, scaleFactor);
     }
 
     FLUTTER_PLUGIN_EXPORT void scroll_update(const void *const viewer, float x, float y, float delta)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->scrollUpdate(x, y, delta);
     }
 
     FLUTTER_PLUGIN_EXPORT void scroll_begin(const void *const viewer)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->scrollBegin();
     }
 
     FLUTTER_PLUGIN_EXPORT void scroll_end(const void *const viewer)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->scrollEnd();
     }
 
     FLUTTER_PLUGIN_EXPORT void grab_begin(const void *const viewer, float x, float y, bool pan)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->grabBegin(x, y, pan);
     }
 
     FLUTTER_PLUGIN_EXPORT void grab_update(const void *const viewer, float x, float y)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->grabUpdate(x, y);
     }
 
     FLUTTER_PLUGIN_EXPORT void grab_end(const void *const viewer)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->grabEnd();
     }
 
     FLUTTER_PLUGIN_EXPORT void *get_asset_manager(const void *const viewer)
     {
+        TRACE_FUNCTION("api");
         return (void *)((FilamentViewer *)viewer)->getAssetManager();
     }
 
@@ -287,6 +446,7 @@ extern "C"
         float *const weights,
         int count)
     {
+        TRACE_FUNCTION("api");
         // ((AssetManager*)assetManager)->setMorphTargetWeights(asset, entityName, weights, count);
     }
 
@@ -297,10 +457,34 @@ extern "C"
         const float *const weights,
         const int numWeights)
     {
+        TRACE_FUNCTION("api");
 
         return ((AssetManager *)assetManager)->setMorphTargetWeights(asset, entityName, weights, numWeights);
     }
 
+    FLUTTER_PLUGIN_EXPORT void set_morph_target_weights_by_id(
+        void *assetManager,
+        EntityId asset,
+        uint32_t entityNameId,
+        const float *const weights,
+        const int numWeights)
+    {
+        TRACE_FUNCTION("api");
+        ((AssetManager *)assetManager)->setMorphTargetWeights(asset, entityNameId, weights, numWeights);
+    }
+
+    FLUTTER_PLUGIN_EXPORT uint32_t get_name_id(void *assetManager, const char *name)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->getNameId(name);
+    }
+
+    FLUTTER_PLUGIN_EXPORT int get_morph_target_index(void *assetManager, EntityId asset, uint32_t entityNameId, uint32_t morphTargetNameId)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->getMorphTargetIndex(asset, entityNameId, morphTargetNameId);
+    }
+
     bool set_morph_animation(
         void *assetManager,
         EntityId asset,
@@ -326,11 +510,68 @@ extern "C"
         int numMeshTargets,
         float frameLengthInMs)
     {
+        TRACE_FUNCTION("api");
         ((AssetManager *)assetManager)->setBoneAnimationBuffer(asset, frameData, numFrames, numBones, boneNames, meshNames, numMeshTargets, frameLengthInMs);
     }
 
+    FLUTTER_PLUGIN_EXPORT int add_bone_animation_clip(
+        void *assetManager,
+        EntityId asset,
+        const float *const frameData,
+        int numFrames,
+        int numBones,
+        const char **const boneNames,
+        float frameLengthInMs)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->addBoneAnimationClip(asset, frameData, numFrames, numBones, boneNames, frameLengthInMs);
+    }
+
+    FLUTTER_PLUGIN_EXPORT int add_bone_animation_layer(void *assetManager, EntityId asset, int clipIndex, float weight, bool additive, bool loop)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->addBoneAnimationLayer(asset, clipIndex, weight, additive, loop);
+    }
+
+    FLUTTER_PLUGIN_EXPORT bool set_bone_animation_layer_weight(void *assetManager, EntityId asset, int layerIndex, float weight)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->setBoneAnimationLayerWeight(asset, layerIndex, weight);
+    }
+
+    FLUTTER_PLUGIN_EXPORT bool set_bone_animation_layer_mask(void *assetManager, EntityId asset, int layerIndex, const char **const boneNames, const float *const weights, int count)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->setBoneAnimationLayerMask(asset, layerIndex, boneNames, weights, count);
+    }
+
+    FLUTTER_PLUGIN_EXPORT bool remove_bone_animation_layer(void *assetManager, EntityId asset, int layerIndex)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->removeBoneAnimationLayer(asset, layerIndex);
+    }
+
+    FLUTTER_PLUGIN_EXPORT void clear_bone_animation_layers(void *assetManager, EntityId asset)
+    {
+        TRACE_FUNCTION("api");
+        ((AssetManager *)assetManager)->clearBoneAnimationLayers(asset);
+    }
+
+    FLUTTER_PLUGIN_EXPORT void set_bone_animation_tolerance(void *assetManager, float rotationTolerance, float translationTolerance)
+    {
+        TRACE_FUNCTION("api");
+        ((AssetManager *)assetManager)->setBoneAnimationTolerance(rotationTolerance, translationTolerance);
+    }
+
+    FLUTTER_PLUGIN_EXPORT bool get_bone_animation_stats(void *assetManager, EntityId asset, BoneAnimationStats *out)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->getBoneAnimationStats(asset, out);
+    }
+
     FLUTTER_PLUGIN_EXPORT void set_post_processing(void *const viewer, bool enabled)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->setPostProcessing(enabled);
     }
 
@@ -370,6 +611,7 @@ extern "C"
         bool replaceActive,
         float crossfade)
     {
+        TRACE_FUNCTION("api");
         ((AssetManager *)assetManager)->playAnimation(asset, index, loop, reverse, replaceActive, crossfade);
     }
 
@@ -379,6 +621,7 @@ extern "C"
         int animationIndex,
         int animationFrame)
     {
+        TRACE_FUNCTION("api");
         // ((AssetManager*)assetManager)->setAnimationFrame(asset, animationIndex, animationFrame);
     }
 
@@ -401,6 +644,7 @@ extern "C"
         char *const outPtr,
         int index)
     {
+        TRACE_FUNCTION("api");
         auto names = ((AssetManager *)assetManager)->getAnimationNames(asset);
         string name = names->at(index);
         strcpy(outPtr, name.c_str());
@@ -408,24 +652,72 @@ extern "C"
 
     FLUTTER_PLUGIN_EXPORT int get_morph_target_name_count(void *assetManager, EntityId asset, const char *meshName)
     {
+        TRACE_FUNCTION("api");
         unique_ptr<vector<string>> names = ((AssetManager *)assetManager)->getMorphTargetNames(asset, meshName);
         return (int)names->size();
     }
 
     FLUTTER_PLUGIN_EXPORT void get_morph_target_name(void *assetManager, EntityId asset, const char *meshName, char *const outPtr, int index)
     {
+        TRACE_FUNCTION("api");
         unique_ptr<vector<string>> names = ((AssetManager *)assetManager)->getMorphTargetNames(asset, meshName);
         string name = names->at(index);
         strcpy(outPtr, name.c_str());
     }
 
+    ///
+    /// Writes a description of the asset's node hierarchy, animations and skins (see ASSET_DESCRIPTION_MAGIC for the layout) to [out].
+    /// Returns the size of the description in bytes (or -1 if the asset doesn't exist); nothing is written if this exceeds [capacity],
+    /// so pass a null buffer to query the required size.
+    ///
+    FLUTTER_PLUGIN_EXPORT int describe_asset(void *assetManager, EntityId asset, uint8_t *out, int capacity)
+    {
+        TRACE_FUNCTION("api");
+        vector<uint8_t> description;
+        if (!((AssetManager *)assetManager)->describe(asset, description))
+        {
+            return -1;
+        }
+        if (out && description.size() <= (size_t)capacity)
+        {
+            memcpy(out, description.data(), description.size());
+        }
+        return (int)description.size();
+    }
+
+    ///
+    /// As per describe_asset, but the buffer is allocated natively and must be freed with free_asset_description.
+    /// Returns nullptr if the asset doesn't exist.
+    ///
+    FLUTTER_PLUGIN_EXPORT uint8_t *describe_asset_alloc(void *assetManager, EntityId asset, int *outLength)
+    {
+        TRACE_FUNCTION("api");
+        vector<uint8_t> description;
+        if (!((AssetManager *)assetManager)->describe(asset, description))
+        {
+            *outLength = 0;
+            return nullptr;
+        }
+        auto out = (uint8_t *)malloc(description.size());
+        memcpy(out, description.data(), description.size());
+        *outLength = (int)description.size();
+        return out;
+    }
+
+    FLUTTER_PLUGIN_EXPORT void free_asset_description(uint8_t *description)
+    {
+        free(description);
+    }
+
     FLUTTER_PLUGIN_EXPORT void remove_asset(const void *const viewer, EntityId asset)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->removeAsset(asset);
     }
 
     FLUTTER_PLUGIN_EXPORT void clear_assets(const void *const viewer)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->clearAssets();
     }
 
@@ -434,48 +726,174 @@ extern "C"
         return ((AssetManager *)assetManager)->setMaterialColor(asset, meshName, materialIndex, r, g, b, a);
     }
 
+    FLUTTER_PLUGIN_EXPORT bool set_material_color_by_id(void *assetManager, EntityId asset, uint32_t meshNameId, int materialIndex, const float r, const float g, const float b, const float a)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->setMaterialColor(asset, meshNameId, materialIndex, r, g, b, a);
+    }
+
     FLUTTER_PLUGIN_EXPORT void transform_to_unit_cube(void *assetManager, EntityId asset)
     {
+        TRACE_FUNCTION("api");
         ((AssetManager *)assetManager)->transformToUnitCube(asset);
     }
 
     FLUTTER_PLUGIN_EXPORT void set_position(void *assetManager, EntityId asset, float x, float y, float z)
     {
+        TRACE_FUNCTION("api");
         ((AssetManager *)assetManager)->setPosition(asset, x, y, z);
     }
 
+    FLUTTER_PLUGIN_EXPORT int set_transforms(void *assetManager, const EntityId *assets, const float *positions, const float *rotations, const float *scales, int count)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->setTransforms(assets, positions, rotations, scales, count);
+    }
+
+    FLUTTER_PLUGIN_EXPORT int set_transform_matrices(void *assetManager, const EntityId *assets, const float *matrices, int count)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->setTransforms(assets, matrices, count);
+    }
+
     FLUTTER_PLUGIN_EXPORT void set_rotation(void *assetManager, EntityId asset, float rads, float x, float y, float z)
     {
+        TRACE_FUNCTION("api");
         ((AssetManager *)assetManager)->setRotation(asset, rads, x, y, z);
     }
 
     FLUTTER_PLUGIN_EXPORT void set_scale(void *assetManager, EntityId asset, float scale)
     {
+        TRACE_FUNCTION("api");
         ((AssetManager *)assetManager)->setScale(asset, scale);
     }
 
     FLUTTER_PLUGIN_EXPORT void stop_animation(void *assetManager, EntityId asset, int index)
     {
+        TRACE_FUNCTION("api");
         ((AssetManager *)assetManager)->stopAnimation(asset, index);
     }
 
+    FLUTTER_PLUGIN_EXPORT void set_animation_thread_count(void *assetManager, int count)
+    {
+        TRACE_FUNCTION("api");
+        ((AssetManager *)assetManager)->setAnimationThreadCount(count);
+    }
+
+    FLUTTER_PLUGIN_EXPORT void set_animation_bake_rate(void *assetManager, float samplesPerSecond)
+    {
+        TRACE_FUNCTION("api");
+        ((AssetManager *)assetManager)->setAnimationBakeRate(samplesPerSecond);
+    }
+
+    FLUTTER_PLUGIN_EXPORT void get_animation_stats(void *assetManager, AnimationStats *out)
+    {
+        TRACE_FUNCTION("api");
+        ((AssetManager *)assetManager)->getAnimationStats(out);
+    }
+
     FLUTTER_PLUGIN_EXPORT int hide_mesh(void *assetManager, EntityId asset, const char *meshName)
     {
+        TRACE_FUNCTION("api");
         return ((AssetManager *)assetManager)->hide(asset, meshName);
     }
 
     FLUTTER_PLUGIN_EXPORT int reveal_mesh(void *assetManager, EntityId asset, const char *meshName)
     {
+        TRACE_FUNCTION("api");
         return ((AssetManager *)assetManager)->reveal(asset, meshName);
     }
 
+    FLUTTER_PLUGIN_EXPORT int hide_mesh_by_id(void *assetManager, EntityId asset, uint32_t meshNameId)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->hide(asset, meshNameId);
+    }
+
+    FLUTTER_PLUGIN_EXPORT int reveal_mesh_by_id(void *assetManager, EntityId asset, uint32_t meshNameId)
+    {
+        TRACE_FUNCTION("api");
+        return ((AssetManager *)assetManager)->reveal(asset, meshNameId);
+    }
+
     FLUTTER_PLUGIN_EXPORT void pick(void *const viewer, int x, int y, EntityId *entityId)
     {
+        TRACE_FUNCTION("api");
         ((FilamentViewer *)viewer)->pick(static_cast<uint32_t>(x), static_cast<uint32_t>(y), static_cast<int32_t *>(entityId));
     }
 
+    FLUTTER_PLUGIN_EXPORT void set_pick_results_callback(void *const viewer, PickResultsCallback callback)
+    {
+        TRACE_FUNCTION("api");
+        ((FilamentViewer *)viewer)->setPickResultsCallback(callback);
+    }
+
+    FLUTTER_PLUGIN_EXPORT uint32_t queue_pick(void *const viewer, int x, int y, uint32_t channel)
+    {
+        TRACE_FUNCTION("api");
+        int32_t point[2] = {x, y};
+        return queue_picks(viewer, point, 1, channel);
+    }
+
+    ///
+    /// Queues a GPU pick for each of the [count] points (x,y pairs) in [points].
+    /// Returns the request ID of the first point; the others are numbered consecutively.
+    ///
+    FLUTTER_PLUGIN_EXPORT uint32_t queue_picks(void *const viewer, const int32_t *points, int count, uint32_t channel)
+    {
+        TRACE_FUNCTION("api");
+        auto fv = (FilamentViewer *)viewer;
+        uint32_t firstRequestId = fv->reservePickRequestIds(count);
+        fv->queuePicks(points, count, channel, firstRequestId);
+        return firstRequestId;
+    }
+
+    FLUTTER_PLUGIN_EXPORT bool raycast(void *const viewer, float originX, float originY, float originZ, float directionX, float directionY, float directionZ, RaycastHit *out)
+    {
+        TRACE_FUNCTION("api");
+        return ((FilamentViewer *)viewer)->getAssetManager()->raycast(math::float3(originX, originY, originZ), math::float3(directionX, directionY, directionZ), out);
+    }
+
+    ///
+    /// Casts [count] rays, each given as 6 floats in [rays] (origin xyz, direction xyz), writing one hit per ray to [out].
+    /// Returns the number of rays that hit something.
+    ///
+    FLUTTER_PLUGIN_EXPORT int raycast_batch(void *const viewer, const float *rays, int count, RaycastHit *out)
+    {
+        TRACE_FUNCTION("api");
+        auto assetManager = ((FilamentViewer *)viewer)->getAssetManager();
+        int hits = 0;
+        for (int i = 0; i < count; i++)
+        {
+            const float *ray = rays + i * 6;
+            hits += assetManager->raycast(math::float3(ray[0], ray[1], ray[2]), math::float3(ray[3], ray[4], ray[5]), out + i);
+        }
+        return hits;
+    }
+
+    FLUTTER_PLUGIN_EXPORT bool raycast_screen(void *const viewer, float x, float y, RaycastHit *out)
+    {
+        TRACE_FUNCTION("api");
+        return ((FilamentViewer *)viewer)->raycast(x, y, out);
+    }
+
+    ///
+    /// As for raycast_batch, with each ray given as a viewport point (2 floats) in [points].
+    ///
+    FLUTTER_PLUGIN_EXPORT int raycast_screen_batch(void *const viewer, const float *points, int count, RaycastHit *out)
+    {
+        TRACE_FUNCTION("api");
+        int hits = 0;
+        for (int i = 0; i < count; i++)
+        {
+            hits += ((FilamentViewer *)viewer)->raycast(points[i * 2], points[i * 2 + 1], out + i);
+        }
+        return hits;
+    }
+
     FLUTTER_PLUGIN_EXPORT const char *get_name_for_entity(void *const assetManager, const EntityId entityId)
     {
+        TRACE_FUNCTION("api");
         return ((AssetManager *)assetManager)->getNameForEntity(entityId);
     }
 
@@ -486,6 +904,7 @@ extern "C"
 
     FLUTTER_PLUGIN_EXPORT void flutter_filament_free(void* ptr)
     {
+        TRACE_FUNCTION("api");
         free(ptr);
     }
 
@@ -1,12 +1,20 @@
 
 #include "FlutterFilamentFFIApi.h"
 
+#include "CommandBuffer.hpp"
 #include "FilamentViewer.hpp"
+#include "FramePacer.hpp"
 #include "Log.hpp"
+#include "TaskQueue.hpp"
 #include "ThreadPool.hpp"
+#include "Trace.hpp"
 #include "filament/LightManager.h"
 
+#include <array>
+#include <atomic>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
 
@@ -17,23 +25,31 @@ public:
   explicit RenderLoop() {
     _t = new std::thread([this]() {
       while (!_stop) {
-        {
-          if (_rendering) {
-            doRender();
-          }
+        // frame phase: run as many tasks as fit within the task budget (or, if any
+        // task was flagged as "before next frame", up to and including the last
+        // such task), then render.
+        auto vsyncTimeInNanos = _pacer.beginFrame();
+        drainTasks();
+        if (_rendering) {
+          doRender(vsyncTimeInNanos);
+        } else if (_viewer) {
+          // asynchronous loads are normally advanced by render(), so keep them moving even when we're not rendering
+          _viewer->getAssetManager()->updateAsyncLoads();
         }
-        std::function<void()> task;
-        {
-          std::unique_lock<std::mutex> lock(_access);
-          if (_tasks.empty()) {
-            _cond.wait_for(lock, std::chrono::duration<float, std::milli>(
-                                     _frameIntervalInMilliseconds));
+        auto nextFrame = _pacer.endFrame();
+
+        // idle phase: run tasks as soon as they arrive until the next frame is due.
+        while (!_stop) {
+          if (runTask()) {
+            if (std::chrono::steady_clock::now() >= nextFrame) {
+              break;
+            }
             continue;
           }
-          task = std::move(_tasks.front());
-          _tasks.pop_front();
+          if (!waitForTasks(nextFrame)) {
+            break;
+          }
         }
-        task();
       }
     });
   }
@@ -75,38 +91,158 @@ public:
     fut.wait();
   }
 
-  void doRender() {
-    render(_viewer, 0, nullptr, nullptr, nullptr);
-    if(_renderCallback) {
+  void doRender(uint64_t frameTimeInNanos) {
+    TRACE_FUNCTION("render");
+    // only notify the owner when a frame was actually rendered (on-demand rendering may skip frames where nothing changed)
+    if (render(_viewer, frameTimeInNanos, nullptr, nullptr, nullptr) &&
+        _renderCallback) {
       _renderCallback(_renderCallbackOwner);
     }
   }
 
   void setFrameIntervalInMilliseconds(float frameIntervalInMilliseconds) {
-    _frameIntervalInMilliseconds = frameIntervalInMilliseconds;
+    _pacer.setFrameInterval(frameIntervalInMilliseconds);
+  }
+
+  void setRefreshRate(float refreshRate) {
+    _pacer.setRefreshRate(refreshRate);
   }
 
+  FramePacer &getPacer() { return _pacer; }
+
+  void setTaskBudgetInMilliseconds(float taskBudgetInMilliseconds) {
+    _taskBudgetInMilliseconds = taskBudgetInMilliseconds;
+  }
+
+  ///
+  /// Enqueues a task for the render thread.
+  /// If [beforeNextFrame] is true, the task is guaranteed to run before the next frame is rendered,
+  /// regardless of the per-frame task budget. Since tasks always run in the order they were submitted,
+  /// so is every task submitted before it.
+  ///
   template <class Rt>
-  auto add_task(std::packaged_task<Rt()> &pt) -> std::future<Rt> {
-    std::unique_lock<std::mutex> lock(_access);
+  auto add_task(std::packaged_task<Rt()> &pt, bool beforeNextFrame = false)
+      -> std::future<Rt> {
     auto ret = pt.get_future();
-    _tasks.push_back([pt = std::make_shared<std::packaged_task<Rt()>>(
-                          std::move(pt))] { (*pt)(); });
-    _cond.notify_one();
+    post([pt = std::move(pt)]() mutable { pt(); }, beforeNextFrame);
     return ret;
   }
 
+  ///
+  /// Enqueues a fire-and-forget task for the render thread (i.e. the caller does not wait for the task to complete).
+  /// Tasks are executed in the order they were submitted, so anything captured by [task] must be owned by the task itself
+  /// (e.g. copy any strings rather than capturing the caller's pointer).
+  ///
+  /// This never takes a lock (unless the render thread is asleep and needs to be woken) and never allocates for small tasks.
+  /// If the queue is full, the caller spins until the render thread has made room (or, if the caller is the render thread
+  /// itself, the task goes to an unbounded overflow queue that runs once the queue has been emptied).
+  ///
+  template <class F>
+  void post(F &&task, bool beforeNextFrame = false) {
+    if (beforeNextFrame) {
+      // counted before it can run, so the count never drops below the number still queued
+      _pendingFrameTasks.fetch_add(1, std::memory_order_relaxed);
+      push([this, task = std::forward<F>(task)]() mutable {
+        task();
+        _pendingFrameTasks.fetch_sub(1, std::memory_order_relaxed);
+      });
+    } else {
+      push(std::forward<F>(task));
+    }
+  }
+
 private:
+  template <class F> void push(F &&task) {
+    if (std::this_thread::get_id() == _t->get_id()) {
+      // the render thread can't wait for itself to make room, so anything that doesn't fit goes to _overflow; once anything
+      // has, every task the render thread posts follows it there until it's drained, so they still run in order
+      if (_overflow.empty() && _tasks.tryPush(std::forward<F>(task))) {
+        return;
+      }
+      auto held = std::make_shared<std::decay_t<F>>(std::forward<F>(task));
+      _overflow.emplace_back([held]() { (*held)(); });
+      return;
+    }
+    while (!_tasks.tryPush(std::forward<F>(task))) {
+      std::this_thread::yield();
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_sleeping.load(std::memory_order_relaxed)) {
+      std::lock_guard<std::mutex> lock(_access);
+      _cond.notify_one();
+    }
+  }
+
+  ///
+  /// Sleeps the render thread until a task is posted or [deadline] passes.
+  /// Returns false if the deadline passed without any task being posted.
+  ///
+  bool waitForTasks(std::chrono::steady_clock::time_point deadline) {
+    _sleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool woken;
+    {
+      std::unique_lock<std::mutex> lock(_access);
+      woken = _cond.wait_until(lock, deadline, [this] { return !_tasks.empty() || !_overflow.empty(); });
+    }
+    _sleeping.store(false, std::memory_order_relaxed);
+    return woken;
+  }
+
+  ///
+  /// Runs the oldest task, taking from _overflow only once the queue is empty (since everything in the queue was posted before
+  /// the render thread's first overflowing task, or concurrently with it).
+  ///
+  bool runTask() {
+    if (!_tasks.empty()) {
+      TRACE_SCOPE("RenderLoop::task", "task");
+      return _tasks.tryRun();
+    }
+    if (_overflow.empty()) {
+      return false;
+    }
+    TRACE_SCOPE("RenderLoop::task", "task");
+    auto task = std::move(_overflow.front());
+    _overflow.pop_front();
+    task();
+    return true;
+  }
+
+  void drainTasks() {
+    TRACE_FUNCTION("render");
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start +
+                    std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<float, std::milli>(_taskBudgetInMilliseconds));
+    while (_pendingFrameTasks.load(std::memory_order_relaxed) > 0 ||
+           std::chrono::steady_clock::now() < deadline) {
+      if (!runTask()) {
+        break;
+      }
+    }
+    if (_viewer) {
+      _viewer->setTaskDrainTime(std::chrono::duration<float, std::milli>(
+                                    std::chrono::steady_clock::now() - start)
+                                    .count());
+    }
+  }
+
   bool _stop = false;
   bool _rendering = false;
-  float _frameIntervalInMilliseconds = 1000.0 / 60.0;
+  float _taskBudgetInMilliseconds = 1000.0 / 120.0;
   std::mutex _access;
   FilamentViewer *_viewer = nullptr;
   void (*_renderCallback)(void *const) = nullptr;
   void *_renderCallbackOwner = nullptr;
   std::thread *_t = nullptr;
   std::condition_variable _cond;
-  std::deque<std::function<void()>> _tasks;
+  std::atomic<bool> _sleeping{false};
+  FramePacer _pacer;
+  TaskQueue<> _tasks;
+  // tasks the render thread posted while _tasks was full (render thread only)
+  std::deque<std::function<void()>> _overflow;
+  // "before next frame" tasks that have been posted but haven't yet run
+  std::atomic<int> _pendingFrameTasks{0};
 };
 
 extern "C" {
@@ -118,6 +254,7 @@ FLUTTER_PLUGIN_EXPORT void *const create_filament_viewer_ffi(
     const ResourceLoaderWrapper *const loader,
     void (*renderCallback)(void *const renderCallbackOwner),
     void *const renderCallbackOwner) {
+  TRACE_FUNCTION("ffi");
   if (!_rl) {
     _rl = new RenderLoop();
   }
@@ -126,6 +263,7 @@ FLUTTER_PLUGIN_EXPORT void *const create_filament_viewer_ffi(
 }
 
 FLUTTER_PLUGIN_EXPORT void destroy_filament_viewer_ffi(void *const viewer) {
+  TRACE_FUNCTION("ffi");
   _rl->destroyViewer();
 }
 
@@ -133,14 +271,16 @@ FLUTTER_PLUGIN_EXPORT void create_swap_chain_ffi(void *const viewer,
                                                  void *const surface,
                                                  uint32_t width,
                                                  uint32_t height) {
+  TRACE_FUNCTION("ffi");
   Log("Creating swapchain %dx%d", width, height);
   std::packaged_task<void()> lambda(
       [&]() mutable { create_swap_chain(viewer, surface, width, height); });
-  auto fut = _rl->add_task(lambda);
+  auto fut = _rl->add_task(lambda, true);
   fut.wait();
 }
 
 FLUTTER_PLUGIN_EXPORT void destroy_swap_chain_ffi(void *const viewer) {
+  TRACE_FUNCTION("ffi");
   Log("Destroying swapchain");
   std::packaged_task<void()> lambda(
       [&]() mutable { 
@@ -154,26 +294,29 @@ FLUTTER_PLUGIN_EXPORT void create_render_target_ffi(void *const viewer,
                                                     intptr_t nativeTextureId,
                                                     uint32_t width,
                                                     uint32_t height) {
+  TRACE_FUNCTION("ffi");
   std::packaged_task<void()> lambda([&]() mutable {
     create_render_target(viewer, nativeTextureId, width, height);
   });
-  auto fut = _rl->add_task(lambda);
+  auto fut = _rl->add_task(lambda, true);
   fut.wait();
 }
 
 FLUTTER_PLUGIN_EXPORT void update_viewport_and_camera_projection_ffi(
     void *const viewer, const uint32_t width, const uint32_t height,
     const float scaleFactor) {
+  TRACE_FUNCTION("ffi");
   Log("Update viewport  %dx%d", width, height);
   std::packaged_task<void()> lambda([&]() mutable {
     update_viewport_and_camera_projection(viewer, width, height, scaleFactor);
   });
-  auto fut = _rl->add_task(lambda);
+  auto fut = _rl->add_task(lambda, true);
   fut.wait();
 }
 
 FLUTTER_PLUGIN_EXPORT void set_rendering_ffi(void *const viewer,
                                              bool rendering) {
+  TRACE_FUNCTION("ffi");
   if (!_rl) {
     Log("No render loop!"); // PANIC?
   } else {
@@ -188,11 +331,72 @@ FLUTTER_PLUGIN_EXPORT void set_rendering_ffi(void *const viewer,
 
 FLUTTER_PLUGIN_EXPORT void
 set_frame_interval_ffi(float frameIntervalInMilliseconds) {
+  TRACE_FUNCTION("ffi");
   _rl->setFrameIntervalInMilliseconds(frameIntervalInMilliseconds);
 }
 
+///
+/// Sets the display refresh rate (in Hz) that the render loop aligns frames to.
+/// The frame interval is rounded to a whole number of refresh periods.
+///
+FLUTTER_PLUGIN_EXPORT void set_refresh_rate_ffi(void *const viewer,
+                                                float refreshRate) {
+  TRACE_FUNCTION("ffi");
+  _rl->setRefreshRate(refreshRate);
+  _rl->post([=] { set_refresh_rate(viewer, refreshRate); });
+}
+
+FLUTTER_PLUGIN_EXPORT void set_on_demand_rendering_ffi(void *const viewer,
+                                                       bool enabled,
+                                                       float idleFrameRate) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { set_on_demand_rendering(viewer, enabled, idleFrameRate); });
+}
+
+FLUTTER_PLUGIN_EXPORT void request_frame_ffi(void *const viewer) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { request_frame(viewer); });
+}
+
+FLUTTER_PLUGIN_EXPORT void get_frame_pacing_stats_ffi(FramePacingStats *out,
+                                                      bool reset) {
+  TRACE_FUNCTION("ffi");
+  auto &pacer = _rl->getPacer();
+  auto stats = pacer.getStats();
+  if (reset) {
+    pacer.resetStats();
+  }
+  out->frameCount = stats.frameCount;
+  out->missedDeadlines = stats.missedDeadlines;
+  out->skippedVsyncs = stats.skippedVsyncs;
+  out->lastFrameCostInMilliseconds = stats.lastFrameCostInMilliseconds;
+  out->predictedFrameCostInMilliseconds = stats.predictedFrameCostInMilliseconds;
+  out->averageJitterInMilliseconds = stats.averageJitterInMilliseconds;
+  out->maxJitterInMilliseconds = stats.maxJitterInMilliseconds;
+}
+
+FLUTTER_PLUGIN_EXPORT int get_frame_timings_ffi(void *const viewer,
+                                               FrameTimingRecord *out,
+                                               int maxRecords) {
+  TRACE_FUNCTION("ffi");
+  // lock-free snapshot, so no need to go through the render thread
+  return get_frame_timings(viewer, out, maxRecords);
+}
+
+FLUTTER_PLUGIN_EXPORT void
+set_task_budget_ffi(float taskBudgetInMilliseconds) {
+  TRACE_FUNCTION("ffi");
+  _rl->setTaskBudgetInMilliseconds(taskBudgetInMilliseconds);
+}
+
 FLUTTER_PLUGIN_EXPORT void render_ffi(void *const viewer) {
-  std::packaged_task<void()> lambda([&]() mutable { _rl->doRender(); });
+  TRACE_FUNCTION("ffi");
+  std::packaged_task<void()> lambda([&]() mutable {
+    request_frame(viewer);
+    _rl->doRender(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch())
+                      .count());
+  });
   auto fut = _rl->add_task(lambda);
   fut.wait();
 }
@@ -200,15 +404,14 @@ FLUTTER_PLUGIN_EXPORT void render_ffi(void *const viewer) {
 FLUTTER_PLUGIN_EXPORT void
 set_background_color_ffi(void *const viewer, const float r, const float g,
                          const float b, const float a) {
-  std::packaged_task<void()> lambda(
-      [&]() mutable { set_background_color(viewer, r, g, b, a); });
-  auto fut = _rl->add_task(lambda);
-  fut.wait();
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { set_background_color(viewer, r, g, b, a); });
 }
 
 FLUTTER_PLUGIN_EXPORT EntityId load_gltf_ffi(void *const assetManager,
                                              const char *path,
                                              const char *relativeResourcePath) {
+  TRACE_FUNCTION("ffi");
   std::packaged_task<EntityId()> lambda([&]() mutable {
     return load_gltf(assetManager, path, relativeResourcePath);
   });
@@ -219,6 +422,7 @@ FLUTTER_PLUGIN_EXPORT EntityId load_gltf_ffi(void *const assetManager,
 
 FLUTTER_PLUGIN_EXPORT EntityId load_glb_ffi(void *const assetManager,
                                             const char *path, bool unlit) {
+  TRACE_FUNCTION("ffi");
   std::packaged_task<EntityId()> lambda(
       [&]() mutable { return load_glb(assetManager, path, unlit); });
   auto fut = _rl->add_task(lambda);
@@ -226,63 +430,164 @@ FLUTTER_PLUGIN_EXPORT EntityId load_glb_ffi(void *const assetManager,
   return fut.get();
 }
 
-FLUTTER_PLUGIN_EXPORT void clear_background_image_ffi(void *const viewer) {
-  std::packaged_task<void()> lambda([&] { clear_background_image(viewer); });
+FLUTTER_PLUGIN_EXPORT int load_glb_instanced_ffi(void *const assetManager,
+                                                const char *path,
+                                                int numInstances,
+                                                EntityId *out) {
+  TRACE_FUNCTION("ffi");
+  std::packaged_task<int()> lambda([&]() mutable {
+    return load_glb_instanced(assetManager, path, numInstances, out);
+  });
   auto fut = _rl->add_task(lambda);
   fut.wait();
+  return fut.get();
 }
 
-FLUTTER_PLUGIN_EXPORT void set_background_image_ffi(void *const viewer,
-                                                    const char *path,
-                                                    bool fillHeight) {
+FLUTTER_PLUGIN_EXPORT EntityId create_instance_ffi(void *const assetManager,
+                                                   EntityId entityId) {
+  TRACE_FUNCTION("ffi");
+  std::packaged_task<EntityId()> lambda(
+      [&]() mutable { return create_instance(assetManager, entityId); });
+  auto fut = _rl->add_task(lambda);
+  fut.wait();
+  return fut.get();
+}
+
+FLUTTER_PLUGIN_EXPORT void set_asset_cache_budget_ffi(void *const assetManager,
+                                                      uint64_t budgetInBytes) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { set_asset_cache_budget(assetManager, budgetInBytes); });
+}
+
+FLUTTER_PLUGIN_EXPORT void get_asset_cache_stats_ffi(void *const assetManager,
+                                                     AssetCacheStats *out) {
+  TRACE_FUNCTION("ffi");
   std::packaged_task<void()> lambda(
-      [&] { set_background_image(viewer, path, fillHeight); });
+      [&]() mutable { get_asset_cache_stats(assetManager, out); });
   auto fut = _rl->add_task(lambda);
   fut.wait();
 }
+
+FLUTTER_PLUGIN_EXPORT void
+load_gltf_with_callback_ffi(void *const assetManager, const char *path,
+                            const char *relativeResourcePath,
+                            void (*callback)(EntityId)) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=, path = std::string(path),
+             relativeResourcePath = std::string(relativeResourcePath)] {
+    auto entity =
+        load_gltf(assetManager, path.c_str(), relativeResourcePath.c_str());
+    callback(entity);
+  });
+}
+
+FLUTTER_PLUGIN_EXPORT void
+load_glb_with_callback_ffi(void *const assetManager, const char *path,
+                           bool unlit, void (*callback)(EntityId)) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=, path = std::string(path)] {
+    auto entity = load_glb(assetManager, path.c_str(), unlit);
+    callback(entity);
+  });
+}
+
+///
+/// Starts loading a GLB/glTF asynchronously and returns the EntityId the asset will be assigned once loaded.
+/// Neither call blocks; [callback] is invoked on the render thread when the load completes, fails or is cancelled.
+///
+FLUTTER_PLUGIN_EXPORT EntityId load_glb_async_ffi(void *const assetManager,
+                                                  const char *path,
+                                                  AssetLoadCallback callback) {
+  TRACE_FUNCTION("ffi");
+  auto entityId = AssetManager::reserveEntityId();
+  _rl->post([=, path = std::string(path)] {
+    ((AssetManager *)assetManager)
+        ->loadGlbAsync(path.c_str(), callback, entityId);
+  });
+  return entityId;
+}
+
+FLUTTER_PLUGIN_EXPORT EntityId load_gltf_async_ffi(
+    void *const assetManager, const char *path,
+    const char *relativeResourcePath, AssetLoadCallback callback) {
+  TRACE_FUNCTION("ffi");
+  auto entityId = AssetManager::reserveEntityId();
+  _rl->post([=, path = std::string(path),
+             relativeResourcePath = std::string(relativeResourcePath)] {
+    ((AssetManager *)assetManager)
+        ->loadGltfAsync(path.c_str(), relativeResourcePath.c_str(), callback,
+                        entityId);
+  });
+  return entityId;
+}
+
+FLUTTER_PLUGIN_EXPORT bool get_load_progress_ffi(void *const assetManager,
+                                                 EntityId asset,
+                                                 AssetLoadProgress *out) {
+  TRACE_FUNCTION("ffi");
+  std::packaged_task<bool()> lambda(
+      [&]() mutable { return get_load_progress(assetManager, asset, out); });
+  auto fut = _rl->add_task(lambda);
+  fut.wait();
+  return fut.get();
+}
+
+FLUTTER_PLUGIN_EXPORT void cancel_load_ffi(void *const assetManager,
+                                           EntityId asset) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { cancel_load(assetManager, asset); });
+}
+
+FLUTTER_PLUGIN_EXPORT void clear_background_image_ffi(void *const viewer) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { clear_background_image(viewer); });
+}
+
+FLUTTER_PLUGIN_EXPORT void set_background_image_ffi(void *const viewer,
+                                                    const char *path,
+                                                    bool fillHeight) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=, path = std::string(path)] {
+    set_background_image(viewer, path.c_str(), fillHeight);
+  });
+}
 FLUTTER_PLUGIN_EXPORT void set_background_image_position_ffi(void *const viewer,
                                                              float x, float y,
                                                              bool clamp) {
-  std::packaged_task<void()> lambda(
-      [&] { set_background_image_position(viewer, x, y, clamp); });
-  auto fut = _rl->add_task(lambda);
-  fut.wait();
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { set_background_image_position(viewer, x, y, clamp); });
 }
 FLUTTER_PLUGIN_EXPORT void set_tone_mapping_ffi(void *const viewer,
                                                 int toneMapping) {
-  std::packaged_task<void()> lambda(
-      [&] { set_tone_mapping(viewer, toneMapping); });
-  auto fut = _rl->add_task(lambda);
-  fut.wait();
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { set_tone_mapping(viewer, toneMapping); });
 }
 FLUTTER_PLUGIN_EXPORT void set_bloom_ffi(void *const viewer, float strength) {
-  std::packaged_task<void()> lambda([&] { set_bloom(viewer, strength); });
-  auto fut = _rl->add_task(lambda);
-  fut.wait();
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { set_bloom(viewer, strength); });
 }
 FLUTTER_PLUGIN_EXPORT void load_skybox_ffi(void *const viewer,
                                            const char *skyboxPath) {
-  std::packaged_task<void()> lambda([&] { load_skybox(viewer, skyboxPath); });
-  auto fut = _rl->add_task(lambda);
-  fut.wait();
+  TRACE_FUNCTION("ffi");
+  _rl->post([=, skyboxPath = std::string(skyboxPath)] {
+    load_skybox(viewer, skyboxPath.c_str());
+  });
 }
 FLUTTER_PLUGIN_EXPORT void load_ibl_ffi(void *const viewer, const char *iblPath,
                                         float intensity) {
-  std::packaged_task<void()> lambda(
-      [&] { load_ibl(viewer, iblPath, intensity); });
-  auto fut = _rl->add_task(lambda);
-  fut.wait();
+  TRACE_FUNCTION("ffi");
+  _rl->post([=, iblPath = std::string(iblPath)] {
+    load_ibl(viewer, iblPath.c_str(), intensity);
+  });
 }
 FLUTTER_PLUGIN_EXPORT void remove_skybox_ffi(void *const viewer) {
-  std::packaged_task<void()> lambda([&] { remove_skybox(viewer); });
-  auto fut = _rl->add_task(lambda);
-  fut.wait();
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { remove_skybox(viewer); });
 }
 
 FLUTTER_PLUGIN_EXPORT void remove_ibl_ffi(void *const viewer) {
-  std::packaged_task<void()> lambda([&] { remove_ibl(viewer); });
-  auto fut = _rl->add_task(lambda);
-  fut.wait();
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { remove_ibl(viewer); });
 }
 
 EntityId add_light_ffi(void *const viewer, uint8_t type, float colour,
@@ -297,33 +602,42 @@ EntityId add_light_ffi(void *const viewer, uint8_t type, float colour,
   return fut.get();
 }
 
+FLUTTER_PLUGIN_EXPORT void add_light_with_callback_ffi(
+    void *const viewer, uint8_t type, float colour, float intensity,
+    float posX, float posY, float posZ, float dirX, float dirY, float dirZ,
+    bool shadows, void (*callback)(EntityId)) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] {
+    auto entity = add_light(viewer, type, colour, intensity, posX, posY, posZ,
+                            dirX, dirY, dirZ, shadows);
+    callback(entity);
+  });
+}
+
 FLUTTER_PLUGIN_EXPORT void remove_light_ffi(void *const viewer,
                                             EntityId entityId) {
-  std::packaged_task<void()> lambda([&] { remove_light(viewer, entityId); });
-  auto fut = _rl->add_task(lambda);
-  fut.wait();
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { remove_light(viewer, entityId); });
 }
 
 FLUTTER_PLUGIN_EXPORT void clear_lights_ffi(void *const viewer) {
-  std::packaged_task<void()> lambda([&] { clear_lights(viewer); });
-  auto fut = _rl->add_task(lambda);
-  fut.wait();
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { clear_lights(viewer); });
 }
 
 FLUTTER_PLUGIN_EXPORT void remove_asset_ffi(void *const viewer,
                                             EntityId asset) {
-  std::packaged_task<void()> lambda([&] { remove_asset(viewer, asset); });
-  auto fut = _rl->add_task(lambda);
-  fut.wait();
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { remove_asset(viewer, asset); });
 }
 FLUTTER_PLUGIN_EXPORT void clear_assets_ffi(void *const viewer) {
-  std::packaged_task<void()> lambda([&] { clear_assets(viewer); });
-  auto fut = _rl->add_task(lambda);
-  fut.wait();
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { clear_assets(viewer); });
 }
 
 FLUTTER_PLUGIN_EXPORT bool set_camera_ffi(void *const viewer, EntityId asset,
                                           const char *nodeName) {
+  TRACE_FUNCTION("ffi");
   std::packaged_task<bool()> lambda(
       [&] { return set_camera(viewer, asset, nodeName); });
   auto fut = _rl->add_task(lambda);
@@ -335,17 +649,113 @@ FLUTTER_PLUGIN_EXPORT void set_bone_animation_ffi(
     void *assetManager, EntityId asset, const float *const frameData,
     int numFrames, int numBones, const char **const boneNames,
     const char **const meshName, int numMeshTargets, float frameLengthInMs) {
+  TRACE_FUNCTION("ffi");
+  // compressing is the expensive part, so happens on the calling thread rather than holding up the render loop
+  auto frames = ((AssetManager *)assetManager)
+                    ->compressBoneAnimation(frameData, numFrames, numBones, false);
   std::packaged_task<void()> lambda([&] {
-    set_bone_animation(assetManager, asset, frameData, numFrames, numBones,
-                       boneNames, meshName, numMeshTargets, frameLengthInMs);
+    ((AssetManager *)assetManager)
+        ->setBoneAnimationBuffer(asset, std::move(frames), boneNames, meshName,
+                                 numMeshTargets, frameLengthInMs);
+  });
+  auto fut = _rl->add_task(lambda);
+  fut.wait();
+}
+
+FLUTTER_PLUGIN_EXPORT int add_bone_animation_clip_ffi(
+    void *const assetManager, EntityId asset, const float *const frameData,
+    int numFrames, int numBones, const char **const boneNames,
+    float frameLengthInMs) {
+  TRACE_FUNCTION("ffi");
+  // as set_bone_animation_ffi
+  auto frames = ((AssetManager *)assetManager)
+                    ->compressBoneAnimation(frameData, numFrames, numBones, true);
+  std::packaged_task<int()> lambda([&] {
+    return ((AssetManager *)assetManager)
+        ->addBoneAnimationClip(asset, std::move(frames), boneNames,
+                               frameLengthInMs);
   });
   auto fut = _rl->add_task(lambda);
   fut.wait();
+  return fut.get();
+}
+
+FLUTTER_PLUGIN_EXPORT int
+add_bone_animation_layer_ffi(void *const assetManager, EntityId asset,
+                             int clipIndex, float weight, bool additive,
+                             bool loop) {
+  TRACE_FUNCTION("ffi");
+  std::packaged_task<int()> lambda([&] {
+    return add_bone_animation_layer(assetManager, asset, clipIndex, weight,
+                                    additive, loop);
+  });
+  auto fut = _rl->add_task(lambda);
+  fut.wait();
+  return fut.get();
+}
+
+FLUTTER_PLUGIN_EXPORT void
+set_bone_animation_layer_weight_ffi(void *const assetManager, EntityId asset,
+                                    int layerIndex, float weight) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] {
+    set_bone_animation_layer_weight(assetManager, asset, layerIndex, weight);
+  });
+}
+
+FLUTTER_PLUGIN_EXPORT bool set_bone_animation_layer_mask_ffi(
+    void *const assetManager, EntityId asset, int layerIndex,
+    const char **const boneNames, const float *const weights, int count) {
+  TRACE_FUNCTION("ffi");
+  std::packaged_task<bool()> lambda([&] {
+    return set_bone_animation_layer_mask(assetManager, asset, layerIndex,
+                                         boneNames, weights, count);
+  });
+  auto fut = _rl->add_task(lambda);
+  fut.wait();
+  return fut.get();
+}
+
+FLUTTER_PLUGIN_EXPORT void
+remove_bone_animation_layer_ffi(void *const assetManager, EntityId asset,
+                                int layerIndex) {
+  TRACE_FUNCTION("ffi");
+  _rl->post(
+      [=] { remove_bone_animation_layer(assetManager, asset, layerIndex); });
+}
+
+FLUTTER_PLUGIN_EXPORT void
+clear_bone_animation_layers_ffi(void *const assetManager, EntityId asset) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { clear_bone_animation_layers(assetManager, asset); });
+}
+
+FLUTTER_PLUGIN_EXPORT void
+set_bone_animation_tolerance_ffi(void *const assetManager,
+                                 float rotationTolerance,
+                                 float translationTolerance) {
+  TRACE_FUNCTION("ffi");
+  // applied immediately rather than posted, since the animations it affects are compressed on the calling thread (and the
+  // tolerances are guarded by the animation mutex)
+  set_bone_animation_tolerance(assetManager, rotationTolerance,
+                               translationTolerance);
+}
+
+FLUTTER_PLUGIN_EXPORT bool
+get_bone_animation_stats_ffi(void *const assetManager, EntityId asset,
+                             BoneAnimationStats *out) {
+  TRACE_FUNCTION("ffi");
+  std::packaged_task<bool()> lambda(
+      [&] { return get_bone_animation_stats(assetManager, asset, out); });
+  auto fut = _rl->add_task(lambda);
+  fut.wait();
+  return fut.get();
 }
 
 FLUTTER_PLUGIN_EXPORT void
 get_morph_target_name_ffi(void *assetManager, EntityId asset,
                           const char *meshName, char *const outPtr, int index) {
+  TRACE_FUNCTION("ffi");
   std::packaged_task<void()> lambda([&] {
     get_morph_target_name(assetManager, asset, meshName, outPtr, index);
   });
@@ -353,9 +763,32 @@ get_morph_target_name_ffi(void *assetManager, EntityId asset,
   fut.wait();
 }
 
+FLUTTER_PLUGIN_EXPORT int describe_asset_ffi(void *const assetManager,
+                                            EntityId asset, uint8_t *out,
+                                            int capacity) {
+  TRACE_FUNCTION("ffi");
+  std::packaged_task<int()> lambda(
+      [&] { return describe_asset(assetManager, asset, out, capacity); });
+  auto fut = _rl->add_task(lambda);
+  fut.wait();
+  return fut.get();
+}
+
+FLUTTER_PLUGIN_EXPORT uint8_t *describe_asset_alloc_ffi(void *const assetManager,
+                                                        EntityId asset,
+                                                        int *outLength) {
+  TRACE_FUNCTION("ffi");
+  std::packaged_task<uint8_t *()> lambda(
+      [&] { return describe_asset_alloc(assetManager, asset, outLength); });
+  auto fut = _rl->add_task(lambda);
+  fut.wait();
+  return fut.get();
+}
+
 FLUTTER_PLUGIN_EXPORT int
 get_morph_target_name_count_ffi(void *assetManager, EntityId asset,
                                 const char *meshName) {
+  TRACE_FUNCTION("ffi");
   std::packaged_task<int()> lambda([&] {
     return get_morph_target_name_count(assetManager, asset, meshName);
   });
@@ -364,11 +797,77 @@ get_morph_target_name_count_ffi(void *assetManager, EntityId asset,
   return fut.get();
 }
 
-void set_morph_target_weights_ffi(void *const assetManager, EntityId asset,
+FLUTTER_PLUGIN_EXPORT void set_morph_target_weights_ffi(void *const assetManager, EntityId asset,
                                   const char *const entityName,
                                   const float *const morphData,
                                   int numWeights) {
-  // TODO
+  TRACE_FUNCTION("ffi");
+  _rl->post([=, entityName = std::string(entityName),
+             weights = std::vector<float>(morphData, morphData + numWeights)] {
+    set_morph_target_weights(assetManager, asset, entityName.c_str(),
+                             weights.data(), numWeights);
+  });
+}
+
+///
+/// Name-ID variants (see get_name_id_ffi), which avoid marshalling and hashing a string on every call.
+///
+FLUTTER_PLUGIN_EXPORT void set_morph_target_weights_by_id_ffi(
+    void *const assetManager, EntityId asset, uint32_t entityNameId,
+    const float *const morphData, int numWeights) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=, weights = std::vector<float>(morphData, morphData + numWeights)] {
+    set_morph_target_weights_by_id(assetManager, asset, entityNameId,
+                                   weights.data(), numWeights);
+  });
+}
+
+FLUTTER_PLUGIN_EXPORT uint32_t get_name_id_ffi(void *const assetManager,
+                                               const char *name) {
+  TRACE_FUNCTION("ffi");
+  std::packaged_task<uint32_t()> lambda(
+      [&]() mutable { return get_name_id(assetManager, name); });
+  auto fut = _rl->add_task(lambda);
+  fut.wait();
+  return fut.get();
+}
+
+FLUTTER_PLUGIN_EXPORT int get_morph_target_index_ffi(void *const assetManager,
+                                                     EntityId asset,
+                                                     uint32_t entityNameId,
+                                                     uint32_t morphTargetNameId) {
+  TRACE_FUNCTION("ffi");
+  std::packaged_task<int()> lambda([&]() mutable {
+    return get_morph_target_index(assetManager, asset, entityNameId,
+                                  morphTargetNameId);
+  });
+  auto fut = _rl->add_task(lambda);
+  fut.wait();
+  return fut.get();
+}
+
+FLUTTER_PLUGIN_EXPORT void hide_mesh_by_id_ffi(void *const assetManager,
+                                               EntityId asset,
+                                               uint32_t meshNameId) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { hide_mesh_by_id(assetManager, asset, meshNameId); });
+}
+
+FLUTTER_PLUGIN_EXPORT void reveal_mesh_by_id_ffi(void *const assetManager,
+                                                 EntityId asset,
+                                                 uint32_t meshNameId) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { reveal_mesh_by_id(assetManager, asset, meshNameId); });
+}
+
+FLUTTER_PLUGIN_EXPORT void set_material_color_by_id_ffi(
+    void *const assetManager, EntityId asset, uint32_t meshNameId,
+    int materialIndex, float r, float g, float b, float a) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] {
+    set_material_color_by_id(assetManager, asset, meshNameId, materialIndex, r,
+                             g, b, a);
+  });
 }
 
 FLUTTER_PLUGIN_EXPORT void play_animation_ffi(void *const assetManager,
@@ -376,35 +875,51 @@ FLUTTER_PLUGIN_EXPORT void play_animation_ffi(void *const assetManager,
                                               bool loop, bool reverse,
                                               bool replaceActive,
                                               float crossfade) {
-  std::packaged_task<void()> lambda([&] {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] {
     play_animation(assetManager, asset, index, loop, reverse, replaceActive,
                    crossfade);
   });
-  auto fut = _rl->add_task(lambda);
-  fut.wait();
 }
 
 FLUTTER_PLUGIN_EXPORT void set_animation_frame_ffi(void *const assetManager,
                                                    EntityId asset,
                                                    int animationIndex,
                                                    int animationFrame) {
-  std::packaged_task<void()> lambda([&] {
-    set_animation_frame(assetManager, asset, animationIndex, animationFrame);
-  });
-  auto fut = _rl->add_task(lambda);
-  fut.wait();
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { set_animation_frame(assetManager, asset, animationIndex, animationFrame); });
 }
 
 FLUTTER_PLUGIN_EXPORT void stop_animation_ffi(void *const assetManager,
                                               EntityId asset, int index) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { stop_animation(assetManager, asset, index); });
+}
+
+FLUTTER_PLUGIN_EXPORT void
+set_animation_thread_count_ffi(void *const assetManager, int count) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { set_animation_thread_count(assetManager, count); });
+}
+
+FLUTTER_PLUGIN_EXPORT void
+set_animation_bake_rate_ffi(void *const assetManager, float samplesPerSecond) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { set_animation_bake_rate(assetManager, samplesPerSecond); });
+}
+
+FLUTTER_PLUGIN_EXPORT void get_animation_stats_ffi(void *const assetManager,
+                                                   AnimationStats *out) {
+  TRACE_FUNCTION("ffi");
   std::packaged_task<void()> lambda(
-      [&] { stop_animation(assetManager, asset, index); });
+      [&] { get_animation_stats(assetManager, out); });
   auto fut = _rl->add_task(lambda);
   fut.wait();
 }
 
 FLUTTER_PLUGIN_EXPORT int get_animation_count_ffi(void *const assetManager,
                                                   EntityId asset) {
+  TRACE_FUNCTION("ffi");
   std::packaged_task<int()> lambda(
       [&] { return get_animation_count(assetManager, asset); });
   auto fut = _rl->add_task(lambda);
@@ -415,6 +930,7 @@ FLUTTER_PLUGIN_EXPORT void get_animation_name_ffi(void *const assetManager,
                                                   EntityId asset,
                                                   char *const outPtr,
                                                   int index) {
+  TRACE_FUNCTION("ffi");
   std::packaged_task<void()> lambda(
       [&] { get_animation_name(assetManager, asset, outPtr, index); });
   auto fut = _rl->add_task(lambda);
@@ -423,21 +939,258 @@ FLUTTER_PLUGIN_EXPORT void get_animation_name_ffi(void *const assetManager,
 
 FLUTTER_PLUGIN_EXPORT void set_post_processing_ffi(void *const viewer,
                                                    bool enabled) {
-  std::packaged_task<void()> lambda(
-      [&] { set_post_processing(viewer, enabled); });
-  auto fut = _rl->add_task(lambda);
-  fut.wait();
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { set_post_processing(viewer, enabled); });
 }
 
 FLUTTER_PLUGIN_EXPORT void pick_ffi(void *const viewer, int x, int y,
                                     EntityId *entityId) {
+  TRACE_FUNCTION("ffi");
   std::packaged_task<void()> lambda([&] { pick(viewer, x, y, entityId); });
   auto fut = _rl->add_task(lambda);
   fut.wait();
 }
 
+// the viewer reuses its results buffer as soon as the callback returns, but an FFI callback (e.g. a Dart
+// NativeCallable.listener) usually runs later, so is handed a copy that it must release with flutter_filament_free
+static PickResultsCallback _pickResultsCallback = nullptr;
+
+static void copyPickResults(const PickResult *results, int32_t count) {
+  auto copy = (PickResult *)malloc(count * sizeof(PickResult));
+  memcpy(copy, results, count * sizeof(PickResult));
+  _pickResultsCallback(copy, count);
+}
+
+FLUTTER_PLUGIN_EXPORT void
+set_pick_results_callback_ffi(void *const viewer,
+                              PickResultsCallback callback) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] {
+    _pickResultsCallback = callback;
+    set_pick_results_callback(viewer, callback ? copyPickResults : nullptr);
+  });
+}
+
+FLUTTER_PLUGIN_EXPORT uint32_t queue_pick_ffi(void *const viewer, int x, int y,
+                                              uint32_t channel) {
+  TRACE_FUNCTION("ffi");
+  int32_t point[2] = {x, y};
+  return queue_picks_ffi(viewer, point, 1, channel);
+}
+
+FLUTTER_PLUGIN_EXPORT uint32_t queue_picks_ffi(void *const viewer,
+                                               const int32_t *points,
+                                               int count, uint32_t channel) {
+  TRACE_FUNCTION("ffi");
+  // the ID is reserved here so the caller doesn't have to wait for the render thread
+  uint32_t firstRequestId =
+      ((FilamentViewer *)viewer)->reservePickRequestIds(count);
+  std::vector<int32_t> pointsCopy(points, points + count * 2);
+  _rl->post([=] {
+    ((FilamentViewer *)viewer)
+        ->queuePicks(pointsCopy.data(), count, channel, firstRequestId);
+  });
+  return firstRequestId;
+}
+
+FLUTTER_PLUGIN_EXPORT bool raycast_ffi(void *const viewer, float originX,
+                                       float originY, float originZ,
+                                       float directionX, float directionY,
+                                       float directionZ, RaycastHit *out) {
+  TRACE_FUNCTION("ffi");
+  std::packaged_task<bool()> lambda([&] {
+    return raycast(viewer, originX, originY, originZ, directionX, directionY,
+                   directionZ, out);
+  });
+  auto fut = _rl->add_task(lambda);
+  fut.wait();
+  return fut.get();
+}
+
+FLUTTER_PLUGIN_EXPORT int raycast_batch_ffi(void *const viewer,
+                                            const float *rays, int count,
+                                            RaycastHit *out) {
+  TRACE_FUNCTION("ffi");
+  std::packaged_task<int()> lambda(
+      [&] { return raycast_batch(viewer, rays, count, out); });
+  auto fut = _rl->add_task(lambda);
+  fut.wait();
+  return fut.get();
+}
+
+FLUTTER_PLUGIN_EXPORT bool raycast_screen_ffi(void *const viewer, float x,
+                                              float y, RaycastHit *out) {
+  TRACE_FUNCTION("ffi");
+  std::packaged_task<bool()> lambda(
+      [&] { return raycast_screen(viewer, x, y, out); });
+  auto fut = _rl->add_task(lambda);
+  fut.wait();
+  return fut.get();
+}
+
+FLUTTER_PLUGIN_EXPORT int raycast_screen_batch_ffi(void *const viewer,
+                                                   const float *points,
+                                                   int count,
+                                                   RaycastHit *out) {
+  TRACE_FUNCTION("ffi");
+  std::packaged_task<int()> lambda(
+      [&] { return raycast_screen_batch(viewer, points, count, out); });
+  auto fut = _rl->add_task(lambda);
+  fut.wait();
+  return fut.get();
+}
+
+FLUTTER_PLUGIN_EXPORT void
+pick_with_callback_ffi(void *const viewer, int x, int y,
+                       void (*callback)(EntityId entityId, int x, int y)) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] {
+    ((FilamentViewer *)viewer)->pick(static_cast<uint32_t>(x),
+                                     static_cast<uint32_t>(y), callback);
+  });
+}
+
+FLUTTER_PLUGIN_EXPORT void set_camera_position_ffi(void *const viewer, float x,
+                                                   float y, float z) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { set_camera_position(viewer, x, y, z); });
+}
+
+FLUTTER_PLUGIN_EXPORT void set_camera_rotation_ffi(void *const viewer,
+                                                   float rads, float x, float y,
+                                                   float z) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { set_camera_rotation(viewer, rads, x, y, z); });
+}
+
+FLUTTER_PLUGIN_EXPORT void set_camera_model_matrix_ffi(void *const viewer,
+                                                       const float *const matrix) {
+  TRACE_FUNCTION("ffi");
+  std::array<float, 16> copy;
+  std::copy(matrix, matrix + 16, copy.begin());
+  _rl->post([=] { set_camera_model_matrix(viewer, copy.data()); });
+}
+
+FLUTTER_PLUGIN_EXPORT void set_camera_focal_length_ffi(void *const viewer,
+                                                       float focalLength) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { set_camera_focal_length(viewer, focalLength); });
+}
+
+FLUTTER_PLUGIN_EXPORT void set_camera_focus_distance_ffi(void *const viewer,
+                                                         float distance) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { set_camera_focus_distance(viewer, distance); });
+}
+
+FLUTTER_PLUGIN_EXPORT void set_camera_exposure_ffi(void *const viewer,
+                                                   float aperture,
+                                                   float shutterSpeed,
+                                                   float sensitivity) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] {
+    set_camera_exposure(viewer, aperture, shutterSpeed, sensitivity);
+  });
+}
+
+FLUTTER_PLUGIN_EXPORT void grab_begin_ffi(void *const viewer, float x, float y,
+                                          bool pan) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { grab_begin(viewer, x, y, pan); });
+}
+
+FLUTTER_PLUGIN_EXPORT void grab_update_ffi(void *const viewer, float x,
+                                           float y) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { grab_update(viewer, x, y); });
+}
+
+FLUTTER_PLUGIN_EXPORT void grab_end_ffi(void *const viewer) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { grab_end(viewer); });
+}
+
+FLUTTER_PLUGIN_EXPORT void scroll_begin_ffi(void *const viewer) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { scroll_begin(viewer); });
+}
+
+FLUTTER_PLUGIN_EXPORT void scroll_update_ffi(void *const viewer, float x,
+                                             float y, float delta) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { scroll_update(viewer, x, y, delta); });
+}
+
+FLUTTER_PLUGIN_EXPORT void scroll_end_ffi(void *const viewer) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { scroll_end(viewer); });
+}
+
+FLUTTER_PLUGIN_EXPORT void set_position_ffi(void *const assetManager,
+                                            EntityId asset, float x, float y,
+                                            float z) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { set_position(assetManager, asset, x, y, z); });
+}
+
+///
+/// Bulk transform updates (see AssetManager::setTransforms). The arrays are copied, so can be freed as soon as these return.
+///
+FLUTTER_PLUGIN_EXPORT void set_transforms_ffi(void *const assetManager,
+                                              const EntityId *assets,
+                                              const float *positions,
+                                              const float *rotations,
+                                              const float *scales, int count) {
+  TRACE_FUNCTION("ffi");
+  std::vector<EntityId> assetsCopy(assets, assets + count);
+  std::vector<float> positionsCopy, rotationsCopy, scalesCopy;
+  if (positions) {
+    positionsCopy.assign(positions, positions + count * 3);
+  }
+  if (rotations) {
+    rotationsCopy.assign(rotations, rotations + count * 4);
+  }
+  if (scales) {
+    scalesCopy.assign(scales, scales + count);
+  }
+  _rl->post([=, assets = std::move(assetsCopy),
+             positions = std::move(positionsCopy),
+             rotations = std::move(rotationsCopy),
+             scales = std::move(scalesCopy)] {
+    set_transforms(assetManager, assets.data(),
+                   positions.empty() ? nullptr : positions.data(),
+                   rotations.empty() ? nullptr : rotations.data(),
+                   scales.empty() ? nullptr : scales.data(), count);
+  });
+}
+
+FLUTTER_PLUGIN_EXPORT void set_transform_matrices_ffi(void *const assetManager,
+                                                      const EntityId *assets,
+                                                      const float *matrices,
+                                                      int count) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=, assets = std::vector<EntityId>(assets, assets + count),
+             matrices = std::vector<float>(matrices, matrices + count * 12)] {
+    set_transform_matrices(assetManager, assets.data(), matrices.data(), count);
+  });
+}
+
+FLUTTER_PLUGIN_EXPORT void set_rotation_ffi(void *const assetManager,
+                                            EntityId asset, float rads, float x,
+                                            float y, float z) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { set_rotation(assetManager, asset, rads, x, y, z); });
+}
+
+FLUTTER_PLUGIN_EXPORT void set_scale_ffi(void *const assetManager,
+                                         EntityId asset, float scale) {
+  TRACE_FUNCTION("ffi");
+  _rl->post([=] { set_scale(assetManager, asset, scale); });
+}
+
 FLUTTER_PLUGIN_EXPORT const char *
 get_name_for_entity_ffi(void *const assetManager, const EntityId entityId) {
+  TRACE_FUNCTION("ffi");
   std::packaged_task<const char *()> lambda(
       [&] { return get_name_for_entity(assetManager, entityId); });
   auto fut = _rl->add_task(lambda);
@@ -445,5 +1198,25 @@ get_name_for_entity_ffi(void *const assetManager, const EntityId entityId) {
   return fut.get();
 }
 
+///
+/// Submits a packed command stream (see CommandBuffer.hpp) to be decoded and applied on the render thread.
+/// The stream is copied, so the caller can reuse [data] as soon as this returns.
+/// Returns false (and discards the stream) if the header is invalid.
+///
+FLUTTER_PLUGIN_EXPORT bool submit_commands_ffi(void *const viewer,
+                                               const uint8_t *const data,
+                                               int32_t length) {
+  TRACE_FUNCTION("ffi");
+  if (!CommandBuffer::validate(data, length)) {
+    return false;
+  }
+  std::vector<uint8_t> commands(data, data + length);
+  _rl->post([=, commands = std::move(commands)] {
+    CommandBuffer::apply((FilamentViewer *)viewer, commands.data(),
+                         commands.size());
+  });
+  return true;
+}
+
 FLUTTER_PLUGIN_EXPORT void ios_dummy_ffi() { Log("Dummy called"); }
 }
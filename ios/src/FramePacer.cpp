@@ -0,0 +1,100 @@
+#include "FramePacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace polyvox {
+
+  using namespace std::chrono;
+
+  // extra slack added to the predicted cost so that a frame of average cost doesn't land right on the vsync
+  static constexpr double kSafetyMarginInNanos = 500000;
+
+  static float toMilliseconds(double nanos) {
+    return (float)(nanos / 1000000.0);
+  }
+
+  void FramePacer::setRefreshRate(float refreshRate) {
+    if(refreshRate > 0) {
+      _refreshRate = refreshRate;
+    }
+  }
+
+  void FramePacer::setFrameInterval(float frameIntervalInMilliseconds) {
+    if(frameIntervalInMilliseconds > 0) {
+      _frameIntervalInMilliseconds = frameIntervalInMilliseconds;
+    }
+  }
+
+  ///
+  /// The requested frame interval, rounded to a whole number of display refresh periods.
+  ///
+  FramePacer::clock::duration FramePacer::framePeriod() const {
+    auto refreshPeriodInNanos = 1e9 / _refreshRate.load();
+    auto vsyncs = std::max(1.0, std::round(_frameIntervalInMilliseconds.load() * 1e6 / refreshPeriodInNanos));
+    return duration_cast<clock::duration>(duration<double, std::nano>(vsyncs * refreshPeriodInNanos));
+  }
+
+  FramePacer::clock::duration FramePacer::predictedCost() const {
+    return duration_cast<clock::duration>(duration<double, std::nano>(
+        _averageCostInNanos + 2 * _costDeviationInNanos + kSafetyMarginInNanos));
+  }
+
+  uint64_t FramePacer::beginFrame() {
+    _frameStart = clock::now();
+    if(!_started) {
+      _started = true;
+      _target = _frameStart + predictedCost();
+    } else {
+      auto jitter = std::abs(duration<double, std::nano>(_frameStart - _scheduledWake).count());
+      std::lock_guard<std::mutex> lock(_statsMutex);
+      _stats.averageJitterInMilliseconds += (toMilliseconds(jitter) - _stats.averageJitterInMilliseconds) / 16;
+      _stats.maxJitterInMilliseconds = std::max(_stats.maxJitterInMilliseconds, toMilliseconds(jitter));
+    }
+    return (uint64_t)duration_cast<nanoseconds>(_target.time_since_epoch()).count();
+  }
+
+  FramePacer::clock::time_point FramePacer::endFrame() {
+    auto now = clock::now();
+    double cost = duration<double, std::nano>(now - _frameStart).count();
+    _averageCostInNanos += (cost - _averageCostInNanos) / 8;
+    _costDeviationInNanos += (std::abs(cost - _averageCostInNanos) - _costDeviationInNanos) / 4;
+
+    auto refreshPeriod = duration_cast<clock::duration>(duration<double>(1.0 / _refreshRate.load()));
+    auto predicted = predictedCost();
+
+    // the next frame targets the next vsync on the timeline; if we can't make it (even if we start immediately),
+    // drop whole refresh periods rather than trying to catch up.
+    auto next = _target + framePeriod();
+    uint64_t skipped = 0;
+    while(next - predicted < now) {
+      next += refreshPeriod;
+      skipped++;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_statsMutex);
+      _stats.frameCount++;
+      if(now > _target) {
+        _stats.missedDeadlines++;
+      }
+      _stats.skippedVsyncs += skipped;
+      _stats.lastFrameCostInMilliseconds = toMilliseconds(cost);
+      _stats.predictedFrameCostInMilliseconds = toMilliseconds(duration<double, std::nano>(predicted).count());
+    }
+
+    _target = next;
+    _scheduledWake = next - predicted;
+    return _scheduledWake;
+  }
+
+  FramePacerStats FramePacer::getStats() {
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    return _stats;
+  }
+
+  void FramePacer::resetStats() {
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    _stats = FramePacerStats();
+  }
+}
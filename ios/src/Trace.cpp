@@ -0,0 +1,110 @@
+#include "Trace.hpp"
+
+#ifdef FLUTTER_FILAMENT_TRACING
+
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "Log.hpp"
+
+namespace polyvox {
+
+  std::atomic<bool> Tracer::_enabled { false };
+
+  static std::mutex _traceMutex;
+  static std::unique_ptr<Tracer::Event[]> _events;
+  static size_t _capacity = 0;
+  static std::atomic<uint64_t> _nextEvent { 0 };
+  static std::atomic<int> _activeWriters { 0 };
+  static std::string _outputPath;
+
+  static uint32_t currentThreadId() {
+    static std::atomic<uint32_t> nextThreadId { 1 };
+    thread_local uint32_t threadId = nextThreadId++;
+    return threadId;
+  }
+
+  static void writeEscaped(std::ofstream& out, const char* str) {
+    for(const char* c = str; *c; c++) {
+      if(*c == '"' || *c == '\\') {
+        out << '\\';
+      }
+      out << *c;
+    }
+  }
+
+  bool Tracer::start(const char* outputPath, size_t maxEvents) {
+    std::lock_guard<std::mutex> lock(_traceMutex);
+    if(_enabled) {
+      Log("Tracing already started");
+      return false;
+    }
+    if(!outputPath || maxEvents == 0) {
+      Log("Invalid trace output path or event count");
+      return false;
+    }
+    _events.reset(new Event[maxEvents]);
+    _capacity = maxEvents;
+    _nextEvent = 0;
+    _outputPath = outputPath;
+    _enabled = true;
+    Log("Started tracing (max %zu events) to %s", maxEvents, outputPath);
+    return true;
+  }
+
+  void Tracer::record(const char* name, const char* category, uint64_t start, uint64_t end) {
+    // stop() waits for active writers to finish before reading the ring, so register before re-checking the enabled flag
+    _activeWriters++;
+    if(_enabled) {
+      auto index = _nextEvent.fetch_add(1, std::memory_order_relaxed);
+      _events[index % _capacity] = { name, category, start, end - start, currentThreadId() };
+    }
+    _activeWriters--;
+  }
+
+  bool Tracer::stop() {
+    std::lock_guard<std::mutex> lock(_traceMutex);
+    if(!_enabled) {
+      Log("Tracing not started");
+      return false;
+    }
+    _enabled = false;
+    while(_activeWriters > 0) {
+      std::this_thread::yield();
+    }
+
+    std::ofstream out(_outputPath);
+    if(!out) {
+      Log("Failed to open trace output file %s", _outputPath.c_str());
+      _events.reset();
+      return false;
+    }
+
+    uint64_t count = _nextEvent;
+    uint64_t first = count > _capacity ? count - _capacity : 0;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for(uint64_t i = first; i < count; i++) {
+      const auto& event = _events[i % _capacity];
+      if(i != first) {
+        out << ",\n";
+      }
+      out << "{\"name\":\"";
+      writeEscaped(out, event.name);
+      out << "\",\"cat\":\"";
+      writeEscaped(out, event.category);
+      out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadId
+          << ",\"ts\":" << event.startInMicroseconds
+          << ",\"dur\":" << event.durationInMicroseconds << "}";
+    }
+    out << "]}\n";
+    out.close();
+
+    Log("Wrote %llu trace events to %s (%llu dropped)", (unsigned long long)(count - first), _outputPath.c_str(), (unsigned long long)first);
+    _events.reset();
+    return true;
+  }
+}
+
+#endif
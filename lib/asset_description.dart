@@ -0,0 +1,110 @@
+import 'dart:convert';
+import 'dart:typed_data';
+
+import 'package:flutter_filament/generated_bindings.dart';
+
+class AssetNode {
+  final String name;
+
+  /// Index of the parent node in [AssetDescription.nodes], or -1 if this is a root.
+  final int parentIndex;
+  final int flags;
+  final List<String> morphTargetNames;
+
+  bool get isRenderable => flags & AssetNodeFlags.ASSET_NODE_RENDERABLE != 0;
+  bool get isLight => flags & AssetNodeFlags.ASSET_NODE_LIGHT != 0;
+  bool get isCamera => flags & AssetNodeFlags.ASSET_NODE_CAMERA != 0;
+
+  AssetNode(this.name, this.parentIndex, this.flags, this.morphTargetNames);
+}
+
+class AssetAnimation {
+  final String name;
+  final double durationInSeconds;
+
+  AssetAnimation(this.name, this.durationInSeconds);
+}
+
+class AssetSkin {
+  final String name;
+
+  /// Index of each joint in [AssetDescription.nodes] (-1 if the joint isn't a node of this asset).
+  final List<int> jointNodeIndices;
+
+  AssetSkin(this.name, this.jointNodeIndices);
+}
+
+///
+/// The node hierarchy, animations and skins of an asset, as returned by [FilamentController.describeAsset].
+/// See ASSET_DESCRIPTION_MAGIC in FlutterFilamentApi.h for the binary layout this is decoded from.
+///
+class AssetDescription {
+  final List<AssetNode> nodes;
+  final List<AssetAnimation> animations;
+  final List<AssetSkin> skins;
+
+  AssetDescription(this.nodes, this.animations, this.skins);
+
+  factory AssetDescription.decode(Uint8List bytes) {
+    var data = ByteData.sublistView(bytes);
+    var offset = 0;
+
+    int u8() => data.getUint8(offset++);
+    int u16() {
+      var v = data.getUint16(offset, Endian.little);
+      offset += 2;
+      return v;
+    }
+
+    int u32() {
+      var v = data.getUint32(offset, Endian.little);
+      offset += 4;
+      return v;
+    }
+
+    int i32() {
+      var v = data.getInt32(offset, Endian.little);
+      offset += 4;
+      return v;
+    }
+
+    double f32() {
+      var v = data.getFloat32(offset, Endian.little);
+      offset += 4;
+      return v;
+    }
+
+    String str() {
+      var length = u16();
+      var s = utf8.decode(Uint8List.sublistView(bytes, offset, offset + length), allowMalformed: true);
+      offset += length;
+      return s;
+    }
+
+    if (bytes.length < 20 || u32() != ASSET_DESCRIPTION_MAGIC) {
+      throw Exception("Invalid asset description");
+    }
+    var version = u16();
+    if (version != ASSET_DESCRIPTION_VERSION) {
+      throw Exception("Unsupported asset description version $version");
+    }
+    u16(); // reserved
+    var nodeCount = u32();
+    var animationCount = u32();
+    var skinCount = u32();
+
+    var nodes = List<AssetNode>.generate(nodeCount, (_) {
+      var name = str();
+      var parentIndex = i32();
+      var flags = u8();
+      var morphTargetNames = List<String>.generate(u16(), (_) => str());
+      return AssetNode(name, parentIndex, flags, morphTargetNames);
+    });
+    var animations = List<AssetAnimation>.generate(animationCount, (_) => AssetAnimation(str(), f32()));
+    var skins = List<AssetSkin>.generate(skinCount, (_) {
+      var name = str();
+      return AssetSkin(name, List<int>.generate(u32(), (_) => i32()));
+    });
+    return AssetDescription(nodes, animations, skins);
+  }
+}
@@ -1,10 +1,12 @@
 // ignore_for_file: constant_identifier_names
 
 import 'dart:async';
+import 'dart:typed_data';
 import 'dart:ui' as ui;
 import 'package:flutter/widgets.dart';
 
 import 'package:flutter_filament/animations/animation_data.dart';
+import 'package:flutter_filament/asset_description.dart';
 import 'package:vector_math/vector_math_64.dart';
 
 // a handle that can be safely passed back to the rendering layer to manipulate an Entity
@@ -25,6 +27,46 @@ class TextureDetails {
   TextureDetails({required this.textureId, required this.width, required this.height});
 }
 
+///
+/// The closest triangle hit by a ray cast with [FilamentController.raycast].
+///
+class RaycastResult {
+  final FilamentEntity asset;
+
+  /// The renderable entity that was hit.
+  final FilamentEntity entity;
+  final int primitive;
+  final int triangle;
+
+  /// Barycentric coordinates of the hit, relative to the triangle's second and third vertices.
+  final double u;
+  final double v;
+  final double distance;
+  final Vector3 position;
+
+  RaycastResult(this.asset, this.entity, this.primitive, this.triangle, this.u, this.v, this.distance, this.position);
+}
+
+///
+/// The result of a GPU pick queued with [FilamentController.queuePicks].
+///
+class PickQueryResult {
+  /// As returned by [FilamentController.queuePicks].
+  final int requestId;
+  final int channel;
+
+  /// The renderable entity at the requested point (0 if there is none).
+  final FilamentEntity entity;
+
+  /// Depth buffer value at the requested point (1 at the near plane, 0 at infinity).
+  final double depth;
+
+  /// The requested point, in the same coordinates passed to [FilamentController.queuePicks].
+  final ui.Offset point;
+
+  PickQueryResult(this.requestId, this.channel, this.entity, this.depth, this.point);
+}
+
 abstract class FilamentController {
   ///
   /// A Stream containing every FilamentEntity added to the scene (i.e. via [loadGlb], [loadGltf] or [addLight]).
@@ -70,6 +112,11 @@ abstract class FilamentController {
   ///
   Stream<FilamentEntity?> get pickResult;
 
+  ///
+  /// The results of [queuePicks], delivered in batches (every request resolved during a frame arrives together).
+  ///
+  Stream<List<PickQueryResult>> get pickResults;
+
   ///
   /// Whether the controller is currently rendering at [framerate].
   ///
@@ -90,6 +137,13 @@ abstract class FilamentController {
   ///
   Future setFrameRate(int framerate);
 
+  ///
+  /// When [enabled] is true, continuous rendering (see [setRendering]) only renders a frame when something in the scene has changed
+  /// (e.g. an animation is playing, the camera has moved or an asset was transformed).
+  /// If [idleFrameRate] is greater than zero, a frame will also be rendered at least this often even if nothing has changed.
+  ///
+  Future setOnDemandRendering(bool enabled, {double idleFrameRate = 0});
+
   ///
   /// Destroys the viewer and all backing textures. You can leave the FilamentWidget in the hierarchy after this is called, but you will need to manually call [createViewer] to
   ///
@@ -197,6 +251,25 @@ abstract class FilamentController {
   ///
   Future<FilamentEntity> loadGlb(String path, {bool unlit = false});
 
+  ///
+  /// Load the .glb asset at the given path once and insert [numInstances] instances of it into the scene.
+  /// Instances share GPU buffers, textures and materials, but can be transformed, animated and hidden independently.
+  ///
+  Future<List<FilamentEntity>> loadGlbInstanced(String path, int numInstances);
+
+  ///
+  /// Create another instance of an asset loaded with [loadGlbInstanced] ([entity] can be any existing instance).
+  ///
+  Future<FilamentEntity> createInstance(FilamentEntity entity);
+
+  ///
+  /// Enable (or, with a budget of 0, disable) caching of parsed .glb files by [loadGlb], up to [budgetInBytes] of source file data.
+  /// While enabled, loading the same file again only creates another instance of the cached asset.
+  /// Removed instances are reused, and keep any material changes made while they were in the scene.
+  /// Disabled by default.
+  ///
+  Future setAssetCacheBudget(int budgetInBytes);
+
   ///
   /// Load the .gltf asset at the given path and insert into the scene.
   /// [relativeResourcePath] is the folder path where the glTF resources are stored;
@@ -243,6 +316,12 @@ abstract class FilamentController {
 
   Future<List<String>> getAnimationNames(FilamentEntity entity);
 
+  ///
+  /// Returns the node hierarchy (including morph target names), animations and skins of [entity] in a single call.
+  /// Prefer this to enumerating names one at a time with [getAnimationNames]/[getMorphTargetNames] when inspecting large assets.
+  ///
+  Future<AssetDescription> describeAsset(FilamentEntity entity);
+
   ///
   /// Returns the length (in seconds) of the animation at the given index.
   ///
@@ -253,6 +332,7 @@ abstract class FilamentController {
   /// This method will check the morph target names specified in [animation] against the morph target names that actually exist exist under [meshName] in [entity],
   /// throwing an exception if any cannot be found.
   /// It is permissible for [animation] to omit any targets that do exist under [meshName]; these simply won't be animated.
+  /// Weights are interpolated linearly between frames, so the frame rate of [animation] can be well below the display's.
   ///
   Future setMorphAnimationData(FilamentEntity entity, MorphAnimationData animation);
 
@@ -261,9 +341,48 @@ abstract class FilamentController {
   /// [morphWeights] is a list of doubles in frame-major format.
   /// Each frame is [numWeights] in length, and each entry is the weight to be applied to the morph target located at that index in the mesh primitive at that frame.
   /// for now we only allow animating a single bone (though multiple skinned targets are supported)
+  /// Rotations are interpolated between frames, so the frame rate of [animation] can be well below the display's.
   ///
   Future setBoneAnimation(FilamentEntity entity, BoneAnimationData animation);
 
+  ///
+  /// Adds a clip to the bone mixer of [entity], animating the nodes named [boneNames] (which needn't be joints).
+  /// [frameData] is laid out as numFrames x [boneNames].length x [locX, locY, locZ, rotW, rotX, rotY, rotZ], relative to each node's
+  /// local transform when it was first animated by the mixer.
+  /// Returns the index of the clip, to pass to [addBoneAnimationLayer].
+  ///
+  Future<int> addBoneAnimationClip(FilamentEntity entity, List<String> boneNames, Float32List frameData, double frameLengthInMs);
+
+  ///
+  /// Starts playing [clipIndex] as a new layer of the bone mixer of [entity], applied on top of any existing layers.
+  /// A normal layer blends from the pose so far towards the clip by [weight]; an [additive] layer adds the clip, scaled by [weight],
+  /// to the pose so far. A layer that doesn't [loop] holds its last frame until it is removed.
+  /// Returns the index of the layer (which may be the index of a previously removed layer).
+  ///
+  Future<int> addBoneAnimationLayer(FilamentEntity entity, int clipIndex,
+      {double weight = 1.0, bool additive = false, bool loop = true});
+
+  ///
+  /// Sets the weight of bone mixer layer [layerIndex] of [entity].
+  ///
+  Future setBoneAnimationLayerWeight(FilamentEntity entity, int layerIndex, double weight);
+
+  ///
+  /// Restricts bone mixer layer [layerIndex] of [entity] to the nodes named [boneNames], scaling its weight for each by [weights] (or 1).
+  /// An empty [boneNames] removes the mask.
+  ///
+  Future setBoneAnimationLayerMask(FilamentEntity entity, int layerIndex, List<String> boneNames, {List<double>? weights});
+
+  ///
+  /// Stops bone mixer layer [layerIndex] of [entity].
+  ///
+  Future removeBoneAnimationLayer(FilamentEntity entity, int layerIndex);
+
+  ///
+  /// Removes every bone mixer layer and clip from [entity], returning the nodes they animated to their rest transforms.
+  ///
+  Future clearBoneAnimationLayers(FilamentEntity entity);
+
   ///
   /// Removes/destroys the specified entity from the scene.
   /// [entity] will no longer be a valid handle after this method is called; ensure you immediately discard all references once this method is complete.
@@ -405,6 +524,13 @@ abstract class FilamentController {
   ///
   Future setPosition(FilamentEntity entity, double x, double y, double z);
 
+  ///
+  /// Sets the position, rotation and/or (uniform) scale of many entities at once.
+  /// [positions] holds 3 values (xyz) per entity, [rotations] 4 values (quaternion xyzw) per entity and [scales] 1 value per entity.
+  /// Omit any of these to leave that component unchanged.
+  ///
+  Future setTransforms(List<FilamentEntity> entities, {List<double>? positions, List<double>? rotations, List<double>? scales});
+
   ///
   /// Enable/disable postprocessing.
   ///
@@ -433,11 +559,29 @@ abstract class FilamentController {
   ///
   /// Used to select the entity in the scene at the given viewport coordinates.
   /// Called by `FilamentGestureDetector` on a mouse/finger down event. You probably don't want to call this yourself.
-  /// This is asynchronous and will require 2-3 frames to complete - subscribe to the [pickResult] stream to receive the results of this method.
+  /// Subscribe to the [pickResult] stream to receive the results of this method (nothing is added if there is no entity at [x],[y]).
   /// [x] and [y] must be in local logical coordinates (i.e. where 0,0 is at top-left of the FilamentWidget).
   ///
   void pick(int x, int y);
 
+  ///
+  /// Casts a ray from the camera through each of [points] against the CPU-side copy of every asset's geometry,
+  /// returning the closest hit for each point (or null if nothing was hit).
+  /// Unlike [pick], this completes without waiting for a frame to be rendered, so is suitable for hover highlighting.
+  /// Meshes are tested in their bind pose (skinning and morph targets are ignored).
+  /// Points must be in local logical coordinates (i.e. where 0,0 is at top-left of the FilamentWidget).
+  ///
+  Future<List<RaycastResult?>> raycast(List<ui.Offset> points);
+
+  ///
+  /// Queues a GPU pick at each of [points] without waiting for the render thread, returning the request ID of the first point
+  /// (the remaining points are numbered consecutively). Results arrive on [pickResults] once the next frame has been rendered.
+  /// If [channel] is non-zero, any earlier requests on the same channel that haven't yet been rendered are dropped, so a
+  /// pointer that moves faster than frames are rendered only has its latest position picked.
+  /// Points must be in local logical coordinates (i.e. where 0,0 is at top-left of the FilamentWidget).
+  ///
+  Future<int> queuePicks(List<ui.Offset> points, {int channel = 0});
+
   ///
   /// Retrieves the name assigned to the given FilamentEntity (usually corresponds to the glTF mesh name).
   ///
@@ -3,6 +3,7 @@
 import 'dart:async';
 import 'dart:ffi';
 import 'dart:io';
+import 'dart:typed_data';
 import 'dart:ui' as ui;
 import 'dart:developer' as dev;
 import 'package:flutter/services.dart';
@@ -12,6 +13,7 @@ import 'package:flutter/widgets.dart';
 import 'package:flutter_filament/filament_controller.dart';
 
 import 'package:flutter_filament/animations/animation_data.dart';
+import 'package:flutter_filament/asset_description.dart';
 import 'package:flutter_filament/generated_bindings.dart';
 import 'package:flutter_filament/rendering_surface.dart';
 import 'package:vector_math/vector_math_64.dart';
@@ -53,6 +55,13 @@ class FilamentControllerFFI extends FilamentController {
   Stream<FilamentEntity> get pickResult => _pickResultController.stream;
   final _pickResultController = StreamController<FilamentEntity>.broadcast();
 
+  @override
+  Stream<List<PickQueryResult>> get pickResults => _pickResultsController.stream;
+  final _pickResultsController = StreamController<List<PickQueryResult>>.broadcast();
+
+  // registered with the viewer by the first call to queuePicks
+  NativeCallable<Void Function(Pointer<PickResult>, Int32)>? _pickResultsCallback;
+
   int? _resizingWidth;
   int? _resizingHeight;
 
@@ -127,7 +136,15 @@ class FilamentControllerFFI extends FilamentController {
 
   @override
   Future setFrameRate(int framerate) async {
-    set_frame_interval_ffi(1.0 / framerate);
+    set_frame_interval_ffi(1000.0 / framerate);
+  }
+
+  @override
+  Future setOnDemandRendering(bool enabled, {double idleFrameRate = 0}) async {
+    if (_viewer == null) {
+      throw Exception("No viewer available, ignoring");
+    }
+    set_on_demand_rendering_ffi(_viewer!, enabled, idleFrameRate);
   }
 
   @override
@@ -153,6 +170,8 @@ class FilamentControllerFFI extends FilamentController {
 
     _assetManager = null;
     destroy_filament_viewer_ffi(viewer!);
+    _pickResultsCallback?.close();
+    _pickResultsCallback = null;
     hasViewer.value = false;
   }
 
@@ -451,7 +470,19 @@ class FilamentControllerFFI extends FilamentController {
     if (unlit) {
       throw Exception("Not yet implemented");
     }
-    var entity = load_glb_ffi(_assetManager!, path.toNativeUtf8().cast<Char>(), unlit);
+    // the callback is invoked on the render thread, so it must be a listener (a Pointer.fromFunction callback can only be
+    // called on the isolate's own thread); the entity is delivered to this isolate asynchronously
+    final completer = Completer<FilamentEntity>();
+    final callback = NativeCallable<Void Function(EntityId)>.listener((int entity) {
+      completer.complete(entity);
+    });
+    using((arena) {
+      // the path is copied before load_glb_with_callback_ffi returns
+      load_glb_with_callback_ffi(
+          _assetManager!, path.toNativeUtf8(allocator: arena).cast<Char>(), unlit, callback.nativeFunction);
+    });
+    final entity = await completer.future;
+    callback.close();
     if (entity == _FILAMENT_ASSET_ERROR) {
       throw Exception("An error occurred loading the asset at $path");
     }
@@ -460,6 +491,49 @@ class FilamentControllerFFI extends FilamentController {
     return entity;
   }
 
+  @override
+  Future<List<FilamentEntity>> loadGlbInstanced(String path, int numInstances) async {
+    if (_viewer == null) {
+      throw Exception("No viewer available, ignoring");
+    }
+    var entities = using((arena) {
+      var outPtr = arena<EntityId>(numInstances);
+      var count = load_glb_instanced_ffi(
+          _assetManager!, path.toNativeUtf8(allocator: arena).cast<Char>(), numInstances, outPtr);
+      if (count == 0) {
+        throw Exception("An error occurred loading the asset at $path");
+      }
+      return List<FilamentEntity>.generate(count, (i) => outPtr[i]);
+    });
+    for (final entity in entities) {
+      _entities.add(entity);
+      _onLoadController.sink.add(entity);
+    }
+    return entities;
+  }
+
+  @override
+  Future<FilamentEntity> createInstance(FilamentEntity entity) async {
+    if (_viewer == null) {
+      throw Exception("No viewer available, ignoring");
+    }
+    var instance = create_instance_ffi(_assetManager!, entity);
+    if (instance == _FILAMENT_ASSET_ERROR) {
+      throw Exception("Failed to create instance of entity $entity");
+    }
+    _entities.add(instance);
+    _onLoadController.sink.add(instance);
+    return instance;
+  }
+
+  @override
+  Future setAssetCacheBudget(int budgetInBytes) async {
+    if (_viewer == null) {
+      throw Exception("No viewer available, ignoring");
+    }
+    set_asset_cache_budget_ffi(_assetManager!, budgetInBytes);
+  }
+
   @override
   Future<FilamentEntity> loadGltf(String path, String relativeResourcePath, {bool force = false}) async {
     if (Platform.isWindows && !force) {
@@ -484,7 +558,7 @@ class FilamentControllerFFI extends FilamentController {
     if (_viewer == null) {
       throw Exception("No viewer available, ignoring");
     }
-    grab_begin(_viewer!, x * _pixelRatio, y * _pixelRatio, true);
+    grab_begin_ffi(_viewer!, x * _pixelRatio, y * _pixelRatio, true);
   }
 
   @override
@@ -492,7 +566,7 @@ class FilamentControllerFFI extends FilamentController {
     if (_viewer == null) {
       throw Exception("No viewer available, ignoring");
     }
-    grab_update(_viewer!, x * _pixelRatio, y * _pixelRatio);
+    grab_update_ffi(_viewer!, x * _pixelRatio, y * _pixelRatio);
   }
 
   @override
@@ -500,7 +574,7 @@ class FilamentControllerFFI extends FilamentController {
     if (_viewer == null) {
       throw Exception("No viewer available, ignoring");
     }
-    grab_end(_viewer!);
+    grab_end_ffi(_viewer!);
   }
 
   @override
@@ -508,7 +582,7 @@ class FilamentControllerFFI extends FilamentController {
     if (_viewer == null) {
       throw Exception("No viewer available, ignoring");
     }
-    grab_begin(_viewer!, x * _pixelRatio, y * _pixelRatio, false);
+    grab_begin_ffi(_viewer!, x * _pixelRatio, y * _pixelRatio, false);
   }
 
   @override
@@ -516,7 +590,7 @@ class FilamentControllerFFI extends FilamentController {
     if (_viewer == null) {
       throw Exception("No viewer available, ignoring");
     }
-    grab_update(_viewer!, x * _pixelRatio, y * _pixelRatio);
+    grab_update_ffi(_viewer!, x * _pixelRatio, y * _pixelRatio);
   }
 
   @override
@@ -524,7 +598,7 @@ class FilamentControllerFFI extends FilamentController {
     if (_viewer == null) {
       throw Exception("No viewer available, ignoring");
     }
-    grab_end(_viewer!);
+    grab_end_ffi(_viewer!);
   }
 
   @override
@@ -573,6 +647,25 @@ class FilamentControllerFFI extends FilamentController {
     return names;
   }
 
+  @override
+  Future<AssetDescription> describeAsset(FilamentEntity entity) async {
+    if (_viewer == null) {
+      throw Exception("No viewer available, ignoring");
+    }
+    var lengthPtr = calloc<Int>(1);
+    var buffer = describe_asset_alloc_ffi(_assetManager!, entity, lengthPtr);
+    var length = lengthPtr.value;
+    calloc.free(lengthPtr);
+    if (buffer == nullptr) {
+      throw Exception("Failed to describe entity $entity");
+    }
+    try {
+      return AssetDescription.decode(buffer.asTypedList(length));
+    } finally {
+      free_asset_description(buffer);
+    }
+  }
+
   @override
   Future<double> getAnimationDuration(FilamentEntity entity, int animationIndex) async {
     if (_viewer == null) {
@@ -654,6 +747,98 @@ class FilamentControllerFFI extends FilamentController {
     // calloc.free(data);
   }
 
+  @override
+  Future<int> addBoneAnimationClip(
+      FilamentEntity entity, List<String> boneNames, Float32List frameData, double frameLengthInMs) async {
+    if (_viewer == null) {
+      throw Exception("No viewer available, ignoring");
+    }
+    var numBones = boneNames.length;
+    if (numBones == 0 || frameData.length % (numBones * 7) != 0) {
+      throw Exception("Frame data must contain 7 values for each of the ${boneNames.length} bones in every frame");
+    }
+    var clipIndex = using((arena) {
+      var dataPtr = arena<Float>(frameData.length);
+      dataPtr.asTypedList(frameData.length).setAll(0, frameData);
+      var namesPtr = arena<Pointer<Char>>(numBones);
+      for (int i = 0; i < numBones; i++) {
+        namesPtr[i] = boneNames[i].toNativeUtf8(allocator: arena).cast<Char>();
+      }
+      return add_bone_animation_clip_ffi(_assetManager!, entity, dataPtr, frameData.length ~/ (numBones * 7), numBones,
+          namesPtr, frameLengthInMs);
+    });
+    if (clipIndex < 0) {
+      throw Exception("Failed to add bone animation clip to entity $entity");
+    }
+    return clipIndex;
+  }
+
+  @override
+  Future<int> addBoneAnimationLayer(FilamentEntity entity, int clipIndex,
+      {double weight = 1.0, bool additive = false, bool loop = true}) async {
+    if (_viewer == null) {
+      throw Exception("No viewer available, ignoring");
+    }
+    var layerIndex = add_bone_animation_layer_ffi(_assetManager!, entity, clipIndex, weight, additive, loop);
+    if (layerIndex < 0) {
+      throw Exception("Failed to add bone animation layer for clip $clipIndex to entity $entity");
+    }
+    return layerIndex;
+  }
+
+  @override
+  Future setBoneAnimationLayerWeight(FilamentEntity entity, int layerIndex, double weight) async {
+    if (_viewer == null) {
+      throw Exception("No viewer available, ignoring");
+    }
+    set_bone_animation_layer_weight_ffi(_assetManager!, entity, layerIndex, weight);
+  }
+
+  @override
+  Future setBoneAnimationLayerMask(FilamentEntity entity, int layerIndex, List<String> boneNames,
+      {List<double>? weights}) async {
+    if (_viewer == null) {
+      throw Exception("No viewer available, ignoring");
+    }
+    if (weights != null && weights.length != boneNames.length) {
+      throw Exception("Expected a weight for each of the ${boneNames.length} bones, got ${weights.length}");
+    }
+    var result = using((arena) {
+      var namesPtr = arena<Pointer<Char>>(boneNames.length);
+      for (int i = 0; i < boneNames.length; i++) {
+        namesPtr[i] = boneNames[i].toNativeUtf8(allocator: arena).cast<Char>();
+      }
+      Pointer<Float> weightsPtr = nullptr;
+      if (weights != null) {
+        weightsPtr = arena<Float>(weights.length);
+        for (int i = 0; i < weights.length; i++) {
+          weightsPtr[i] = weights[i];
+        }
+      }
+      return set_bone_animation_layer_mask_ffi(
+          _assetManager!, entity, layerIndex, namesPtr, weightsPtr, boneNames.length);
+    });
+    if (!result) {
+      throw Exception("Failed to set the mask of bone animation layer $layerIndex on entity $entity");
+    }
+  }
+
+  @override
+  Future removeBoneAnimationLayer(FilamentEntity entity, int layerIndex) async {
+    if (_viewer == null) {
+      throw Exception("No viewer available, ignoring");
+    }
+    remove_bone_animation_layer_ffi(_assetManager!, entity, layerIndex);
+  }
+
+  @override
+  Future clearBoneAnimationLayers(FilamentEntity entity) async {
+    if (_viewer == null) {
+      throw Exception("No viewer available, ignoring");
+    }
+    clear_bone_animation_layers_ffi(_assetManager!, entity);
+  }
+
   @override
   Future removeAsset(FilamentEntity entity) async {
     if (_viewer == null) {
@@ -682,7 +867,7 @@ class FilamentControllerFFI extends FilamentController {
     if (_viewer == null) {
       throw Exception("No viewer available, ignoring");
     }
-    scroll_begin(_viewer!);
+    scroll_begin_ffi(_viewer!);
   }
 
   @override
@@ -690,7 +875,7 @@ class FilamentControllerFFI extends FilamentController {
     if (_viewer == null) {
       throw Exception("No viewer available, ignoring");
     }
-    scroll_update(_viewer!, x, y, z);
+    scroll_update_ffi(_viewer!, x, y, z);
   }
 
   @override
@@ -698,7 +883,7 @@ class FilamentControllerFFI extends FilamentController {
     if (_viewer == null) {
       throw Exception("No viewer available, ignoring");
     }
-    scroll_end(_viewer!);
+    scroll_end_ffi(_viewer!);
   }
 
   @override
@@ -768,7 +953,7 @@ class FilamentControllerFFI extends FilamentController {
     if (_viewer == null) {
       throw Exception("No viewer available, ignoring");
     }
-    set_camera_focal_length(_viewer!, focalLength);
+    set_camera_focal_length_ffi(_viewer!, focalLength);
   }
 
   @override
@@ -776,7 +961,7 @@ class FilamentControllerFFI extends FilamentController {
     if (_viewer == null) {
       throw Exception("No viewer available, ignoring");
     }
-    set_camera_focus_distance(_viewer!, focusDistance);
+    set_camera_focus_distance_ffi(_viewer!, focusDistance);
   }
 
   @override
@@ -784,7 +969,7 @@ class FilamentControllerFFI extends FilamentController {
     if (_viewer == null) {
       throw Exception("No viewer available, ignoring");
     }
-    set_camera_position(_viewer!, x, y, z);
+    set_camera_position_ffi(_viewer!, x, y, z);
   }
 
   @override
@@ -808,7 +993,7 @@ class FilamentControllerFFI extends FilamentController {
     if (_viewer == null) {
       throw Exception("No viewer available, ignoring");
     }
-    set_camera_exposure(_viewer!, aperture, shutterSpeed, sensitivity);
+    set_camera_exposure_ffi(_viewer!, aperture, shutterSpeed, sensitivity);
   }
 
   @override
@@ -816,7 +1001,7 @@ class FilamentControllerFFI extends FilamentController {
     if (_viewer == null) {
       throw Exception("No viewer available, ignoring");
     }
-    set_camera_rotation(_viewer!, rads, x, y, z);
+    set_camera_rotation_ffi(_viewer!, rads, x, y, z);
   }
 
   @override
@@ -829,7 +1014,7 @@ class FilamentControllerFFI extends FilamentController {
     for (int i = 0; i < 16; i++) {
       ptr.elementAt(i).value = matrix[i];
     }
-    set_camera_model_matrix(_viewer!, ptr);
+    set_camera_model_matrix_ffi(_viewer!, ptr);
     calloc.free(ptr);
   }
 
@@ -865,7 +1050,35 @@ class FilamentControllerFFI extends FilamentController {
     if (_viewer == null) {
       throw Exception("No viewer available, ignoring");
     }
-    set_position(_assetManager!, entity, x, y, z);
+    set_position_ffi(_assetManager!, entity, x, y, z);
+  }
+
+  @override
+  Future setTransforms(List<FilamentEntity> entities,
+      {List<double>? positions, List<double>? rotations, List<double>? scales}) async {
+    if (_viewer == null) {
+      throw Exception("No viewer available, ignoring");
+    }
+    for (final (values, stride) in [(positions, 3), (rotations, 4), (scales, 1)]) {
+      if (values != null && values.length != entities.length * stride) {
+        throw Exception("Expected ${entities.length * stride} values, got ${values.length}");
+      }
+    }
+    using((arena) {
+      Pointer<Float> toNative(List<double>? values) {
+        if (values == null) {
+          return nullptr;
+        }
+        var ptr = arena<Float>(values.length);
+        ptr.asTypedList(values.length).setAll(0, values);
+        return ptr;
+      }
+
+      var entitiesPtr = arena<EntityId>(entities.length);
+      entitiesPtr.asTypedList(entities.length).setAll(0, entities);
+      set_transforms_ffi(_assetManager!, entitiesPtr, toNative(positions), toNative(rotations), toNative(scales),
+          entities.length);
+    });
   }
 
   @override
@@ -873,7 +1086,7 @@ class FilamentControllerFFI extends FilamentController {
     if (_viewer == null) {
       throw Exception("No viewer available, ignoring");
     }
-    set_scale(_assetManager!, entity, scale);
+    set_scale_ffi(_assetManager!, entity, scale);
   }
 
   @override
@@ -881,7 +1094,7 @@ class FilamentControllerFFI extends FilamentController {
     if (_viewer == null) {
       throw Exception("No viewer available, ignoring");
     }
-    set_rotation(_assetManager!, entity, rads, x, y, z);
+    set_rotation_ffi(_assetManager!, entity, rads, x, y, z);
   }
 
   @override
@@ -920,18 +1133,68 @@ class FilamentControllerFFI extends FilamentController {
     outPtr.value = 0;
 
     pick_ffi(_viewer!, x, textureDetails.value!.height - y, outPtr);
-    int wait = 0;
-    while (outPtr.value == 0) {
-      await Future.delayed(const Duration(milliseconds: 32));
-      wait++;
-      if (wait > 10) {
-        calloc.free(outPtr);
-        throw Exception("Failed to get picking result");
-      }
-    }
     var entityId = outPtr.value;
-    _pickResultController.add(entityId);
     calloc.free(outPtr);
+    if (entityId != 0) {
+      _pickResultController.add(entityId);
+    }
+  }
+
+  @override
+  Future<List<RaycastResult?>> raycast(List<ui.Offset> points) async {
+    if (_viewer == null) {
+      throw Exception("No viewer available, ignoring");
+    }
+    final pointsPtr = calloc<Float>(points.length * 2);
+    final hitsPtr = calloc<RaycastHit>(points.length);
+    for (int i = 0; i < points.length; i++) {
+      pointsPtr.elementAt(i * 2).value = points[i].dx;
+      pointsPtr.elementAt(i * 2 + 1).value = textureDetails.value!.height - points[i].dy;
+    }
+    raycast_screen_batch_ffi(_viewer!, pointsPtr, points.length, hitsPtr);
+    var results = List<RaycastResult?>.generate(points.length, (i) {
+      var hit = hitsPtr.elementAt(i).ref;
+      if (hit.asset == 0) {
+        return null;
+      }
+      return RaycastResult(hit.asset, hit.entity, hit.primitive, hit.triangle, hit.u, hit.v, hit.distance,
+          Vector3(hit.position[0], hit.position[1], hit.position[2]));
+    });
+    calloc.free(pointsPtr);
+    calloc.free(hitsPtr);
+    return results;
+  }
+
+  @override
+  Future<int> queuePicks(List<ui.Offset> points, {int channel = 0}) async {
+    if (_viewer == null) {
+      throw Exception("No viewer available, ignoring");
+    }
+    if (_pickResultsCallback == null) {
+      // results are delivered on the render thread, so must be received by a listener
+      _pickResultsCallback = NativeCallable<Void Function(Pointer<PickResult>, Int32)>.listener(_onPickResults);
+      set_pick_results_callback_ffi(_viewer!, _pickResultsCallback!.nativeFunction);
+    }
+    return using((arena) {
+      final pointsPtr = arena<Int32>(points.length * 2);
+      for (int i = 0; i < points.length; i++) {
+        pointsPtr[i * 2] = points[i].dx.toInt();
+        pointsPtr[i * 2 + 1] = textureDetails.value!.height - points[i].dy.toInt();
+      }
+      return queue_picks_ffi(_viewer!, pointsPtr, points.length, channel);
+    });
+  }
+
+  void _onPickResults(Pointer<PickResult> results, int count) {
+    final height = textureDetails.value?.height ?? 0;
+    final batch = List<PickQueryResult>.generate(count, (i) {
+      final result = results[i];
+      return PickQueryResult(result.requestId, result.channel, result.entity, result.depth,
+          ui.Offset(result.x.toDouble(), (height - result.y).toDouble()));
+    });
+    // set_pick_results_callback_ffi hands over a copy of the results
+    flutter_filament_free(results.cast<Void>());
+    _pickResultsController.add(batch);
   }
 
   @override
@@ -156,6 +156,68 @@ external int load_gltf(
   ffi.Pointer<ffi.Char> relativePath,
 );
 
+@ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Char>, ffi.Int, ffi.Pointer<EntityId>)>(
+    symbol: 'load_glb_instanced', assetId: 'flutter_filament_plugin')
+external int load_glb_instanced(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<ffi.Char> assetPath,
+  int numInstances,
+  ffi.Pointer<EntityId> out,
+);
+
+@ffi.Native<EntityId Function(ffi.Pointer<ffi.Void>, EntityId)>(
+    symbol: 'create_instance', assetId: 'flutter_filament_plugin')
+external int create_instance(
+  ffi.Pointer<ffi.Void> assetManager,
+  int entityId,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Uint64)>(
+    symbol: 'set_asset_cache_budget', assetId: 'flutter_filament_plugin')
+external void set_asset_cache_budget(
+  ffi.Pointer<ffi.Void> assetManager,
+  int budgetInBytes,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Pointer<AssetCacheStats>)>(
+    symbol: 'get_asset_cache_stats', assetId: 'flutter_filament_plugin')
+external void get_asset_cache_stats(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<AssetCacheStats> out,
+);
+
+@ffi.Native<EntityId Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Char>, AssetLoadCallback)>(
+    symbol: 'load_glb_async', assetId: 'flutter_filament_plugin')
+external int load_glb_async(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<ffi.Char> assetPath,
+  AssetLoadCallback callback,
+);
+
+@ffi.Native<EntityId Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>, AssetLoadCallback)>(
+    symbol: 'load_gltf_async', assetId: 'flutter_filament_plugin')
+external int load_gltf_async(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<ffi.Char> assetPath,
+  ffi.Pointer<ffi.Char> relativePath,
+  AssetLoadCallback callback,
+);
+
+@ffi.Native<ffi.Bool Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Pointer<AssetLoadProgress>)>(
+    symbol: 'get_load_progress', assetId: 'flutter_filament_plugin')
+external bool get_load_progress(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  ffi.Pointer<AssetLoadProgress> out,
+);
+
+@ffi.Native<ffi.Bool Function(ffi.Pointer<ffi.Void>, EntityId)>(
+    symbol: 'cancel_load', assetId: 'flutter_filament_plugin')
+external bool cancel_load(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+);
+
 @ffi.Native<ffi.Bool Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Pointer<ffi.Char>)>(
     symbol: 'set_camera', assetId: 'flutter_filament_plugin')
 external bool set_camera(
@@ -178,7 +240,7 @@ external void set_view_frustum_culling(
         ffi.Pointer<ffi.Void>,
         ffi.Pointer<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Void> buf, ffi.Size size, ffi.Pointer<ffi.Void> data)>>,
         ffi.Pointer<ffi.Void>)>(symbol: 'render', assetId: 'flutter_filament_plugin')
-external void render(
+external bool render(
   ffi.Pointer<ffi.Void> viewer,
   int frameTimeInNanos,
   ffi.Pointer<ffi.Void> pixelBuffer,
@@ -207,6 +269,47 @@ external void set_frame_interval(
   double interval,
 );
 
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Float)>(symbol: 'set_refresh_rate', assetId: 'flutter_filament_plugin')
+external void set_refresh_rate(
+  ffi.Pointer<ffi.Void> viewer,
+  double refreshRate,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Bool, ffi.Float)>(
+    symbol: 'set_on_demand_rendering', assetId: 'flutter_filament_plugin')
+external void set_on_demand_rendering(
+  ffi.Pointer<ffi.Void> viewer,
+  bool enabled,
+  double idleFrameRate,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>)>(symbol: 'request_frame', assetId: 'flutter_filament_plugin')
+external void request_frame(
+  ffi.Pointer<ffi.Void> viewer,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<ffi.Void>)>(symbol: 'get_last_render_reasons', assetId: 'flutter_filament_plugin')
+external int get_last_render_reasons(
+  ffi.Pointer<ffi.Void> viewer,
+);
+
+@ffi.Native<ffi.Bool Function(ffi.Pointer<ffi.Char>, ffi.Int)>(symbol: 'start_tracing', assetId: 'flutter_filament_plugin')
+external bool start_tracing(
+  ffi.Pointer<ffi.Char> outputPath,
+  int maxEvents,
+);
+
+@ffi.Native<ffi.Bool Function()>(symbol: 'stop_tracing', assetId: 'flutter_filament_plugin')
+external bool stop_tracing();
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, ffi.Pointer<FrameTimingRecord>, ffi.Int)>(
+    symbol: 'get_frame_timings', assetId: 'flutter_filament_plugin')
+external int get_frame_timings(
+  ffi.Pointer<ffi.Void> viewer,
+  ffi.Pointer<FrameTimingRecord> out,
+  int maxRecords,
+);
+
 @ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Uint32, ffi.Uint32, ffi.Float)>(
     symbol: 'update_viewport_and_camera_projection', assetId: 'flutter_filament_plugin')
 external void update_viewport_and_camera_projection(
@@ -277,6 +380,32 @@ external void set_morph_target_weights(
   int numWeights,
 );
 
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Uint32, ffi.Pointer<ffi.Float>, ffi.Int)>(
+    symbol: 'set_morph_target_weights_by_id', assetId: 'flutter_filament_plugin')
+external void set_morph_target_weights_by_id(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int entityNameId,
+  ffi.Pointer<ffi.Float> morphData,
+  int numWeights,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Char>)>(
+    symbol: 'get_name_id', assetId: 'flutter_filament_plugin')
+external int get_name_id(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<ffi.Char> name,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Uint32, ffi.Uint32)>(
+    symbol: 'get_morph_target_index', assetId: 'flutter_filament_plugin')
+external int get_morph_target_index(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int entityNameId,
+  int morphTargetNameId,
+);
+
 @ffi.Native<
     ffi.Bool Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Float>, ffi.Pointer<ffi.Int>,
         ffi.Int, ffi.Int, ffi.Float)>(symbol: 'set_morph_animation', assetId: 'flutter_filament_plugin')
@@ -314,6 +443,88 @@ external void set_bone_animation(
   double frameLengthInMs,
 );
 
+@ffi.Native<
+    ffi.Int Function(
+        ffi.Pointer<ffi.Void>,
+        EntityId,
+        ffi.Pointer<ffi.Float>,
+        ffi.Int,
+        ffi.Int,
+        ffi.Pointer<ffi.Pointer<ffi.Char>>,
+        ffi.Float)>(symbol: 'add_bone_animation_clip', assetId: 'flutter_filament_plugin')
+external int add_bone_animation_clip(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  ffi.Pointer<ffi.Float> frameData,
+  int numFrames,
+  int numBones,
+  ffi.Pointer<ffi.Pointer<ffi.Char>> boneNames,
+  double frameLengthInMs,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Int, ffi.Float, ffi.Bool, ffi.Bool)>(
+    symbol: 'add_bone_animation_layer', assetId: 'flutter_filament_plugin')
+external int add_bone_animation_layer(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int clipIndex,
+  double weight,
+  bool additive,
+  bool loop,
+);
+
+@ffi.Native<ffi.Bool Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Int, ffi.Float)>(
+    symbol: 'set_bone_animation_layer_weight', assetId: 'flutter_filament_plugin')
+external bool set_bone_animation_layer_weight(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int layerIndex,
+  double weight,
+);
+
+@ffi.Native<
+    ffi.Bool Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Int, ffi.Pointer<ffi.Pointer<ffi.Char>>,
+        ffi.Pointer<ffi.Float>, ffi.Int)>(symbol: 'set_bone_animation_layer_mask', assetId: 'flutter_filament_plugin')
+external bool set_bone_animation_layer_mask(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int layerIndex,
+  ffi.Pointer<ffi.Pointer<ffi.Char>> boneNames,
+  ffi.Pointer<ffi.Float> weights,
+  int count,
+);
+
+@ffi.Native<ffi.Bool Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Int)>(
+    symbol: 'remove_bone_animation_layer', assetId: 'flutter_filament_plugin')
+external bool remove_bone_animation_layer(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int layerIndex,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId)>(
+    symbol: 'clear_bone_animation_layers', assetId: 'flutter_filament_plugin')
+external void clear_bone_animation_layers(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Float, ffi.Float)>(
+    symbol: 'set_bone_animation_tolerance', assetId: 'flutter_filament_plugin')
+external void set_bone_animation_tolerance(
+  ffi.Pointer<ffi.Void> assetManager,
+  double rotationTolerance,
+  double translationTolerance,
+);
+
+@ffi.Native<ffi.Bool Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Pointer<BoneAnimationStats>)>(
+    symbol: 'get_bone_animation_stats', assetId: 'flutter_filament_plugin')
+external bool get_bone_animation_stats(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  ffi.Pointer<BoneAnimationStats> out,
+);
+
 @ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Int, ffi.Bool, ffi.Bool, ffi.Bool, ffi.Float)>(
     symbol: 'play_animation', assetId: 'flutter_filament_plugin')
 external void play_animation(
@@ -343,6 +554,27 @@ external void stop_animation(
   int index,
 );
 
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Int)>(
+    symbol: 'set_animation_thread_count', assetId: 'flutter_filament_plugin')
+external void set_animation_thread_count(
+  ffi.Pointer<ffi.Void> assetManager,
+  int count,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Float)>(
+    symbol: 'set_animation_bake_rate', assetId: 'flutter_filament_plugin')
+external void set_animation_bake_rate(
+  ffi.Pointer<ffi.Void> assetManager,
+  double samplesPerSecond,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Pointer<AnimationStats>)>(
+    symbol: 'get_animation_stats', assetId: 'flutter_filament_plugin')
+external void get_animation_stats(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<AnimationStats> out,
+);
+
 @ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, EntityId)>(symbol: 'get_animation_count', assetId: 'flutter_filament_plugin')
 external int get_animation_count(
   ffi.Pointer<ffi.Void> assetManager,
@@ -384,6 +616,29 @@ external int get_morph_target_name_count(
   ffi.Pointer<ffi.Char> meshName,
 );
 
+@ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Pointer<ffi.Uint8>, ffi.Int)>(
+    symbol: 'describe_asset', assetId: 'flutter_filament_plugin')
+external int describe_asset(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  ffi.Pointer<ffi.Uint8> out,
+  int capacity,
+);
+
+@ffi.Native<ffi.Pointer<ffi.Uint8> Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Pointer<ffi.Int>)>(
+    symbol: 'describe_asset_alloc', assetId: 'flutter_filament_plugin')
+external ffi.Pointer<ffi.Uint8> describe_asset_alloc(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  ffi.Pointer<ffi.Int> outLength,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Uint8>)>(
+    symbol: 'free_asset_description', assetId: 'flutter_filament_plugin')
+external void free_asset_description(
+  ffi.Pointer<ffi.Uint8> description,
+);
+
 @ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId)>(symbol: 'remove_asset', assetId: 'flutter_filament_plugin')
 external void remove_asset(
   ffi.Pointer<ffi.Void> viewer,
@@ -409,6 +664,20 @@ external bool set_material_color(
   double a,
 );
 
+@ffi.Native<
+    ffi.Bool Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Uint32, ffi.Int, ffi.Float, ffi.Float, ffi.Float,
+        ffi.Float)>(symbol: 'set_material_color_by_id', assetId: 'flutter_filament_plugin')
+external bool set_material_color_by_id(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int meshNameId,
+  int materialIndex,
+  double r,
+  double g,
+  double b,
+  double a,
+);
+
 @ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId)>(
     symbol: 'transform_to_unit_cube', assetId: 'flutter_filament_plugin')
 external void transform_to_unit_cube(
@@ -426,6 +695,27 @@ external void set_position(
   double z,
 );
 
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<ffi.Void>, ffi.Pointer<EntityId>, ffi.Pointer<ffi.Float>, ffi.Pointer<ffi.Float>,
+        ffi.Pointer<ffi.Float>, ffi.Int)>(symbol: 'set_transforms', assetId: 'flutter_filament_plugin')
+external int set_transforms(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<EntityId> assets,
+  ffi.Pointer<ffi.Float> positions,
+  ffi.Pointer<ffi.Float> rotations,
+  ffi.Pointer<ffi.Float> scales,
+  int count,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, ffi.Pointer<EntityId>, ffi.Pointer<ffi.Float>, ffi.Int)>(
+    symbol: 'set_transform_matrices', assetId: 'flutter_filament_plugin')
+external int set_transform_matrices(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<EntityId> assets,
+  ffi.Pointer<ffi.Float> matrices,
+  int count,
+);
+
 @ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Float, ffi.Float, ffi.Float, ffi.Float)>(
     symbol: 'set_rotation', assetId: 'flutter_filament_plugin')
 external void set_rotation(
@@ -563,6 +853,22 @@ external int hide_mesh(
   ffi.Pointer<ffi.Char> meshName,
 );
 
+@ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Uint32)>(
+    symbol: 'hide_mesh_by_id', assetId: 'flutter_filament_plugin')
+external int hide_mesh_by_id(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int meshNameId,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Uint32)>(
+    symbol: 'reveal_mesh_by_id', assetId: 'flutter_filament_plugin')
+external int reveal_mesh_by_id(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int meshNameId,
+);
+
 @ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Pointer<ffi.Char>)>(
     symbol: 'reveal_mesh', assetId: 'flutter_filament_plugin')
 external int reveal_mesh(
@@ -586,6 +892,72 @@ external void pick(
   ffi.Pointer<EntityId> entityId,
 );
 
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, PickResultsCallback)>(
+    symbol: 'set_pick_results_callback', assetId: 'flutter_filament_plugin')
+external void set_pick_results_callback(
+  ffi.Pointer<ffi.Void> viewer,
+  PickResultsCallback callback,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<ffi.Void>, ffi.Int, ffi.Int, ffi.Uint32)>(
+    symbol: 'queue_pick', assetId: 'flutter_filament_plugin')
+external int queue_pick(
+  ffi.Pointer<ffi.Void> viewer,
+  int x,
+  int y,
+  int channel,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Int32>, ffi.Int, ffi.Uint32)>(
+    symbol: 'queue_picks', assetId: 'flutter_filament_plugin')
+external int queue_picks(
+  ffi.Pointer<ffi.Void> viewer,
+  ffi.Pointer<ffi.Int32> points,
+  int count,
+  int channel,
+);
+
+@ffi.Native<
+        ffi.Bool Function(ffi.Pointer<ffi.Void>, ffi.Float, ffi.Float, ffi.Float, ffi.Float, ffi.Float, ffi.Float,
+            ffi.Pointer<RaycastHit>)>(symbol: 'raycast', assetId: 'flutter_filament_plugin')
+external bool raycast(
+  ffi.Pointer<ffi.Void> viewer,
+  double originX,
+  double originY,
+  double originZ,
+  double directionX,
+  double directionY,
+  double directionZ,
+  ffi.Pointer<RaycastHit> out,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Float>, ffi.Int, ffi.Pointer<RaycastHit>)>(
+    symbol: 'raycast_batch', assetId: 'flutter_filament_plugin')
+external int raycast_batch(
+  ffi.Pointer<ffi.Void> viewer,
+  ffi.Pointer<ffi.Float> rays,
+  int count,
+  ffi.Pointer<RaycastHit> out,
+);
+
+@ffi.Native<ffi.Bool Function(ffi.Pointer<ffi.Void>, ffi.Float, ffi.Float, ffi.Pointer<RaycastHit>)>(
+    symbol: 'raycast_screen', assetId: 'flutter_filament_plugin')
+external bool raycast_screen(
+  ffi.Pointer<ffi.Void> viewer,
+  double x,
+  double y,
+  ffi.Pointer<RaycastHit> out,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Float>, ffi.Int, ffi.Pointer<RaycastHit>)>(
+    symbol: 'raycast_screen_batch', assetId: 'flutter_filament_plugin')
+external int raycast_screen_batch(
+  ffi.Pointer<ffi.Void> viewer,
+  ffi.Pointer<ffi.Float> points,
+  int count,
+  ffi.Pointer<RaycastHit> out,
+);
+
 @ffi.Native<ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Void>, EntityId)>(
     symbol: 'get_name_for_entity', assetId: 'flutter_filament_plugin')
 external ffi.Pointer<ffi.Char> get_name_for_entity(
@@ -668,6 +1040,45 @@ external void set_frame_interval_ffi(
   double frameInterval,
 );
 
+@ffi.Native<ffi.Void Function(ffi.Float)>(symbol: 'set_task_budget_ffi', assetId: 'flutter_filament_plugin')
+external void set_task_budget_ffi(
+  double taskBudgetInMilliseconds,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Float)>(symbol: 'set_refresh_rate_ffi', assetId: 'flutter_filament_plugin')
+external void set_refresh_rate_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  double refreshRate,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Bool, ffi.Float)>(
+    symbol: 'set_on_demand_rendering_ffi', assetId: 'flutter_filament_plugin')
+external void set_on_demand_rendering_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  bool enabled,
+  double idleFrameRate,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>)>(symbol: 'request_frame_ffi', assetId: 'flutter_filament_plugin')
+external void request_frame_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, ffi.Pointer<FrameTimingRecord>, ffi.Int)>(
+    symbol: 'get_frame_timings_ffi', assetId: 'flutter_filament_plugin')
+external int get_frame_timings_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  ffi.Pointer<FrameTimingRecord> out,
+  int maxRecords,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<FramePacingStats>, ffi.Bool)>(
+    symbol: 'get_frame_pacing_stats_ffi', assetId: 'flutter_filament_plugin')
+external void get_frame_pacing_stats_ffi(
+  ffi.Pointer<FramePacingStats> out,
+  bool reset,
+);
+
 @ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Uint32, ffi.Uint32, ffi.Float)>(
     symbol: 'update_viewport_and_camera_projection_ffi', assetId: 'flutter_filament_plugin')
 external void update_viewport_and_camera_projection_ffi(
@@ -829,6 +1240,62 @@ external void set_morph_target_weights_ffi(
   int numWeights,
 );
 
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Uint32, ffi.Pointer<ffi.Float>, ffi.Int)>(
+    symbol: 'set_morph_target_weights_by_id_ffi', assetId: 'flutter_filament_plugin')
+external void set_morph_target_weights_by_id_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int entityNameId,
+  ffi.Pointer<ffi.Float> morphData,
+  int numWeights,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Char>)>(
+    symbol: 'get_name_id_ffi', assetId: 'flutter_filament_plugin')
+external int get_name_id_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<ffi.Char> name,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Uint32, ffi.Uint32)>(
+    symbol: 'get_morph_target_index_ffi', assetId: 'flutter_filament_plugin')
+external int get_morph_target_index_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int entityNameId,
+  int morphTargetNameId,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Uint32)>(
+    symbol: 'hide_mesh_by_id_ffi', assetId: 'flutter_filament_plugin')
+external void hide_mesh_by_id_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int meshNameId,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Uint32)>(
+    symbol: 'reveal_mesh_by_id_ffi', assetId: 'flutter_filament_plugin')
+external void reveal_mesh_by_id_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int meshNameId,
+);
+
+@ffi.Native<
+    ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Uint32, ffi.Int, ffi.Float, ffi.Float, ffi.Float,
+        ffi.Float)>(symbol: 'set_material_color_by_id_ffi', assetId: 'flutter_filament_plugin')
+external void set_material_color_by_id_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int meshNameId,
+  int materialIndex,
+  double r,
+  double g,
+  double b,
+  double a,
+);
+
 @ffi.Native<
     ffi.Bool Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Float>, ffi.Pointer<ffi.Int>,
         ffi.Int, ffi.Int, ffi.Float)>(symbol: 'set_morph_animation_ffi', assetId: 'flutter_filament_plugin')
@@ -866,19 +1333,101 @@ external void set_bone_animation_ffi(
   double frameLengthInMs,
 );
 
-@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Int, ffi.Bool, ffi.Bool, ffi.Bool, ffi.Float)>(
-    symbol: 'play_animation_ffi', assetId: 'flutter_filament_plugin')
-external void play_animation_ffi(
+@ffi.Native<
+    ffi.Int Function(
+        ffi.Pointer<ffi.Void>,
+        EntityId,
+        ffi.Pointer<ffi.Float>,
+        ffi.Int,
+        ffi.Int,
+        ffi.Pointer<ffi.Pointer<ffi.Char>>,
+        ffi.Float)>(symbol: 'add_bone_animation_clip_ffi', assetId: 'flutter_filament_plugin')
+external int add_bone_animation_clip_ffi(
   ffi.Pointer<ffi.Void> assetManager,
   int asset,
-  int index,
-  bool loop,
-  bool reverse,
-  bool replaceActive,
-  double crossfade,
-);
-
-@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Int, ffi.Int)>(
+  ffi.Pointer<ffi.Float> frameData,
+  int numFrames,
+  int numBones,
+  ffi.Pointer<ffi.Pointer<ffi.Char>> boneNames,
+  double frameLengthInMs,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Int, ffi.Float, ffi.Bool, ffi.Bool)>(
+    symbol: 'add_bone_animation_layer_ffi', assetId: 'flutter_filament_plugin')
+external int add_bone_animation_layer_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int clipIndex,
+  double weight,
+  bool additive,
+  bool loop,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Int, ffi.Float)>(
+    symbol: 'set_bone_animation_layer_weight_ffi', assetId: 'flutter_filament_plugin')
+external void set_bone_animation_layer_weight_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int layerIndex,
+  double weight,
+);
+
+@ffi.Native<
+    ffi.Bool Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Int, ffi.Pointer<ffi.Pointer<ffi.Char>>,
+        ffi.Pointer<ffi.Float>, ffi.Int)>(symbol: 'set_bone_animation_layer_mask_ffi', assetId: 'flutter_filament_plugin')
+external bool set_bone_animation_layer_mask_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int layerIndex,
+  ffi.Pointer<ffi.Pointer<ffi.Char>> boneNames,
+  ffi.Pointer<ffi.Float> weights,
+  int count,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Int)>(
+    symbol: 'remove_bone_animation_layer_ffi', assetId: 'flutter_filament_plugin')
+external void remove_bone_animation_layer_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int layerIndex,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId)>(
+    symbol: 'clear_bone_animation_layers_ffi', assetId: 'flutter_filament_plugin')
+external void clear_bone_animation_layers_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Float, ffi.Float)>(
+    symbol: 'set_bone_animation_tolerance_ffi', assetId: 'flutter_filament_plugin')
+external void set_bone_animation_tolerance_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  double rotationTolerance,
+  double translationTolerance,
+);
+
+@ffi.Native<ffi.Bool Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Pointer<BoneAnimationStats>)>(
+    symbol: 'get_bone_animation_stats_ffi', assetId: 'flutter_filament_plugin')
+external bool get_bone_animation_stats_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  ffi.Pointer<BoneAnimationStats> out,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Int, ffi.Bool, ffi.Bool, ffi.Bool, ffi.Float)>(
+    symbol: 'play_animation_ffi', assetId: 'flutter_filament_plugin')
+external void play_animation_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  int index,
+  bool loop,
+  bool reverse,
+  bool replaceActive,
+  double crossfade,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Int, ffi.Int)>(
     symbol: 'set_animation_frame_ffi', assetId: 'flutter_filament_plugin')
 external void set_animation_frame_ffi(
   ffi.Pointer<ffi.Void> assetManager,
@@ -895,6 +1444,27 @@ external void stop_animation_ffi(
   int index,
 );
 
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Int)>(
+    symbol: 'set_animation_thread_count_ffi', assetId: 'flutter_filament_plugin')
+external void set_animation_thread_count_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int count,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Float)>(
+    symbol: 'set_animation_bake_rate_ffi', assetId: 'flutter_filament_plugin')
+external void set_animation_bake_rate_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  double samplesPerSecond,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Pointer<AnimationStats>)>(
+    symbol: 'get_animation_stats_ffi', assetId: 'flutter_filament_plugin')
+external void get_animation_stats_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<AnimationStats> out,
+);
+
 @ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, EntityId)>(
     symbol: 'get_animation_count_ffi', assetId: 'flutter_filament_plugin')
 external int get_animation_count_ffi(
@@ -921,6 +1491,23 @@ external void get_morph_target_name_ffi(
   int index,
 );
 
+@ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Pointer<ffi.Uint8>, ffi.Int)>(
+    symbol: 'describe_asset_ffi', assetId: 'flutter_filament_plugin')
+external int describe_asset_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  ffi.Pointer<ffi.Uint8> out,
+  int capacity,
+);
+
+@ffi.Native<ffi.Pointer<ffi.Uint8> Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Pointer<ffi.Int>)>(
+    symbol: 'describe_asset_alloc_ffi', assetId: 'flutter_filament_plugin')
+external ffi.Pointer<ffi.Uint8> describe_asset_alloc_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  ffi.Pointer<ffi.Int> outLength,
+);
+
 @ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Pointer<ffi.Char>)>(
     symbol: 'get_morph_target_name_count_ffi', assetId: 'flutter_filament_plugin')
 external int get_morph_target_name_count_ffi(
@@ -945,9 +1532,332 @@ external void pick_ffi(
   ffi.Pointer<EntityId> entityId,
 );
 
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, PickResultsCallback)>(
+    symbol: 'set_pick_results_callback_ffi', assetId: 'flutter_filament_plugin')
+external void set_pick_results_callback_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  PickResultsCallback callback,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<ffi.Void>, ffi.Int, ffi.Int, ffi.Uint32)>(
+    symbol: 'queue_pick_ffi', assetId: 'flutter_filament_plugin')
+external int queue_pick_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  int x,
+  int y,
+  int channel,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Int32>, ffi.Int, ffi.Uint32)>(
+    symbol: 'queue_picks_ffi', assetId: 'flutter_filament_plugin')
+external int queue_picks_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  ffi.Pointer<ffi.Int32> points,
+  int count,
+  int channel,
+);
+
+@ffi.Native<
+        ffi.Bool Function(ffi.Pointer<ffi.Void>, ffi.Float, ffi.Float, ffi.Float, ffi.Float, ffi.Float, ffi.Float,
+            ffi.Pointer<RaycastHit>)>(symbol: 'raycast_ffi', assetId: 'flutter_filament_plugin')
+external bool raycast_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  double originX,
+  double originY,
+  double originZ,
+  double directionX,
+  double directionY,
+  double directionZ,
+  ffi.Pointer<RaycastHit> out,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Float>, ffi.Int, ffi.Pointer<RaycastHit>)>(
+    symbol: 'raycast_batch_ffi', assetId: 'flutter_filament_plugin')
+external int raycast_batch_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  ffi.Pointer<ffi.Float> rays,
+  int count,
+  ffi.Pointer<RaycastHit> out,
+);
+
+@ffi.Native<ffi.Bool Function(ffi.Pointer<ffi.Void>, ffi.Float, ffi.Float, ffi.Pointer<RaycastHit>)>(
+    symbol: 'raycast_screen_ffi', assetId: 'flutter_filament_plugin')
+external bool raycast_screen_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  double x,
+  double y,
+  ffi.Pointer<RaycastHit> out,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Float>, ffi.Int, ffi.Pointer<RaycastHit>)>(
+    symbol: 'raycast_screen_batch_ffi', assetId: 'flutter_filament_plugin')
+external int raycast_screen_batch_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  ffi.Pointer<ffi.Float> points,
+  int count,
+  ffi.Pointer<RaycastHit> out,
+);
+
+@ffi.Native<ffi.Bool Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Uint8>, ffi.Int32)>(
+    symbol: 'submit_commands_ffi', assetId: 'flutter_filament_plugin')
+external bool submit_commands_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  ffi.Pointer<ffi.Uint8> data,
+  int length,
+);
+
 @ffi.Native<ffi.Void Function()>(symbol: 'ios_dummy_ffi', assetId: 'flutter_filament_plugin')
 external void ios_dummy_ffi();
 
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Uint8, ffi.Float, ffi.Float, ffi.Float, ffi.Float, ffi.Float, ffi.Float, ffi.Float, ffi.Float, ffi.Bool, EntityIdCallback)>(
+    symbol: 'add_light_with_callback_ffi', assetId: 'flutter_filament_plugin')
+external void add_light_with_callback_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  int type,
+  double colour,
+  double intensity,
+  double posX,
+  double posY,
+  double posZ,
+  double dirX,
+  double dirY,
+  double dirZ,
+  bool shadows,
+  EntityIdCallback callback,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Char>, ffi.Bool, EntityIdCallback)>(
+    symbol: 'load_glb_with_callback_ffi', assetId: 'flutter_filament_plugin')
+external void load_glb_with_callback_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<ffi.Char> assetPath,
+  bool unlit,
+  EntityIdCallback callback,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>, EntityIdCallback)>(
+    symbol: 'load_gltf_with_callback_ffi', assetId: 'flutter_filament_plugin')
+external void load_gltf_with_callback_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<ffi.Char> assetPath,
+  ffi.Pointer<ffi.Char> relativePath,
+  EntityIdCallback callback,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Char>, ffi.Int, ffi.Pointer<EntityId>)>(
+    symbol: 'load_glb_instanced_ffi', assetId: 'flutter_filament_plugin')
+external int load_glb_instanced_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<ffi.Char> assetPath,
+  int numInstances,
+  ffi.Pointer<EntityId> out,
+);
+
+@ffi.Native<EntityId Function(ffi.Pointer<ffi.Void>, EntityId)>(
+    symbol: 'create_instance_ffi', assetId: 'flutter_filament_plugin')
+external int create_instance_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int entityId,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Uint64)>(
+    symbol: 'set_asset_cache_budget_ffi', assetId: 'flutter_filament_plugin')
+external void set_asset_cache_budget_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int budgetInBytes,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Pointer<AssetCacheStats>)>(
+    symbol: 'get_asset_cache_stats_ffi', assetId: 'flutter_filament_plugin')
+external void get_asset_cache_stats_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<AssetCacheStats> out,
+);
+
+@ffi.Native<EntityId Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Char>, AssetLoadCallback)>(
+    symbol: 'load_glb_async_ffi', assetId: 'flutter_filament_plugin')
+external int load_glb_async_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<ffi.Char> assetPath,
+  AssetLoadCallback callback,
+);
+
+@ffi.Native<EntityId Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>, AssetLoadCallback)>(
+    symbol: 'load_gltf_async_ffi', assetId: 'flutter_filament_plugin')
+external int load_gltf_async_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<ffi.Char> assetPath,
+  ffi.Pointer<ffi.Char> relativePath,
+  AssetLoadCallback callback,
+);
+
+@ffi.Native<ffi.Bool Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Pointer<AssetLoadProgress>)>(
+    symbol: 'get_load_progress_ffi', assetId: 'flutter_filament_plugin')
+external bool get_load_progress_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  ffi.Pointer<AssetLoadProgress> out,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId)>(
+    symbol: 'cancel_load_ffi', assetId: 'flutter_filament_plugin')
+external void cancel_load_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Int, ffi.Int, PickCallback)>(
+    symbol: 'pick_with_callback_ffi', assetId: 'flutter_filament_plugin')
+external void pick_with_callback_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  int x,
+  int y,
+  PickCallback callback,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Float, ffi.Float, ffi.Float)>(
+    symbol: 'set_camera_position_ffi', assetId: 'flutter_filament_plugin')
+external void set_camera_position_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  double x,
+  double y,
+  double z,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Float, ffi.Float, ffi.Float, ffi.Float)>(
+    symbol: 'set_camera_rotation_ffi', assetId: 'flutter_filament_plugin')
+external void set_camera_rotation_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  double rads,
+  double x,
+  double y,
+  double z,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Float>)>(
+    symbol: 'set_camera_model_matrix_ffi', assetId: 'flutter_filament_plugin')
+external void set_camera_model_matrix_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  ffi.Pointer<ffi.Float> matrix,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Float)>(
+    symbol: 'set_camera_focal_length_ffi', assetId: 'flutter_filament_plugin')
+external void set_camera_focal_length_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  double focalLength,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Float)>(
+    symbol: 'set_camera_focus_distance_ffi', assetId: 'flutter_filament_plugin')
+external void set_camera_focus_distance_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  double focusDistance,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Float, ffi.Float, ffi.Float)>(
+    symbol: 'set_camera_exposure_ffi', assetId: 'flutter_filament_plugin')
+external void set_camera_exposure_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  double aperture,
+  double shutterSpeed,
+  double sensitivity,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Float, ffi.Float, ffi.Bool)>(
+    symbol: 'grab_begin_ffi', assetId: 'flutter_filament_plugin')
+external void grab_begin_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  double x,
+  double y,
+  bool pan,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Float, ffi.Float)>(
+    symbol: 'grab_update_ffi', assetId: 'flutter_filament_plugin')
+external void grab_update_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  double x,
+  double y,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>)>(
+    symbol: 'grab_end_ffi', assetId: 'flutter_filament_plugin')
+external void grab_end_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>)>(
+    symbol: 'scroll_begin_ffi', assetId: 'flutter_filament_plugin')
+external void scroll_begin_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Float, ffi.Float, ffi.Float)>(
+    symbol: 'scroll_update_ffi', assetId: 'flutter_filament_plugin')
+external void scroll_update_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+  double x,
+  double y,
+  double delta,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>)>(
+    symbol: 'scroll_end_ffi', assetId: 'flutter_filament_plugin')
+external void scroll_end_ffi(
+  ffi.Pointer<ffi.Void> viewer,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Float, ffi.Float, ffi.Float)>(
+    symbol: 'set_position_ffi', assetId: 'flutter_filament_plugin')
+external void set_position_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  double x,
+  double y,
+  double z,
+);
+
+@ffi.Native<
+    ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Pointer<EntityId>, ffi.Pointer<ffi.Float>, ffi.Pointer<ffi.Float>,
+        ffi.Pointer<ffi.Float>, ffi.Int)>(symbol: 'set_transforms_ffi', assetId: 'flutter_filament_plugin')
+external void set_transforms_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<EntityId> assets,
+  ffi.Pointer<ffi.Float> positions,
+  ffi.Pointer<ffi.Float> rotations,
+  ffi.Pointer<ffi.Float> scales,
+  int count,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Pointer<EntityId>, ffi.Pointer<ffi.Float>, ffi.Int)>(
+    symbol: 'set_transform_matrices_ffi', assetId: 'flutter_filament_plugin')
+external void set_transform_matrices_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  ffi.Pointer<EntityId> assets,
+  ffi.Pointer<ffi.Float> matrices,
+  int count,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Float, ffi.Float, ffi.Float, ffi.Float)>(
+    symbol: 'set_rotation_ffi', assetId: 'flutter_filament_plugin')
+external void set_rotation_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  double rads,
+  double x,
+  double y,
+  double z,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<ffi.Void>, EntityId, ffi.Float)>(
+    symbol: 'set_scale_ffi', assetId: 'flutter_filament_plugin')
+external void set_scale_ffi(
+  ffi.Pointer<ffi.Void> assetManager,
+  int asset,
+  double scale,
+);
+
 ///------------------------------------------------------------------------------------
 @ffi.Native<ffi.Int Function(ffi.Pointer<ffi.Void>, EntityId)>(
     symbol: 'get_hierarchy_entity_count', assetId: 'flutter_filament_plugin')
@@ -991,6 +1901,184 @@ final class __mbstate_t extends ffi.Union {
   external int _mbstateL;
 }
 
+final class AssetLoadProgress extends ffi.Struct {
+  @ffi.Int32()
+  external int state;
+
+  @ffi.Float()
+  external double progress;
+
+  @ffi.Uint64()
+  external int bytesFetched;
+
+  @ffi.Int32()
+  external int resourceCount;
+
+  @ffi.Int32()
+  external int texturesDecoded;
+
+  @ffi.Int32()
+  external int textureCount;
+}
+
+final class AssetCacheStats extends ffi.Struct {
+  @ffi.Uint64()
+  external int hits;
+
+  @ffi.Uint64()
+  external int misses;
+
+  @ffi.Uint64()
+  external int evictions;
+
+  @ffi.Uint64()
+  external int bytesCached;
+
+  @ffi.Uint64()
+  external int budgetInBytes;
+
+  @ffi.Int32()
+  external int templateCount;
+
+  @ffi.Int32()
+  external int idleTemplateCount;
+}
+
+final class PickResult extends ffi.Struct {
+  @ffi.Uint32()
+  external int requestId;
+
+  @ffi.Uint32()
+  external int channel;
+
+  @ffi.Int32()
+  external int entity;
+
+  @ffi.Float()
+  external double depth;
+
+  @ffi.Array.multi([3])
+  external ffi.Array<ffi.Float> fragCoords;
+
+  @ffi.Int32()
+  external int x;
+
+  @ffi.Int32()
+  external int y;
+}
+
+final class RaycastHit extends ffi.Struct {
+  @ffi.Int32()
+  external int asset;
+
+  @ffi.Int32()
+  external int entity;
+
+  @ffi.Int32()
+  external int primitive;
+
+  @ffi.Int32()
+  external int triangle;
+
+  @ffi.Float()
+  external double u;
+
+  @ffi.Float()
+  external double v;
+
+  @ffi.Float()
+  external double distance;
+
+  @ffi.Array.multi([3])
+  external ffi.Array<ffi.Float> position;
+}
+
+final class AnimationStats extends ffi.Struct {
+  @ffi.Uint64()
+  external int boneMatrixUpdates;
+
+  @ffi.Uint64()
+  external int boneMatrixUpdatesSkipped;
+}
+
+final class BoneAnimationStats extends ffi.Struct {
+  @ffi.Uint64()
+  external int uncompressedBytes;
+
+  @ffi.Uint64()
+  external int compressedBytes;
+
+  @ffi.Float()
+  external double maxRotationError;
+
+  @ffi.Float()
+  external double maxTranslationError;
+
+  @ffi.Int32()
+  external int clipCount;
+}
+
+final class FrameTimingRecord extends ffi.Struct {
+  @ffi.Uint64()
+  external int frameNumber;
+
+  @ffi.Uint64()
+  external int startTimeInNanos;
+
+  @ffi.Uint64()
+  external int vsyncTimeInNanos;
+
+  @ffi.Float()
+  external double taskDrainInMilliseconds;
+
+  @ffi.Float()
+  external double updateAnimationsInMilliseconds;
+
+  @ffi.Float()
+  external double manipulatorInMilliseconds;
+
+  @ffi.Float()
+  external double beginFrameInMilliseconds;
+
+  @ffi.Float()
+  external double renderInMilliseconds;
+
+  @ffi.Float()
+  external double endFrameInMilliseconds;
+
+  @ffi.Float()
+  external double totalInMilliseconds;
+
+  @ffi.Uint32()
+  external int renderReasons;
+
+  @ffi.Uint32()
+  external int skipped;
+}
+
+final class FramePacingStats extends ffi.Struct {
+  @ffi.Uint64()
+  external int frameCount;
+
+  @ffi.Uint64()
+  external int missedDeadlines;
+
+  @ffi.Uint64()
+  external int skippedVsyncs;
+
+  @ffi.Float()
+  external double lastFrameCostInMilliseconds;
+
+  @ffi.Float()
+  external double predictedFrameCostInMilliseconds;
+
+  @ffi.Float()
+  external double averageJitterInMilliseconds;
+
+  @ffi.Float()
+  external double maxJitterInMilliseconds;
+}
+
 final class __darwin_pthread_handler_rec extends ffi.Struct {
   external ffi.Pointer<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Void>)>> __routine;
 
@@ -1106,6 +2194,64 @@ typedef FreeFilamentResourceFromOwner = ffi.Pointer<ffi.NativeFunction<ffi.Void
 typedef EntityId = ffi.Int32;
 typedef _ManipulatorMode = ffi.Int32;
 typedef FilamentRenderCallback = ffi.Pointer<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Void> owner)>>;
+typedef EntityIdCallback = ffi.Pointer<ffi.NativeFunction<ffi.Void Function(EntityId entityId)>>;
+typedef PickCallback = ffi.Pointer<ffi.NativeFunction<ffi.Void Function(EntityId entityId, ffi.Int x, ffi.Int y)>>;
+typedef PickResultsCallback
+    = ffi.Pointer<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<PickResult> results, ffi.Int32 count)>>;
+typedef AssetLoadCallback = ffi.Pointer<ffi.NativeFunction<ffi.Void Function(EntityId entityId, ffi.Bool success)>>;
+
+abstract class AssetLoadState {
+  static const int ASSET_LOAD_FETCHING = 0;
+  static const int ASSET_LOAD_PARSING = 1;
+  static const int ASSET_LOAD_FETCHING_RESOURCES = 2;
+  static const int ASSET_LOAD_UPLOADING = 3;
+  static const int ASSET_LOAD_READY = 4;
+  static const int ASSET_LOAD_FAILED = 5;
+  static const int ASSET_LOAD_CANCELLED = 6;
+}
+
+abstract class RenderReason {
+  static const int RENDER_REASON_NONE = 0;
+  static const int RENDER_REASON_ANIMATION = 1;
+  static const int RENDER_REASON_MANIPULATOR = 2;
+  static const int RENDER_REASON_TRANSFORM = 4;
+  static const int RENDER_REASON_MATERIAL = 8;
+  static const int RENDER_REASON_LIGHT = 16;
+  static const int RENDER_REASON_CAMERA = 32;
+  static const int RENDER_REASON_SCENE = 64;
+  static const int RENDER_REASON_VIEW = 128;
+  static const int RENDER_REASON_IDLE = 256;
+  static const int RENDER_REASON_CONTINUOUS = 512;
+  static const int RENDER_REASON_REQUESTED = 1024;
+}
+
+abstract class CommandOpcode {
+  static const int COMMAND_SET_POSITION = 1;
+  static const int COMMAND_SET_ROTATION = 2;
+  static const int COMMAND_SET_SCALE = 3;
+  static const int COMMAND_SET_TRANSFORM = 4;
+  static const int COMMAND_SET_MORPH_WEIGHTS = 5;
+  static const int COMMAND_PLAY_ANIMATION = 6;
+  static const int COMMAND_STOP_ANIMATION = 7;
+  static const int COMMAND_SET_ANIMATION_FRAME = 8;
+  static const int COMMAND_SET_CAMERA_MODEL_MATRIX = 9;
+}
+
+const int COMMAND_BUFFER_MAGIC = 1111705158;
+
+const int COMMAND_BUFFER_VERSION = 1;
+
+abstract class AssetNodeFlags {
+  static const int ASSET_NODE_RENDERABLE = 1;
+  static const int ASSET_NODE_LIGHT = 2;
+  static const int ASSET_NODE_CAMERA = 4;
+}
+
+const int ASSET_DESCRIPTION_MAGIC = 1145128518;
+
+const int ASSET_DESCRIPTION_VERSION = 1;
+
+const int FRAME_TIMING_HISTORY_SIZE = 256;
 
 const int __bool_true_false_are_defined = 1;
 
@@ -51,8 +51,8 @@ G_DEFINE_TYPE(FlutterFilamentPlugin, flutter_filament_plugin, g_object_get_type(
 static gboolean on_frame_tick(GtkWidget* widget, GdkFrameClock* frame_clock, gpointer self) {
   FlutterFilamentPlugin* plugin = (FlutterFilamentPlugin*)self;
   
- if(plugin->rendering) {
-    render(plugin->viewer, 0);
+ // with on-demand rendering enabled, render() returns false when nothing has changed, so there's no new frame to mark as available
+ if(plugin->rendering && render(plugin->viewer, 0, nullptr, nullptr, nullptr)) {
     fl_texture_registrar_mark_texture_frame_available(plugin->texture_registrar,
                                                         plugin->texture);
   }
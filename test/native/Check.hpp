@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+//
+// Minimal assertions for the native tests (unlike assert, these aren't compiled out of release builds).
+// A failed check prints its location and exits with a non-zero status, failing the test.
+//
+#define CHECK(condition)                                                                        \
+    do {                                                                                        \
+        if(!(condition)) {                                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);  \
+            std::exit(1);                                                                       \
+        }                                                                                       \
+    } while(0)
+
+#define CHECK_NEAR(a, b, tolerance)                                                             \
+    do {                                                                                        \
+        double _a = (a), _b = (b);                                                              \
+        if(!(std::fabs(_a - _b) <= (tolerance))) {                                              \
+            std::fprintf(stderr, "%s:%d: CHECK_NEAR(%s, %s) failed: %g vs %g (tolerance %g)\n", \
+                         __FILE__, __LINE__, #a, #b, _a, _b, (double)(tolerance));              \
+            std::exit(1);                                                                       \
+        }                                                                                       \
+    } while(0)
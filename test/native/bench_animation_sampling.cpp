@@ -0,0 +1,109 @@
+//
+// Animation sampling across characters: the per-frame cost of sampling a 60-bone compressed clip and composing each bone's
+// transform for 50-500 characters, on the calling thread alone and spread with parallelFor across animation pools of
+// increasing size (using the same grain as AssetManager::updateAnimations).
+//
+#include "CompressedBoneClip.hpp"
+#include "ParallelFor.hpp"
+#include "ThreadPool.hpp"
+
+#include <math/mat4.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace polyvox;
+using namespace filament::math;
+
+// as in AssetManager.cpp
+static constexpr size_t kAnimationGrain = 4;
+
+static constexpr int kBones = 60;
+static constexpr int kFrames = 120;
+static constexpr float kFrameLengthInMs = 1000.0f / 30.0f;
+static constexpr int kIterations = 50;
+
+struct Character {
+    float offsetInSeconds = 0;
+    std::vector<float3> translations;
+    std::vector<quatf> rotations;
+    std::vector<mat4f> transforms;
+};
+
+static void sampleCharacter(const CompressedBoneClip& clip, Character& character, float now) {
+    float elapsed = std::fmod(now + character.offsetInSeconds, kFrames * kFrameLengthInMs / 1000.0f);
+    float frame = elapsed * 1000.0f / kFrameLengthInMs;
+    int from = (int)frame % kFrames;
+    int to = (from + 1) % kFrames;
+    clip.sample(from, to, frame - std::floor(frame), character.translations.data(), character.rotations.data());
+    for(int bone = 0; bone < kBones; bone++) {
+        character.transforms[bone] = mat4f::translation(character.translations[bone]) * mat4f(character.rotations[bone]);
+    }
+}
+
+int main() {
+    std::vector<float> frameData(kFrames * kBones * 7);
+    for(int frame = 0; frame < kFrames; frame++) {
+        for(int bone = 0; bone < kBones; bone++) {
+            float* out = &frameData[(frame * kBones + bone) * 7];
+            float angle = std::sin(frame * 0.1f + bone) * 0.5f;
+            auto rotation = quatf::fromAxisAngle(normalize(float3(1.0f, bone * 0.1f, 0.5f)), angle);
+            out[0] = std::sin(frame * 0.05f) * 0.1f;
+            out[1] = 0.0f;
+            out[2] = 0.0f;
+            out[3] = rotation.w;
+            out[4] = rotation.x;
+            out[5] = rotation.y;
+            out[6] = rotation.z;
+        }
+    }
+    CompressedBoneClip clip;
+    clip.compress(frameData.data(), kFrames, kBones, 0.0f, 0.0f);
+
+    std::printf("%d bones, %u hardware threads; ms per frame\n", kBones, std::thread::hardware_concurrency());
+    const int workerCounts[] = { 0, 1, 3, 7 };
+    std::printf("%-12s", "characters");
+    for(int workers : workerCounts) {
+        std::printf(" %9d wk", workers);
+    }
+    std::printf("\n");
+
+    std::vector<std::unique_ptr<flutter_filament::ThreadPool>> pools;
+    for(int workers : workerCounts) {
+        pools.push_back(workers > 0 ? std::make_unique<flutter_filament::ThreadPool>(workers) : nullptr);
+    }
+
+    for(size_t count : { 50, 100, 250, 500 }) {
+        std::vector<Character> characters(count);
+        for(size_t i = 0; i < count; i++) {
+            characters[i].offsetInSeconds = i * 0.37f;
+            characters[i].translations.resize(kBones);
+            characters[i].rotations.resize(kBones);
+            characters[i].transforms.resize(kBones);
+        }
+        std::printf("%-12zu", count);
+        for(size_t p = 0; p < pools.size(); p++) {
+            auto start = std::chrono::steady_clock::now();
+            for(int iteration = 0; iteration < kIterations; iteration++) {
+                float now = iteration / 60.0f;
+                if(!pools[p]) {
+                    for(auto& character : characters) {
+                        sampleCharacter(clip, character, now);
+                    }
+                } else {
+                    parallelFor(pools[p].get(), workerCounts[p], count, kAnimationGrain, [&](size_t i) {
+                        sampleCharacter(clip, characters[i], now);
+                    });
+                }
+            }
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / kIterations;
+            std::printf(" %12.3f", ms);
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
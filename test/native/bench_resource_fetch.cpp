@@ -0,0 +1,104 @@
+//
+// glTF external resource fetching: time to fetch every resource of an asset one after another on the calling thread against
+// queueing the fetches on a loader pool (as AssetManager::fetchResources does) of one worker and of four, for a range of
+// resource counts. Since ResourceLoaderWrapper serializes every load, extra loader threads only wait on its lock.
+// Each fetch goes through a real ResourceLoaderWrapper (so takes the same lock as the platform loaders) and reads a real file,
+// optionally after a fixed delay standing in for the per-request latency of a slow loader (e.g. Android's AAssetManager
+// reading from a compressed APK, or a network-backed loader).
+//
+#include "ResourceBuffer.hpp"
+#include "ThreadPool.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr size_t kFileSize = 256 * 1024;
+
+static std::chrono::microseconds _latency;
+
+static ResourceBuffer loadFile(const char* path) {
+    if(_latency.count() > 0) {
+        std::this_thread::sleep_for(_latency);
+    }
+    FILE* file = std::fopen(path, "rb");
+    if(!file) {
+        return ResourceBuffer(nullptr, 0, -1);
+    }
+    char* data = new char[kFileSize];
+    auto size = std::fread(data, 1, kFileSize, file);
+    std::fclose(file);
+    return ResourceBuffer(data, (int32_t)size, 0);
+}
+
+static void freeFile(ResourceBuffer rb) {
+    delete[] (const char*)rb.data;
+}
+
+static double serial(const ResourceLoaderWrapper& wrapper, const std::vector<std::string>& paths) {
+    auto start = std::chrono::steady_clock::now();
+    size_t bytes = 0;
+    for(const auto& path : paths) {
+        auto rb = wrapper.load(path.c_str());
+        bytes += rb.size;
+        wrapper.free(rb);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return bytes == paths.size() * kFileSize ? std::chrono::duration<double, std::milli>(end - start).count() : -1.0;
+}
+
+static double parallel(flutter_filament::ThreadPool& pool, const ResourceLoaderWrapper& wrapper, const std::vector<std::string>& paths) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<ResourceBuffer>> fetches;
+    for(const auto& path : paths) {
+        std::packaged_task<ResourceBuffer()> task([&wrapper, path] { return wrapper.load(path.c_str()); });
+        fetches.push_back(pool.add_task(task));
+    }
+    size_t bytes = 0;
+    for(auto& f : fetches) {
+        auto rb = f.get();
+        bytes += rb.size;
+        wrapper.free(rb);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return bytes == paths.size() * kFileSize ? std::chrono::duration<double, std::milli>(end - start).count() : -1.0;
+}
+
+int main() {
+    constexpr int kMaxFiles = 64;
+    std::vector<std::string> allPaths;
+    std::vector<char> contents(kFileSize, 'x');
+    for(int i = 0; i < kMaxFiles; i++) {
+        auto path = std::string("bench_resource_fetch_") + std::to_string(i) + ".bin";
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if(!file) {
+            std::fprintf(stderr, "Couldn't write %s\n", path.c_str());
+            return 1;
+        }
+        std::fwrite(contents.data(), 1, contents.size(), file);
+        std::fclose(file);
+        allPaths.push_back(path);
+    }
+
+    ResourceLoaderWrapper wrapper(loadFile, freeFile);
+    flutter_filament::ThreadPool single(1);
+    flutter_filament::ThreadPool pool(4);
+    std::printf("%zu KB per file, %u hardware threads\n", kFileSize / 1024, std::thread::hardware_concurrency());
+    std::printf("%-8s %-12s %12s %14s %14s\n", "files", "latency", "serial (ms)", "1 thread (ms)", "4 threads (ms)");
+    for(auto latency : { std::chrono::microseconds(0), std::chrono::microseconds(2000) }) {
+        _latency = latency;
+        for(int files : { 1, 4, 16, 64 }) {
+            std::vector<std::string> paths(allPaths.begin(), allPaths.begin() + files);
+            std::printf("%-8d %-12s %12.2f %14.2f %14.2f\n", files, latency.count() ? "2 ms" : "none", serial(wrapper, paths),
+                        parallel(single, wrapper, paths), parallel(pool, wrapper, paths));
+        }
+    }
+
+    for(const auto& path : allPaths) {
+        std::remove(path.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+//
+// Scene asset churn at 10k assets: removing a random asset and adding a new one, with the SlotMap AssetManager stores assets
+// in now against the vector it replaced (erase, then decrement every lookup index after the hole), plus the cost of
+// iterating every asset (as updateAnimations does each frame) and looking each one up by EntityId.
+//
+#include "SlotMap.hpp"
+
+#include <tsl/robin_map.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace polyvox;
+
+static constexpr int kAssets = 10000;
+static constexpr int kChurn = 2000;
+
+// roughly the size and shape of a SceneAsset
+struct Asset {
+    int32_t id = 0;
+    std::vector<float> weights;
+    std::array<void*, 96> fields {};
+};
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct VectorAssets {
+    std::vector<Asset> assets;
+    tsl::robin_map<int32_t, size_t> lookup;
+
+    void add(int32_t id) {
+        Asset asset;
+        asset.id = id;
+        lookup.emplace(id, assets.size());
+        assets.push_back(std::move(asset));
+    }
+    void remove(int32_t id) {
+        auto pos = lookup.find(id);
+        size_t index = pos->second;
+        assets.erase(assets.begin() + index);
+        lookup.erase(pos);
+        for(auto it = lookup.begin(); it != lookup.end(); it++) {
+            if(it->second > index) {
+                it.value()--;
+            }
+        }
+    }
+    Asset* find(int32_t id) {
+        auto pos = lookup.find(id);
+        return pos == lookup.end() ? nullptr : &assets[pos->second];
+    }
+};
+
+struct SlotMapAssets {
+    SlotMap<Asset> assets;
+    tsl::robin_map<int32_t, SlotHandle> lookup;
+
+    void add(int32_t id) {
+        Asset asset;
+        asset.id = id;
+        lookup.emplace(id, assets.insert(std::move(asset)));
+    }
+    void remove(int32_t id) {
+        auto pos = lookup.find(id);
+        assets.remove(pos->second);
+        lookup.erase(pos);
+    }
+    Asset* find(int32_t id) {
+        auto pos = lookup.find(id);
+        return pos == lookup.end() ? nullptr : assets.get(pos->second);
+    }
+};
+
+template <class Assets>
+static void run(const char* name) {
+    Assets assets;
+    std::vector<int32_t> ids;
+    for(int32_t id = 1; id <= kAssets; id++) {
+        assets.add(id);
+        ids.push_back(id);
+    }
+    std::mt19937 rng(1);
+    int32_t nextId = kAssets + 1;
+
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < kChurn; i++) {
+        size_t victim = rng() % ids.size();
+        assets.remove(ids[victim]);
+        ids[victim] = nextId;
+        assets.add(nextId++);
+    }
+    double churn = millisecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    long sum = 0;
+    for(int i = 0; i < 100; i++) {
+        for(const auto& asset : assets.assets) {
+            sum += asset.id;
+        }
+    }
+    double iterate = millisecondsSince(start) / 100;
+
+    start = std::chrono::steady_clock::now();
+    for(auto id : ids) {
+        sum += assets.find(id)->id;
+    }
+    double lookup = millisecondsSince(start);
+
+    std::printf("%-10s %14.2f %14.3f %14.3f   (%ld)\n", name, churn * 1000.0 / kChurn, iterate, lookup, sum % 10);
+}
+
+int main() {
+    std::printf("%d assets, %d remove+add pairs\n", kAssets, kChurn);
+    std::printf("%-10s %14s %14s %14s\n", "", "churn (us/op)", "iterate (ms)", "lookup (ms)");
+    run<VectorAssets>("vector");
+    run<SlotMapAssets>("SlotMap");
+    return 0;
+}
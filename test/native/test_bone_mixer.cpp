@@ -0,0 +1,156 @@
+#include "BoneMixer.hpp"
+
+#include "Check.hpp"
+
+#include <cmath>
+
+using namespace polyvox;
+using namespace filament::math;
+
+static const float kPi = 3.14159265f;
+
+static quatf rotationZ(float angle) {
+    return quatf::fromAxisAngle(float3(0.0f, 0.0f, 1.0f), angle);
+}
+
+// the angle of [q] about z (assuming it has no other rotation)
+static float angleZ(const quatf& q) {
+    return 2.0f * std::atan2(q.z * (q.w < 0.0f ? -1.0f : 1.0f), std::fabs(q.w));
+}
+
+// a mixer over [numJoints] joints at rest, with one clip per entry in [clipJoints]
+static BoneMixer makeMixer(size_t numJoints, const vector<vector<uint32_t>>& clipJoints) {
+    BoneMixer mixer;
+    mixer.mJoints.resize(numJoints);
+    for(const auto& joints : clipJoints) {
+        BoneClip clip;
+        clip.mJoints = joints;
+        mixer.mClips.push_back(clip);
+    }
+    mixer.mTranslations.assign(numJoints, float3(0.0f));
+    mixer.mRotations.assign(numJoints, quatf(1.0f));
+    return mixer;
+}
+
+static BoneLayer makeLayer(int clip, float weight, bool additive = false) {
+    BoneLayer layer;
+    layer.mClip = clip;
+    layer.mWeight = weight;
+    layer.mAdditive = additive;
+    return layer;
+}
+
+// a normal layer blends from the pose so far towards the clip's pose by its weight, clamped to 1
+static void testNormalWeights() {
+    auto mixer = makeMixer(2, { { 0, 1 } });
+    mixer.mLayers.push_back(makeLayer(0, 0.25f));
+    vector<float3> translations { float3(4.0f, 0.0f, 0.0f), float3(0.0f, 8.0f, 0.0f) };
+    vector<quatf> rotations { rotationZ(kPi / 2.0f), rotationZ(-kPi / 2.0f) };
+
+    mixer.blendLayers({ 0 }, translations, rotations);
+    CHECK_NEAR(mixer.mTranslations[0].x, 1.0f, 1e-5);
+    CHECK_NEAR(mixer.mTranslations[1].y, 2.0f, 1e-5);
+    // nlerp rather than slerp, so only roughly a quarter of the way
+    CHECK_NEAR(angleZ(mixer.mRotations[0]), kPi / 8.0f, 0.05);
+    CHECK_NEAR(angleZ(mixer.mRotations[1]), -kPi / 8.0f, 0.05);
+    CHECK_NEAR(length(mixer.mRotations[0]), 1.0f, 1e-5);
+
+    // weights above 1 don't overshoot the clip's pose
+    mixer.mTranslations.assign(2, float3(0.0f));
+    mixer.mRotations.assign(2, quatf(1.0f));
+    mixer.mLayers[0].mWeight = 3.0f;
+    mixer.blendLayers({ 0 }, translations, rotations);
+    CHECK_NEAR(mixer.mTranslations[0].x, 4.0f, 1e-5);
+    CHECK_NEAR(angleZ(mixer.mRotations[0]), kPi / 2.0f, 1e-4);
+}
+
+// an additive layer adds its pose, scaled by its weight (which may exceed 1), on top of the pose so far
+static void testAdditive() {
+    auto mixer = makeMixer(1, { { 0 }, { 0 } });
+    mixer.mLayers.push_back(makeLayer(0, 1.0f));
+    mixer.mLayers.push_back(makeLayer(1, 0.5f, true));
+    vector<float3> translations { float3(1.0f, 0.0f, 0.0f), float3(0.0f, 2.0f, 0.0f) };
+    vector<quatf> rotations { rotationZ(kPi / 4.0f), rotationZ(kPi / 2.0f) };
+
+    mixer.blendLayers({ 0, 1 }, translations, rotations);
+    CHECK_NEAR(mixer.mTranslations[0].x, 1.0f, 1e-5);
+    CHECK_NEAR(mixer.mTranslations[0].y, 1.0f, 1e-5);
+    // pi/4 from the first layer, then roughly half of pi/2 on top
+    CHECK_NEAR(angleZ(mixer.mRotations[0]), kPi / 2.0f, 0.05);
+
+    mixer.mTranslations.assign(1, float3(0.0f));
+    mixer.mRotations.assign(1, quatf(1.0f));
+    mixer.mLayers[1].mWeight = 2.0f;
+    mixer.blendLayers({ 0, 1 }, translations, rotations);
+    CHECK_NEAR(mixer.mTranslations[0].y, 4.0f, 1e-5);
+}
+
+// layers apply in index order: a full-weight normal layer replaces whatever came before it, but not what comes after
+static void testLayerOrder() {
+    auto mixer = makeMixer(1, { { 0 }, { 0 } });
+    mixer.mLayers.push_back(makeLayer(0, 1.0f, true));
+    mixer.mLayers.push_back(makeLayer(1, 1.0f));
+    vector<float3> translations { float3(5.0f, 0.0f, 0.0f), float3(2.0f, 0.0f, 0.0f) };
+    vector<quatf> rotations { quatf(1.0f), quatf(1.0f) };
+    mixer.blendLayers({ 0, 1 }, translations, rotations);
+    CHECK_NEAR(mixer.mTranslations[0].x, 2.0f, 1e-5);
+
+    std::swap(mixer.mLayers[0], mixer.mLayers[1]);
+    mixer.mTranslations.assign(1, float3(0.0f));
+    // offsets follow the layers, so the normal layer's pose (now layer 0) is at offset 1
+    mixer.blendLayers({ 1, 0 }, translations, rotations);
+    CHECK_NEAR(mixer.mTranslations[0].x, 7.0f, 1e-5);
+}
+
+// a mask scales the weight per joint; joints with no weight keep the pose so far
+static void testMask() {
+    auto mixer = makeMixer(3, { { 0, 1, 2 } });
+    auto layer = makeLayer(0, 0.5f);
+    layer.mMask = { 1.0f, 0.5f, 0.0f };
+    mixer.mLayers.push_back(layer);
+    mixer.mTranslations[2] = float3(9.0f);
+    vector<float3> translations(3, float3(4.0f, 0.0f, 0.0f));
+    vector<quatf> rotations(3, rotationZ(1.0f));
+    mixer.blendLayers({ 0 }, translations, rotations);
+    CHECK_NEAR(mixer.mTranslations[0].x, 2.0f, 1e-5);
+    CHECK_NEAR(mixer.mTranslations[1].x, 1.0f, 1e-5);
+    CHECK(mixer.mTranslations[2] == float3(9.0f));
+    CHECK(mixer.mRotations[2] == quatf(1.0f));
+}
+
+// a clip only drives its own joints, and its sampled pose is read from its layer's offset
+static void testClipJointsAndOffsets() {
+    auto mixer = makeMixer(4, { { 3, 1 } });
+    mixer.mLayers.push_back(makeLayer(0, 1.0f));
+    vector<float3> translations { float3(-1.0f), float3(-1.0f), float3(3.0f, 0.0f, 0.0f), float3(1.0f, 0.0f, 0.0f) };
+    vector<quatf> rotations(4, quatf(1.0f));
+    mixer.blendLayers({ 2 }, translations, rotations);
+    CHECK(mixer.mTranslations[0] == float3(0.0f));
+    CHECK_NEAR(mixer.mTranslations[1].x, 1.0f, 1e-5);
+    CHECK(mixer.mTranslations[2] == float3(0.0f));
+    CHECK_NEAR(mixer.mTranslations[3].x, 3.0f, 1e-5);
+}
+
+// layers that weren't sampled (UINT32_MAX, or no offset at all) are skipped, as is a layer with no weight
+static void testSkipped() {
+    auto mixer = makeMixer(1, { { 0 }, { 0 }, { 0 } });
+    mixer.mLayers.push_back(makeLayer(0, 1.0f, true));
+    mixer.mLayers.push_back(makeLayer(1, 0.0f));
+    mixer.mLayers.push_back(makeLayer(2, 1.0f, true));
+    vector<float3> translations { float3(1.0f, 0.0f, 0.0f), float3(100.0f, 0.0f, 0.0f) };
+    vector<quatf> rotations(2, quatf(1.0f));
+    mixer.blendLayers({ UINT32_MAX, 1 }, translations, rotations);
+    CHECK(mixer.mTranslations[0] == float3(0.0f));
+    mixer.blendLayers({ 0, 1 }, translations, rotations);
+    CHECK_NEAR(mixer.mTranslations[0].x, 1.0f, 1e-5);
+}
+
+int main() {
+    testNormalWeights();
+    testAdditive();
+    testLayerOrder();
+    testMask();
+    testClipJointsAndOffsets();
+    testSkipped();
+    return 0;
+}
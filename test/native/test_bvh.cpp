@@ -0,0 +1,254 @@
+#include "Bvh.hpp"
+
+#include "Check.hpp"
+
+#include <math/vec4.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <random>
+#include <vector>
+
+using namespace polyvox;
+using namespace filament::math;
+
+// closest hit of [ray] against every triangle in [positions] (three vertices each), or FLT_MAX
+static float bruteForce(const std::vector<float3>& positions, const float3& origin, const float3& direction, uint32_t* triangle = nullptr) {
+    float best = FLT_MAX;
+    for(size_t t = 0; t < positions.size() / 3; t++) {
+        float3 v0 = positions[t * 3];
+        float3 e1 = positions[t * 3 + 1] - v0;
+        float3 e2 = positions[t * 3 + 2] - v0;
+        float3 p = cross(direction, e2);
+        float det = dot(e1, p);
+        if(std::fabs(det) < 1e-12f) {
+            continue;
+        }
+        float inverseDet = 1.0f / det;
+        float3 s = origin - v0;
+        float u = dot(s, p) * inverseDet;
+        if(u < 0.0f || u > 1.0f) {
+            continue;
+        }
+        float3 q = cross(s, e1);
+        float v = dot(direction, q) * inverseDet;
+        if(v < 0.0f || u + v > 1.0f) {
+            continue;
+        }
+        float distance = dot(e2, q) * inverseDet;
+        if(distance > 0.0f && distance < best) {
+            best = distance;
+            if(triangle) {
+                *triangle = (uint32_t)t;
+            }
+        }
+    }
+    return best;
+}
+
+// [count] small random triangles scattered through a cube of half-size [extent]
+static std::vector<float3> randomTriangles(std::mt19937& rng, size_t count, float extent) {
+    std::uniform_real_distribution<float> position(-extent, extent);
+    std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+    std::vector<float3> positions;
+    for(size_t i = 0; i < count; i++) {
+        float3 center(position(rng), position(rng), position(rng));
+        for(int k = 0; k < 3; k++) {
+            positions.push_back(center + float3(offset(rng), offset(rng), offset(rng)));
+        }
+    }
+    return positions;
+}
+
+static MeshBvh buildMesh(const std::vector<float3>& positions) {
+    std::vector<uint32_t> primitives, triangles;
+    for(size_t t = 0; t < positions.size() / 3; t++) {
+        primitives.push_back((uint32_t)(t % 3));
+        triangles.push_back((uint32_t)t);
+    }
+    MeshBvh mesh;
+    mesh.build(positions, primitives, triangles);
+    return mesh;
+}
+
+// every primitive is referenced by exactly one leaf, every node's bounds contain everything below it, and children follow their parent
+static void testBuildInvariants() {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.0f, 5.0f);
+    const size_t count = 5000;
+    std::vector<float3> mins(count), maxs(count);
+    for(size_t i = 0; i < count; i++) {
+        mins[i] = float3(position(rng), position(rng), position(rng));
+        maxs[i] = mins[i] + float3(size(rng), size(rng), size(rng));
+    }
+    std::vector<BvhNode> nodes;
+    std::vector<uint32_t> order;
+    buildBvh(mins.data(), maxs.data(), count, 4, nodes, order);
+
+    CHECK(order.size() == count);
+    std::vector<uint32_t> sorted(order);
+    std::sort(sorted.begin(), sorted.end());
+    for(size_t i = 0; i < count; i++) {
+        CHECK(sorted[i] == i);
+    }
+
+    auto contains = [](const BvhNode& node, const float3& min, const float3& max) {
+        return all(lessThanEqual(node.min, min)) && all(greaterThanEqual(node.max, max));
+    };
+    std::vector<int> referenced(count, 0);
+    for(size_t i = 0; i < nodes.size(); i++) {
+        const auto& node = nodes[i];
+        if(node.count > 0) {
+            for(uint32_t j = node.first; j < node.first + node.count; j++) {
+                referenced[j]++;
+                CHECK(contains(node, mins[order[j]], maxs[order[j]]));
+            }
+        } else {
+            CHECK(node.first > i && node.first + 1 < nodes.size());
+            CHECK(contains(node, nodes[node.first].min, nodes[node.first].max));
+            CHECK(contains(node, nodes[node.first + 1].min, nodes[node.first + 1].max));
+        }
+    }
+    for(size_t i = 0; i < count; i++) {
+        CHECK(referenced[i] == 1);
+    }
+}
+
+// the closest hit matches a brute force test of every triangle, for rays that hit and rays that miss
+static void testMeshRaycast() {
+    std::mt19937 rng(5);
+    auto positions = randomTriangles(rng, 3000, 20.0f);
+    auto mesh = buildMesh(positions);
+    CHECK(mesh.getTriangleCount() == 3000);
+
+    std::uniform_real_distribution<float> coordinate(-25.0f, 25.0f);
+    int hits = 0;
+    for(int i = 0; i < 500; i++) {
+        float3 origin(coordinate(rng), coordinate(rng), coordinate(rng));
+        float3 target(coordinate(rng) * 0.5f, coordinate(rng) * 0.5f, coordinate(rng) * 0.5f);
+        float3 direction = normalize(target - origin);
+        uint32_t expectedTriangle = 0;
+        float expected = bruteForce(positions, origin, direction, &expectedTriangle);
+
+        MeshBvh::Hit hit {};
+        hit.distance = FLT_MAX;
+        bool found = mesh.intersect(Ray(origin, direction), hit);
+        CHECK(found == (expected < FLT_MAX));
+        if(found) {
+            hits++;
+            CHECK_NEAR(hit.distance, expected, 1e-3);
+            CHECK(hit.triangle == expectedTriangle);
+            CHECK(hit.primitive == expectedTriangle % 3);
+            CHECK(hit.u >= 0.0f && hit.v >= 0.0f && hit.u + hit.v <= 1.0f);
+        }
+    }
+    // make sure the rays actually exercised both paths
+    CHECK(hits > 50 && hits < 500);
+
+    // a hit beyond the distance already found is ignored
+    float3 origin(0.0f, 0.0f, -50.0f);
+    float3 direction(0.0f, 0.0f, 1.0f);
+    float expected = bruteForce(positions, origin, direction);
+    if(expected < FLT_MAX) {
+        MeshBvh::Hit hit {};
+        hit.distance = expected * 0.5f;
+        CHECK(!mesh.intersect(Ray(origin, direction), hit));
+    }
+}
+
+static void testSceneRaycastAndRefit() {
+    std::mt19937 rng(9);
+    auto positions = randomTriangles(rng, 500, 2.0f);
+    auto mesh = buildMesh(positions);
+
+    // a row of instances along x, every third scaled up, so the ray's direction isn't unit length in local space
+    std::vector<SceneBvh::Instance> instances;
+    std::vector<mat4f> transforms;
+    for(int i = 0; i < 20; i++) {
+        SceneBvh::Instance instance {};
+        instance.asset = i;
+        instance.entity = utils::Entity::import(i + 1);
+        instance.mesh = &mesh;
+        auto transform = mat4f::translation(float3(i * 10.0f, 0.0f, 0.0f)) * (i % 3 == 0 ? mat4f::scaling(2.0f) : mat4f());
+        SceneBvh::setWorldTransform(instance, transform);
+        instances.push_back(instance);
+        transforms.push_back(transform);
+    }
+    SceneBvh scene;
+    scene.build(instances);
+    CHECK(scene.size() == 20);
+
+    auto worldPositions = [&](const mat4f& transform) {
+        std::vector<float3> world;
+        for(const auto& p : positions) {
+            world.push_back((transform * float4(p, 1.0f)).xyz);
+        }
+        return world;
+    };
+
+    std::uniform_real_distribution<float> jitter(-1.0f, 1.0f);
+    int hits = 0;
+    for(int i = 0; i < 200; i++) {
+        int target = i % 20;
+        float3 origin(target * 10.0f + jitter(rng), jitter(rng), -30.0f);
+        float3 direction = normalize(float3(jitter(rng) * 0.02f, jitter(rng) * 0.02f, 1.0f));
+        // the instances are far enough apart that only the target can be hit
+        float expected = bruteForce(worldPositions(transforms[target]), origin, direction);
+
+        SceneBvh::Hit hit;
+        bool found = scene.intersect(Ray(origin, direction), FLT_MAX, hit);
+        CHECK(found == (expected < FLT_MAX));
+        if(found) {
+            hits++;
+            CHECK(hit.instance->asset == target);
+            CHECK_NEAR(hit.mesh.distance, expected, 1e-3);
+        }
+    }
+    CHECK(hits > 20);
+
+    // find a ray that hits instance 5, then move it away and refit
+    float3 direction(0.0f, 0.0f, 1.0f);
+    float3 origin;
+    SceneBvh::Hit hit;
+    bool found = false;
+    for(int i = 0; i < 100 && !found; i++) {
+        origin = float3(50.0f + jitter(rng), jitter(rng), -30.0f);
+        found = scene.intersect(Ray(origin, direction), FLT_MAX, hit) && hit.instance->asset == 5;
+    }
+    CHECK(found);
+    float3 offset(0.0f, 100.0f, 0.0f);
+    scene.refit([&](utils::Entity entity) {
+        int index = (int)entity.getId() - 1;
+        return index == 5 ? mat4f::translation(offset) * transforms[index] : transforms[index];
+    });
+    CHECK(!scene.intersect(Ray(origin, direction), FLT_MAX, hit));
+    CHECK(scene.intersect(Ray(origin + offset, direction), FLT_MAX, hit));
+    CHECK(hit.instance->asset == 5);
+
+    // a hit beyond maxDistance is ignored
+    CHECK(!scene.intersect(Ray(origin + offset, direction), hit.mesh.distance * 0.5f, hit));
+}
+
+static void testEmpty() {
+    SceneBvh scene;
+    scene.build({});
+    SceneBvh::Hit hit;
+    CHECK(!scene.intersect(Ray(float3(0.0f), float3(0.0f, 0.0f, 1.0f)), FLT_MAX, hit));
+    CHECK(!hit.instance);
+
+    MeshBvh mesh;
+    mesh.build({}, {}, {});
+    CHECK(mesh.empty());
+    MeshBvh::Hit meshHit {};
+    meshHit.distance = FLT_MAX;
+    CHECK(!mesh.intersect(Ray(float3(0.0f), float3(0.0f, 0.0f, 1.0f)), meshHit));
+}
+
+int main() {
+    testBuildInvariants();
+    testMeshRaycast();
+    testSceneRaycastAndRefit();
+    testEmpty();
+    return 0;
+}
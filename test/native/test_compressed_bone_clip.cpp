@@ -0,0 +1,212 @@
+#include "CompressedBoneClip.hpp"
+
+#include "Check.hpp"
+
+#include <math/vec4.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace polyvox;
+using namespace filament::math;
+
+static constexpr int kFrames = 90;
+static constexpr int kBones = 12;
+
+// the quantization step alone: 15 bits per rotation component, 16 bits per translation component over a track's range
+static constexpr float kRotationQuantization = 1e-3f;
+static constexpr float kTranslationQuantization = 1e-3f;
+
+// in double, via the chord length (acos of the dot product can't resolve angles this small)
+static float angleBetween(const quatf& a, const quatf& b) {
+    auto x = normalize(double4(a.x, a.y, a.z, a.w));
+    auto y = normalize(double4(b.x, b.y, b.z, b.w));
+    auto d = dot(x, y) < 0.0 ? x + y : x - y;
+    return (float)(4.0 * std::asin(std::min(length(d) * 0.5, 1.0)));
+}
+
+static void setBone(std::vector<float>& frameData, int frame, int bone, const float3& translation, const quatf& rotation) {
+    float* out = &frameData[((size_t)frame * kBones + bone) * 7];
+    out[0] = translation.x;
+    out[1] = translation.y;
+    out[2] = translation.z;
+    out[3] = rotation.w;
+    out[4] = rotation.x;
+    out[5] = rotation.y;
+    out[6] = rotation.z;
+}
+
+static float3 translationAt(const std::vector<float>& frameData, int frame, int bone) {
+    const float* in = &frameData[((size_t)frame * kBones + bone) * 7];
+    return float3 { in[0], in[1], in[2] };
+}
+
+static quatf rotationAt(const std::vector<float>& frameData, int frame, int bone) {
+    const float* in = &frameData[((size_t)frame * kBones + bone) * 7];
+    return quatf { in[3], in[4], in[5], in[6] };
+}
+
+// smooth motion on every bone, a different speed and axis each, with some bones also flipping the sign of their quaternion
+// between frames (the same rotation, which compression mustn't treat as a jump)
+static std::vector<float> movingClip() {
+    std::vector<float> frameData(kFrames * kBones * 7);
+    for(int frame = 0; frame < kFrames; frame++) {
+        for(int bone = 0; bone < kBones; bone++) {
+            float phase = frame * (0.05f + bone * 0.01f);
+            auto axis = normalize(float3(1.0f, bone * 0.3f, 0.5f - bone * 0.1f));
+            auto rotation = quatf::fromAxisAngle(axis, std::sin(phase) * 1.5f);
+            if(bone % 4 == 3 && frame % 2 == 1) {
+                rotation = -rotation;
+            }
+            auto translation = float3(std::sin(phase) * 2.0f, std::cos(phase * 0.5f) * 0.5f, bone * 0.25f);
+            setBone(frameData, frame, bone, translation, rotation);
+        }
+    }
+    return frameData;
+}
+
+// the largest error of any bone on any frame, decompressed, against the source
+static void measure(const CompressedBoneClip& clip, const std::vector<float>& frameData, float& rotationError, float& translationError) {
+    rotationError = 0.0f;
+    translationError = 0.0f;
+    std::vector<float3> translations(kBones);
+    std::vector<quatf> rotations(kBones);
+    for(int frame = 0; frame < kFrames; frame++) {
+        clip.sample(frame, frame, 0.0f, translations.data(), rotations.data());
+        for(int bone = 0; bone < kBones; bone++) {
+            CHECK_NEAR(length(rotations[bone]), 1.0f, 1e-4);
+            rotationError = std::max(rotationError, angleBetween(rotations[bone], rotationAt(frameData, frame, bone)));
+            translationError = std::max(translationError, length(translations[bone] - translationAt(frameData, frame, bone)));
+        }
+    }
+}
+
+// with no tolerance every frame is kept, so the only error is quantization
+static void testLosslessRoundTrip() {
+    auto frameData = movingClip();
+    CompressedBoneClip clip;
+    clip.compress(frameData.data(), kFrames, kBones, 0.0f, 0.0f);
+    CHECK(clip.getNumFrames() == kFrames);
+    CHECK(clip.getNumBones() == kBones);
+
+    float rotationError, translationError;
+    measure(clip, frameData, rotationError, translationError);
+    CHECK(rotationError <= kRotationQuantization);
+    CHECK(translationError <= kTranslationQuantization);
+    // the reported stats are measured the same way, but in float
+    CHECK_NEAR(clip.getStats().maxRotationError, rotationError, 1e-5);
+    CHECK_NEAR(clip.getStats().maxTranslationError, translationError, 1e-6);
+    CHECK(clip.getStats().uncompressedBytes == (size_t)kFrames * kBones * 7 * sizeof(float));
+    CHECK(clip.getStats().compressedBytes < clip.getStats().uncompressedBytes);
+}
+
+// with a tolerance keys are dropped, the reported maximum error bounds the actual error, and the actual error stays within the
+// tolerance plus the quantization step
+static void testTolerancesBoundError() {
+    auto frameData = movingClip();
+    CompressedBoneClip lossless;
+    lossless.compress(frameData.data(), kFrames, kBones, 0.0f, 0.0f);
+
+    for(float tolerance : { 0.002f, 0.01f, 0.05f }) {
+        CompressedBoneClip clip;
+        clip.compress(frameData.data(), kFrames, kBones, tolerance, tolerance);
+        float rotationError, translationError;
+        measure(clip, frameData, rotationError, translationError);
+        CHECK(rotationError <= clip.getStats().maxRotationError + 1e-5f);
+        CHECK(translationError <= clip.getStats().maxTranslationError + 1e-6f);
+        CHECK(clip.getStats().maxRotationError <= tolerance + kRotationQuantization);
+        CHECK(clip.getStats().maxTranslationError <= tolerance + kTranslationQuantization);
+        CHECK(clip.getStats().compressedBytes < lossless.getStats().compressedBytes);
+    }
+}
+
+// tracks that don't move are stored as a single key each, whatever the number of frames, and a constant translation is exact
+static void testConstantTracks() {
+    std::vector<float> frameData(kFrames * kBones * 7);
+    for(int frame = 0; frame < kFrames; frame++) {
+        for(int bone = 0; bone < kBones; bone++) {
+            setBone(frameData, frame, bone, float3(bone * 1.5f, -2.0f, 0.125f), quatf::fromAxisAngle(float3(0.0f, 1.0f, 0.0f), bone * 0.2f));
+        }
+    }
+    CompressedBoneClip clip;
+    clip.compress(frameData.data(), kFrames, kBones, 0.0f, 0.0f);
+    CHECK(clip.getStats().compressedBytes * 20 < clip.getStats().uncompressedBytes);
+
+    CompressedBoneClip single;
+    single.compress(frameData.data(), 2, kBones, 0.0f, 0.0f);
+    CHECK(clip.getStats().compressedBytes == single.getStats().compressedBytes);
+
+    std::vector<float3> translations(kBones);
+    std::vector<quatf> rotations(kBones);
+    clip.sample(kFrames / 2, kFrames / 2 + 1, 0.3f, translations.data(), rotations.data());
+    for(int bone = 0; bone < kBones; bone++) {
+        CHECK(translations[bone] == translationAt(frameData, 0, bone));
+        CHECK(angleBetween(rotations[bone], rotationAt(frameData, 0, bone)) <= kRotationQuantization);
+    }
+}
+
+static void testRotationsOnly() {
+    auto frameData = movingClip();
+    CompressedBoneClip full, rotationsOnly;
+    full.compress(frameData.data(), kFrames, kBones, 0.0f, 0.0f);
+    rotationsOnly.compressRotations(frameData.data(), kFrames, kBones, 0.0f);
+    CHECK(rotationsOnly.getStats().compressedBytes < full.getStats().compressedBytes);
+    CHECK(rotationsOnly.getStats().maxTranslationError == 0.0f);
+
+    std::vector<float3> translations(kBones, float3(1.0f));
+    std::vector<quatf> rotations(kBones);
+    rotationsOnly.sample(10, 11, 0.5f, translations.data(), rotations.data());
+    for(int bone = 0; bone < kBones; bone++) {
+        CHECK(translations[bone] == float3(0.0f));
+    }
+    // translations may be null when only rotations are wanted
+    std::vector<quatf> withoutTranslations(kBones);
+    full.sample(10, 11, 0.5f, nullptr, withoutTranslations.data());
+    for(int bone = 0; bone < kBones; bone++) {
+        CHECK(angleBetween(withoutTranslations[bone], rotations[bone]) <= 1e-5f);
+    }
+}
+
+// sampling between frames interpolates, taking the short way round when the two frames' quaternions are in opposite hemispheres
+static void testInterpolation() {
+    std::vector<float> frameData(kFrames * kBones * 7);
+    auto axis = float3(0.0f, 0.0f, 1.0f);
+    for(int frame = 0; frame < kFrames; frame++) {
+        for(int bone = 0; bone < kBones; bone++) {
+            auto rotation = quatf::fromAxisAngle(axis, frame * 0.1f);
+            setBone(frameData, frame, bone, float3(frame * 1.0f, 0.0f, -frame * 0.5f), frame % 2 ? -rotation : rotation);
+        }
+    }
+    CompressedBoneClip clip;
+    clip.compress(frameData.data(), kFrames, kBones, 0.0f, 0.0f);
+
+    std::vector<float3> translations(kBones);
+    std::vector<quatf> rotations(kBones);
+    for(float t : { 0.0f, 0.25f, 0.5f, 1.0f }) {
+        clip.sample(20, 21, t, translations.data(), rotations.data());
+        for(int bone = 0; bone < kBones; bone++) {
+            CHECK_NEAR(translations[bone].x, 20.0f + t, 0.01);
+            CHECK_NEAR(translations[bone].z, -10.0f - t * 0.5f, 0.01);
+            CHECK(angleBetween(rotations[bone], quatf::fromAxisAngle(axis, 2.0f + t * 0.1f)) <= 2e-3f);
+        }
+    }
+}
+
+static void testEmpty() {
+    CompressedBoneClip clip;
+    clip.compress(nullptr, 0, 0, 0.0f, 0.0f);
+    CHECK(clip.getNumFrames() == 0);
+    CHECK(clip.getStats().compressedBytes == 0);
+    clip.sample(0, 0, 0.0f, nullptr, nullptr);
+}
+
+int main() {
+    testLosslessRoundTrip();
+    testTolerancesBoundError();
+    testConstantTracks();
+    testRotationsOnly();
+    testInterpolation();
+    testEmpty();
+    return 0;
+}
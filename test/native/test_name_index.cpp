@@ -0,0 +1,72 @@
+#include "NameIndex.hpp"
+
+#include "Check.hpp"
+
+#include <cstring>
+
+using namespace polyvox;
+
+static void testNameTable() {
+    NameTable names;
+    CHECK(names.find("Head") == 0);
+    CHECK(names.find(nullptr) == 0);
+    auto head = names.intern("Head");
+    auto arm = names.intern("Arm");
+    CHECK(head != 0 && arm != 0 && head != arm);
+    CHECK(names.intern("Head") == head);
+    CHECK(names.find("Head") == head);
+    CHECK(names.find("head") == 0);
+    CHECK(std::strcmp(names.getName(arm), "Arm") == 0);
+    CHECK(!names.getName(0));
+    CHECK(!names.getName(arm + 1));
+}
+
+static void testEntitiesAndJoints() {
+    NameTable names;
+    NameIndex index;
+    auto body = names.intern("Body");
+    auto hand = names.intern("Hand");
+    auto first = utils::Entity::import(11);
+    auto second = utils::Entity::import(12);
+    index.addEntity(body, first);
+    // a duplicate name doesn't replace the first entity with that name
+    index.addEntity(body, second);
+    CHECK(index.findEntity(body) == first);
+    CHECK(index.findEntity(hand).isNull());
+    // 0 is what NameTable::find returns for a name no asset has ever used
+    CHECK(index.findEntity(0).isNull());
+
+    index.addJoint(hand, 3);
+    index.addJoint(hand, 5);
+    CHECK(index.findJoint(hand) == 3);
+    CHECK(index.findJoint(body) == -1);
+    CHECK(index.findJoint(0) == -1);
+}
+
+// morph targets are keyed by both the entity's and the target's name, so the same target name on two meshes (or the two
+// IDs swapped) never collide
+static void testMorphTargets() {
+    NameTable names;
+    NameIndex index;
+    auto face = names.intern("Face");
+    auto teeth = names.intern("Teeth");
+    auto smile = names.intern("Smile");
+    auto blink = names.intern("Blink");
+    index.addMorphTarget(face, smile, 0);
+    index.addMorphTarget(face, blink, 1);
+    index.addMorphTarget(teeth, smile, 4);
+    index.addMorphTarget(face, smile, 9);
+    CHECK(index.findMorphTarget(face, smile) == 0);
+    CHECK(index.findMorphTarget(face, blink) == 1);
+    CHECK(index.findMorphTarget(teeth, smile) == 4);
+    CHECK(index.findMorphTarget(teeth, blink) == -1);
+    CHECK(index.findMorphTarget(smile, face) == -1);
+    CHECK(index.findMorphTarget(0, smile) == -1);
+}
+
+int main() {
+    testNameTable();
+    testEntitiesAndJoints();
+    testMorphTargets();
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include "ParallelFor.hpp"
+
+#include "Check.hpp"
+
+#include <atomic>
+#include <vector>
+
+using namespace polyvox;
+
+// every index is visited exactly once, whatever the pool size, grain and count
+static void testEveryIndexOnce() {
+    flutter_filament::ThreadPool pool(3);
+    for(int workers : { 0, 1, 3 }) {
+        for(size_t grain : { 1, 4, 64 }) {
+            for(size_t count : { 0, 1, 3, 4, 5, 1000 }) {
+                std::vector<std::atomic<int>> visits(count);
+                parallelFor(&pool, workers, count, grain, [&](size_t i) {
+                    visits[i]++;
+                });
+                for(size_t i = 0; i < count; i++) {
+                    CHECK(visits[i] == 1);
+                }
+            }
+        }
+    }
+}
+
+// returns only once every index has been processed (so results can be read straight after)
+static void testWaitsForHelpers() {
+    flutter_filament::ThreadPool pool(2);
+    std::vector<long> results(256, 0);
+    parallelFor(&pool, 2, results.size(), 1, [&](size_t i) {
+        long sum = 0;
+        for(size_t j = 0; j < 10000; j++) {
+            sum += (long)(i + j) % 7;
+        }
+        results[i] = sum + 1;
+    });
+    for(auto result : results) {
+        CHECK(result > 0);
+    }
+}
+
+int main() {
+    testEveryIndexOnce();
+    testWaitsForHelpers();
+    return 0;
+}
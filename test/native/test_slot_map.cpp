@@ -0,0 +1,123 @@
+#include "SlotMap.hpp"
+
+#include "Check.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace polyvox;
+
+static void testInsertAndGet() {
+    SlotMap<std::string> map;
+    auto a = map.insert("a");
+    auto b = map.insert("b");
+    CHECK(map.size() == 2);
+    CHECK(a != b);
+    CHECK(map.contains(a) && map.contains(b));
+    CHECK(*map.get(a) == "a");
+    CHECK(map[b] == "b");
+    const auto& constMap = map;
+    CHECK(*constMap.get(b) == "b");
+    CHECK(!map.get(SlotHandle()));
+}
+
+// removing one element doesn't disturb the handles of any other (even though the last element is moved into the hole)
+static void testRemoveKeepsOtherHandles() {
+    SlotMap<int> map;
+    std::vector<SlotHandle> handles;
+    for(int i = 0; i < 10; i++) {
+        handles.push_back(map.insert(i));
+    }
+    CHECK(map.remove(handles[2]));
+    CHECK(map.remove(handles[9]));
+    CHECK(map.remove(handles[0]));
+    CHECK(map.size() == 7);
+    for(int i = 0; i < 10; i++) {
+        if(i == 0 || i == 2 || i == 9) {
+            CHECK(!map.contains(handles[i]));
+            CHECK(!map.get(handles[i]));
+        } else {
+            CHECK(*map.get(handles[i]) == i);
+        }
+    }
+}
+
+// a freed slot is reused, but handles to its previous occupant are stale
+static void testStaleHandles() {
+    SlotMap<int> map;
+    auto first = map.insert(1);
+    CHECK(map.remove(first));
+    CHECK(!map.remove(first));
+    auto second = map.insert(2);
+    CHECK(second.index == first.index);
+    CHECK(second.generation != first.generation);
+    CHECK(!map.get(first));
+    CHECK(*map.get(second) == 2);
+    CHECK(!map.remove(first));
+    CHECK(map.size() == 1);
+}
+
+static void testClear() {
+    SlotMap<int> map;
+    std::vector<SlotHandle> handles;
+    for(int i = 0; i < 5; i++) {
+        handles.push_back(map.insert(i));
+    }
+    map.clear();
+    CHECK(map.empty());
+    for(auto handle : handles) {
+        CHECK(!map.get(handle));
+    }
+    auto handle = map.insert(7);
+    CHECK(*map.get(handle) == 7);
+    for(auto old : handles) {
+        CHECK(!map.get(old));
+    }
+}
+
+// random churn against a reference map; iteration always visits exactly the live elements
+static void testChurn() {
+    SlotMap<int> map;
+    std::unordered_map<int, SlotHandle> live;
+    std::vector<SlotHandle> dead;
+    std::mt19937 rng(7);
+    int next = 0;
+    for(int step = 0; step < 20000; step++) {
+        if(live.empty() || rng() % 3 != 0) {
+            live.emplace(next, map.insert(next));
+            next++;
+        } else {
+            auto it = std::next(live.begin(), rng() % live.size());
+            CHECK(map.remove(it->second));
+            dead.push_back(it->second);
+            live.erase(it);
+        }
+    }
+    CHECK(map.size() == live.size());
+    for(const auto& [value, handle] : live) {
+        CHECK(map.get(handle) && *map.get(handle) == value);
+    }
+    for(auto handle : dead) {
+        CHECK(!map.get(handle));
+    }
+    std::vector<int> iterated(map.begin(), map.end());
+    std::sort(iterated.begin(), iterated.end());
+    std::vector<int> expected;
+    for(const auto& entry : live) {
+        expected.push_back(entry.first);
+    }
+    std::sort(expected.begin(), expected.end());
+    CHECK(iterated == expected);
+}
+
+int main() {
+    testInsertAndGet();
+    testRemoveKeepsOtherHandles();
+    testStaleHandles();
+    testClear();
+    testChurn();
+    return 0;
+}
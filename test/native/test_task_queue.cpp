@@ -0,0 +1,117 @@
+#include "TaskQueue.hpp"
+
+#include "Check.hpp"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace polyvox;
+
+// tasks run in the order they were pushed, and a full queue rejects (rather than overwrites)
+static void testFifoAndCapacity() {
+    TaskQueue<8> queue;
+    std::vector<int> ran;
+    for(int i = 0; i < 8; i++) {
+        CHECK(queue.tryPush([&ran, i] { ran.push_back(i); }));
+    }
+    CHECK(!queue.tryPush([&ran] { ran.push_back(-1); }));
+    while(queue.tryRun()) {}
+    CHECK(ran.size() == 8);
+    for(int i = 0; i < 8; i++) {
+        CHECK(ran[i] == i);
+    }
+    CHECK(queue.empty());
+    CHECK(!queue.tryRun());
+}
+
+// callables too large for a slot are boxed on the heap, and still run and destroyed exactly once
+static void testLargeCallables() {
+    TaskQueue<4> queue;
+    auto tracker = std::make_shared<int>(0);
+    std::array<float, 64> big {};
+    big[63] = 2.0f;
+    float sum = 0.0f;
+    CHECK(queue.tryPush([tracker, big, &sum] { sum += big[63]; }));
+    CHECK(tracker.use_count() == 2);
+    CHECK(queue.tryRun());
+    CHECK(sum == 2.0f);
+    CHECK(tracker.use_count() == 1);
+}
+
+// anything left in the queue is destroyed without being run
+static void testDestroyUnrun() {
+    auto tracker = std::make_shared<int>(0);
+    bool ran = false;
+    {
+        TaskQueue<4> queue;
+        CHECK(queue.tryPush([tracker, &ran] { ran = true; }));
+        CHECK(tracker.use_count() == 2);
+    }
+    CHECK(!ran);
+    CHECK(tracker.use_count() == 1);
+}
+
+// a task can push further tasks while it runs (its slot stays claimed until it returns)
+static void testPushFromTask() {
+    TaskQueue<2> queue;
+    int count = 0;
+    CHECK(queue.tryPush([&] {
+        count++;
+        CHECK(queue.tryPush([&] { count++; }));
+    }));
+    CHECK(queue.tryRun());
+    CHECK(queue.tryRun());
+    CHECK(count == 2);
+}
+
+// every task pushed by several producers runs exactly once, in order per producer
+static void testConcurrentProducers() {
+    constexpr int kProducers = 4;
+    constexpr int kTasksPerProducer = 20000;
+    TaskQueue<64> queue;
+    std::vector<int> next(kProducers, 0);
+    std::atomic<bool> inOrder { true };
+    std::atomic<int> producing { kProducers };
+    std::vector<std::thread> producers;
+    for(int p = 0; p < kProducers; p++) {
+        producers.emplace_back([&, p] {
+            for(int i = 0; i < kTasksPerProducer; i++) {
+                std::string tag = "task";
+                while(!queue.tryPush([&, p, i, tag] {
+                    if(next[p] != i || tag.size() != 4) {
+                        inOrder = false;
+                    }
+                    next[p] = i + 1;
+                })) {
+                    std::this_thread::yield();
+                }
+            }
+            producing--;
+        });
+    }
+    while(producing > 0 || !queue.empty()) {
+        if(!queue.tryRun()) {
+            std::this_thread::yield();
+        }
+    }
+    for(auto& producer : producers) {
+        producer.join();
+    }
+    CHECK(inOrder);
+    for(int p = 0; p < kProducers; p++) {
+        CHECK(next[p] == kTasksPerProducer);
+    }
+}
+
+int main() {
+    testFifoAndCapacity();
+    testLargeCallables();
+    testDestroyUnrun();
+    testPushFromTask();
+    testConcurrentProducers();
+    return 0;
+}